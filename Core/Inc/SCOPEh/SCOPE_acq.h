@@ -0,0 +1,269 @@
+/*
+ * @file    SCOPE_acq.h
+ * @brief   示波器采集引擎头文件
+ * @details ADC1/ADC2 工作在双 ADC 模式，DMA1 通道1 以 32 位字从 ADC1->DR 循环读取
+ *          (低16位为 ADC1，高16位为 ADC2)。半传输和传输完成中断各交出半个缓冲区 (一个数据块)，
+ *          通过数据块回调交给消费者 (如 SCOPE_capture)，CPU 只在数据块边界参与。
+ *          数据块保持打包形式，消费者只在需要某个通道的采样时用 SCOPE_Acq_Sample 拆分。
+ *
+ * 采集模式根据通道使能自动选择:
+ * - 两个通道都打开，或采样率不超过 SCOPE_ACQ_MAX_RATE：同步模式，TIM3 TRGO 触发，
+ *   ADC1 转换 PA0 (CH1)、ADC2 同时转换 PA1 (CH2)，两通道严格对齐
+ * - 只打开一个通道且需要更高采样率：快速交替模式，两个 ADC 交替转换同一通道，
+ *   采样率翻倍为 SCOPE_ACQ_INTERLEAVED_RATE
+ *
+ * 使用说明:
+ * 1. 调用 SCOPE_Acq_Init 初始化外设 (含时间戳定时器)，SCOPE_Acq_Set_Block_Handler 注册数据块回调。
+ * 2. 调用 SCOPE_Acq_Set_Channels、SCOPE_Acq_Set_Sample_Rate 设置通道和采样率后 SCOPE_Acq_Start 开始采集。
+ * 3. 在 stm32f1xx_it.c 的 DMA1_Channel1_IRQHandler 中调用 SCOPE_Acq_DMA_IRQHandler，
+ *    ADC1_2_IRQHandler 中调用 SCOPE_Acq_ADC_IRQHandler (模拟看门狗)。
+ * 4. SCOPE_ACQ_SIM 为 1 时不访问外设，在主循环中调用 SCOPE_Acq_Sim_Pump 生成合成数据块。
+ */
+#ifndef __SCOPE_ACQ_H
+#define __SCOPE_ACQ_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 采集模式 (决定数据字的含义)
+     */
+    typedef enum
+    {
+        SCOPE_ACQ_SIMULTANEOUS = 0, // 同步模式：每字一帧，低16位 CH1，高16位 CH2
+        SCOPE_ACQ_INTERLEAVED_CH1,  // 快速交替模式：每字两个连续的 CH1 采样
+        SCOPE_ACQ_INTERLEAVED_CH2   // 快速交替模式：每字两个连续的 CH2 采样
+    } SCOPE_Acq_Mode;
+
+    /**
+     * @brief  数据块回调函数类型
+     * @param  words 打包的双 ADC 数据字
+     * @param  count 字数
+     * @param  mode  本数据块的采集模式
+     * @note   在 DMA 中断中调用，必须在下一个半缓冲区写满之前返回，且不能阻塞。
+     */
+    typedef void (*SCOPE_Block_Func)(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode);
+
+    /**
+     * @brief  模拟看门狗回调函数类型
+     * @note   在 ADC 中断中调用，调用前看门狗中断已被关闭，
+     *         需要继续监视时由回调 (或之后的数据块回调) 调用 SCOPE_Acq_Watchdog_Arm。
+     */
+    typedef void (*SCOPE_Watchdog_Func)(void);
+
+    /**
+     * @brief  初始化采集外设 (GPIO、ADC1、ADC2、TIM3、DMA1 通道1)
+     * @retval 无
+     * @note   两个 ADC 上电后各执行一次自校准。初始化后处于停止状态，默认为同步模式。
+     */
+    void SCOPE_Acq_Init(void);
+
+    /**
+     * @brief  注册数据块回调
+     * @param  handler 回调函数，NULL 表示丢弃数据
+     * @retval 无
+     */
+    void SCOPE_Acq_Set_Block_Handler(SCOPE_Block_Func handler);
+
+    /**
+     * @brief  设置通道使能，并据此重新选择采集模式
+     * @param  ch1_enabled 通道1是否打开
+     * @param  ch2_enabled 通道2是否打开
+     * @retval 无
+     */
+    void SCOPE_Acq_Set_Channels(uint8_t ch1_enabled, uint8_t ch2_enabled);
+
+    /**
+     * @brief  设置每通道采样率，并据此重新选择采集模式
+     * @param  rate 期望采样率 (Hz)
+     * @retval 实际采样率 (Hz)：同步模式受定时器分频量化并限制在 SCOPE_ACQ_MAX_RATE 以内，
+     *         快速交替模式固定为 SCOPE_ACQ_INTERLEAVED_RATE
+     */
+    float SCOPE_Acq_Set_Sample_Rate(float rate);
+
+    /**
+     * @brief  获取当前实际采样率
+     * @retval 每通道采样率 (Hz)
+     */
+    float SCOPE_Acq_Get_Sample_Rate(void);
+
+    /**
+     * @brief  获取当前采集模式
+     * @retval 采集模式
+     */
+    SCOPE_Acq_Mode SCOPE_Acq_Get_Mode(void);
+
+    /**
+     * @brief  根据时基计算采样率，使一屏恰好采集 SCOPE_RECORD_LEN 个采样
+     * @param  time_base 时基 (ms/div)
+     * @retval 采样率 (Hz)
+     */
+    float SCOPE_Acq_Rate_For_Time_Base(float time_base);
+
+    /**
+     * @brief  开始采集
+     * @retval 无
+     */
+    void SCOPE_Acq_Start(void);
+
+    /**
+     * @brief  停止采集
+     * @retval 无
+     */
+    void SCOPE_Acq_Stop(void);
+
+    /**
+     * @brief  DMA1 通道1 中断处理，交出已写满的半个缓冲区
+     * @retval 无
+     */
+    void SCOPE_Acq_DMA_IRQHandler(void);
+
+    /**
+     * @brief  注册模拟看门狗回调
+     * @param  handler 回调函数，NULL 表示不使用看门狗
+     * @retval 无
+     */
+    void SCOPE_Acq_Set_Watchdog_Handler(SCOPE_Watchdog_Func handler);
+
+    /**
+     * @brief  设置模拟看门狗的监视通道和窗口
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @param  low     窗口下限 (码值)，采样低于此值时触发
+     * @param  high    窗口上限 (码值)，采样高于此值时触发
+     * @retval 无
+     * @note   两个 ADC 都按该通道号设置单通道看门狗：同步模式下只有转换该通道的 ADC 会触发，
+     *         快速交替模式下两个 ADC 交替转换该通道，都参与监视。
+     */
+    void SCOPE_Acq_Watchdog_Config(uint8_t channel, uint16_t low, uint16_t high);
+
+    /**
+     * @brief  清除看门狗标志并打开看门狗中断
+     * @retval 无
+     */
+    void SCOPE_Acq_Watchdog_Arm(void);
+
+    /**
+     * @brief  关闭看门狗中断
+     * @retval 无
+     */
+    void SCOPE_Acq_Watchdog_Disarm(void);
+
+    /**
+     * @brief  ADC1/ADC2 全局中断处理 (模拟看门狗)
+     * @retval 无
+     */
+    void SCOPE_Acq_ADC_IRQHandler(void);
+
+    /**
+     * @brief  读取 32 位微秒时间戳 (TIM2/TIM4 级联的自由计数器)
+     * @retval 时间戳 (us)，约 71 分钟回绕一次，时间差用无符号减法计算
+     * @note   可在中断中调用
+     */
+    uint32_t SCOPE_Acq_Timestamp(void);
+
+#if SCOPE_ACQ_SIM
+    /**
+     * @brief  按经过的时间生成合成数据块并交给数据块回调
+     * @param  now_ms 当前时刻 (ms)
+     * @retval 无
+     * @note   按当前采集模式打包数据，并按已配置的窗口模拟看门狗中断。
+     *         每次调用最多生成 4 个记录长度的数据，主循环停顿较久时丢弃多余的时间。
+     */
+    void SCOPE_Acq_Sim_Pump(uint32_t now_ms);
+
+    /**
+     * @brief  设置合成信号的频率
+     * @param  channel 通道 (0: CH1 正弦波，1: CH2 方波)
+     * @param  hz      频率 (Hz)，默认为 SCOPE_ACQ_SIM_CH1_HZ / SCOPE_ACQ_SIM_CH2_HZ
+     * @retval 无
+     * @note   频率不是采样率的整分数时每次触发的采样相位不同，可用来验证等效时间采样
+     */
+    void SCOPE_Acq_Sim_Set_Frequency(uint8_t channel, float hz);
+
+    /**
+     * @brief  获取合成信号的频率
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @retval 频率 (Hz)
+     * @note   频率计 (SCOPE_counter) 在合成信号下以 CH1 的频率作为输入
+     */
+    float SCOPE_Acq_Sim_Get_Frequency(uint8_t channel);
+#endif
+
+    /**
+     * @brief  每个数据字包含的单通道采样数
+     * @param  mode 采集模式
+     * @retval 同步模式为 1，快速交替模式为 2
+     */
+    static inline uint8_t SCOPE_Acq_Samples_Per_Word(SCOPE_Acq_Mode mode)
+    {
+        return (mode == SCOPE_ACQ_SIMULTANEOUS) ? 1 : 2;
+    }
+
+    /**
+     * @brief  查询某模式下的数据是否包含指定通道
+     * @param  mode    采集模式
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @retval 1: 包含，0: 不包含
+     */
+    static inline uint8_t SCOPE_Acq_Has_Channel(SCOPE_Acq_Mode mode, uint8_t channel)
+    {
+        return mode == SCOPE_ACQ_SIMULTANEOUS || (uint8_t)(mode - SCOPE_ACQ_INTERLEAVED_CH1) == channel;
+    }
+
+    /**
+     * @brief  从打包数据中取出指定通道的第 index 个采样 (按需拆分)
+     * @param  words   打包的数据字
+     * @param  mode    采集模式
+     * @param  channel 通道 (0: CH1，1: CH2)，快速交替模式下忽略
+     * @param  index   采样序号 (快速交替模式下为字序号的 2 倍范围)
+     * @retval 12 位码值
+     * @note   快速交替模式中 ADC2 先启动，ADC1 晚 7 个周期，因此高16位是较早的采样。
+     */
+    static inline uint16_t SCOPE_Acq_Sample(const uint32_t *words, SCOPE_Acq_Mode mode, uint8_t channel, uint16_t index)
+    {
+        if (mode == SCOPE_ACQ_SIMULTANEOUS)
+            return channel ? (uint16_t)(words[index] >> 16) : (uint16_t)(words[index] & 0x0FFF);
+        uint32_t w = words[index >> 1];
+        return (index & 1) ? (uint16_t)(w & 0x0FFF) : (uint16_t)(w >> 16);
+    }
+
+/**
+ * @brief 每伏特对应的码值
+ */
+#define SCOPE_CODES_PER_VOLT (SCOPE_ADC_FULL_SCALE / (SCOPE_ADC_VREF * SCOPE_FRONTEND_ATTEN))
+
+    /**
+     * @brief  码值转换为输入电压
+     * @param  code 12 位码值
+     * @retval 电压 (V)
+     */
+    static inline float SCOPE_Code_To_Volts(uint16_t code)
+    {
+        return ((int32_t)code - SCOPE_ADC_ZERO_CODE) / SCOPE_CODES_PER_VOLT;
+    }
+
+    /**
+     * @brief  输入电压转换为码值 (限制在 0 ~ 4095)
+     * @param  volts 电压 (V)
+     * @retval 12 位码值
+     */
+    static inline uint16_t SCOPE_Volts_To_Code(float volts)
+    {
+        float code = SCOPE_ADC_ZERO_CODE + volts * SCOPE_CODES_PER_VOLT;
+        if (code < 0)
+            return 0;
+        if (code > SCOPE_ADC_FULL_SCALE - 1)
+            return SCOPE_ADC_FULL_SCALE - 1;
+        return (uint16_t)(code + 0.5f);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
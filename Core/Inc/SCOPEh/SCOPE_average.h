@@ -0,0 +1,101 @@
+/*
+ * @file    SCOPE_average.h
+ * @brief   示波器多次采集平均头文件
+ * @details 每取得一个满足触发条件的窗口，就把它逐列累加到整数累加器中，不保存各次的记录，
+ *          重复信号上的随机噪声按 1/√n 减小。累加在码值域进行 (按触发越过点插值，Q12)，
+ *          平均期间修改电压刻度不影响已累积的结果。
+ *          - 线性 (LIN)：累加 n 次后得到完整平均，之后重新开始下一批，批内不更新显示
+ *            (复位后的第一批逐次显示，便于观察收敛)
+ *          - 指数 (EXP)：无限平均，前 n 次按 1/k 加权 (与线性平均相同)，之后固定按 1/n 加权，
+ *            信号变化时逐渐跟随
+ *
+ * 使用说明:
+ * 1. 采集方式为平均时，采集模块按普通方式抽取，主循环在窗口冻结后调用 SCOPE_Average_Add，
+ *    返回 1 时用 SCOPE_Average_To_Screen 代替 SCOPE_Capture_To_Screen 转换波形。
+ * 2. 修改时基、通道或平均参数后调用 SCOPE_Average_Reset 丢弃旧结果。
+ * 3. 累加器在采样存储的工作区 (SCOPE_SMEM_AVERAGE)，其它采集方式取得工作区后结果失效，
+ *    下一次 SCOPE_Average_Add 重新取得并从头开始。
+ */
+#ifndef __SCOPE_AVERAGE_H
+#define __SCOPE_AVERAGE_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 平均方式
+     */
+    typedef enum
+    {
+        SCOPE_AVERAGE_LINEAR = 0, // 线性：每 n 次采集得到一个完整平均
+        SCOPE_AVERAGE_EXPONENTIAL // 指数：无限平均，权重 1/n
+    } SCOPE_Average_Mode;
+
+    /**
+     * @brief  设置平均次数，并丢弃已累积的结果
+     * @param  count 平均次数 (SCOPE_AVERAGE_MIN_COUNT ~ SCOPE_AVERAGE_MAX_COUNT，超出时限制)
+     * @retval 无
+     */
+    void SCOPE_Average_Set_Count(uint16_t count);
+
+    /**
+     * @brief  获取平均次数
+     * @retval 平均次数
+     */
+    uint16_t SCOPE_Average_Get_Count(void);
+
+    /**
+     * @brief  设置平均方式，并丢弃已累积的结果
+     * @param  mode 平均方式
+     * @retval 无
+     */
+    void SCOPE_Average_Set_Mode(SCOPE_Average_Mode mode);
+
+    /**
+     * @brief  获取平均方式
+     * @retval 平均方式
+     */
+    SCOPE_Average_Mode SCOPE_Average_Get_Mode(void);
+
+    /**
+     * @brief  丢弃已累积的结果
+     * @retval 无
+     */
+    void SCOPE_Average_Reset(void);
+
+    /**
+     * @brief  把冻结的采集窗口累加到平均结果
+     * @retval 1: 平均结果已更新，需要重新转换显示；0: 线性平均的一批尚未完成
+     * @note   须在 SCOPE_Capture_Ready 之后、SCOPE_Capture_Rearm 之前调用。
+     *         窗口的采集模式与已累积的不同时 (例如切换为快速交替模式) 自动重新开始。
+     *         峰值检测的包络窗口 (切换采集方式之前冻结的) 不累加，返回 0。
+     */
+    uint8_t SCOPE_Average_Add(void);
+
+    /**
+     * @brief  获取当前结果包含的采集次数
+     * @retval 采集次数 (0 表示还没有结果)，指数平均达到平均次数后保持为平均次数
+     */
+    uint16_t SCOPE_Average_Get_Done(void);
+
+    /**
+     * @brief  把一个通道的平均结果转换为屏幕Y坐标
+     * @param  channel       通道 (0: CH1，1: CH2)
+     * @param  wave_y        输出：每列的屏幕Y坐标
+     * @param  points        点数 (不超过 SCOPE_RECORD_LEN)
+     * @param  volts_per_div 电压刻度 (V/div)
+     * @retval 无
+     * @note   还没有结果或结果中不含该通道时不修改输出
+     */
+    void SCOPE_Average_To_Screen(uint8_t channel, uint16_t *wave_y, uint16_t points, float volts_per_div);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
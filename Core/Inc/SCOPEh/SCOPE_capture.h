@@ -0,0 +1,362 @@
+/*
+ * @file    SCOPE_capture.h
+ * @brief   示波器触发采集记录头文件
+ * @details 作为采集引擎的数据块回调，把 DMA 数据块原样 (打包的双 ADC 数据字) 写入环形缓冲区，
+ *          同时在触发源通道上寻找触发边沿。找到触发后再采集设定数量的触发后采样，
+ *          然后冻结窗口，使触发点位于设定的水平位置 (预触发采样数)。
+ *          读取时才按采集模式拆分出各通道的采样。
+ *          SCOPE_TRIG_USE_AWD 为 1 时由 ADC 模拟看门狗粗检触发边沿，
+ *          只在看门狗报告越过电平后才逐点查找，其余数据块只复制。
+ *          峰值检测方式下由 SCOPE_Capture_Envelope_Block 接收包络 (每列最小值/最大值)，
+ *          触发和 SCOPE_Capture_Sample 使用两者的中点。
+ *          高分辨率方式的平均值带 4 位小数，用 SCOPE_Capture_Sample_Q4 读取时保留。
+ *
+ * 状态转换:
+ *   PRE (预触发装填) -> ARMED (等待触发) -> POST (触发后装填) -> READY (冻结)
+ *   前三个状态只由中断推进，READY -> PRE 只由主循环调用 SCOPE_Capture_Rearm 完成，
+ *   双方只通过一个 volatile 状态变量交接，无需关中断。
+ *
+ * 扫描方式 (决定 ARMED 状态下没有触发时的行为，均在数据块回调中执行):
+ *   AUTO   等待超过 SCOPE_TRIG_AUTO_TIMEOUT_MS 仍未触发时强制触发
+ *   NORMAL 一直等待触发
+ *   SINGLE 与 NORMAL 相同，由主循环在取走窗口后停止采集，不再调用 SCOPE_Capture_Rearm
+ */
+#ifndef __SCOPE_CAPTURE_H
+#define __SCOPE_CAPTURE_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 采集状态
+     */
+    typedef enum
+    {
+        SCOPE_CAPTURE_PRE = 0, // 装填预触发采样，此时不接受触发
+        SCOPE_CAPTURE_ARMED,   // 预触发已满，等待触发
+        SCOPE_CAPTURE_POST,    // 已触发，装填触发后采样
+        SCOPE_CAPTURE_READY    // 窗口冻结，归主循环所有
+    } SCOPE_Capture_State;
+
+    /**
+     * @brief 触发边沿
+     */
+    typedef enum
+    {
+        SCOPE_SLOPE_RISING = 0, // 上升沿
+        SCOPE_SLOPE_FALLING     // 下降沿
+    } SCOPE_Slope;
+
+    /**
+     * @brief 扫描方式
+     */
+    typedef enum
+    {
+        SCOPE_SWEEP_AUTO = 0, // 自动：超时后强制触发
+        SCOPE_SWEEP_NORMAL,   // 正常：只在触发时更新
+        SCOPE_SWEEP_SINGLE    // 单次：触发一次后停止
+    } SCOPE_Sweep;
+
+    /**
+     * @brief 面向用户的触发状态
+     */
+    typedef enum
+    {
+        SCOPE_STATUS_WAIT = 0, // 装填预触发采样 (WAIT)
+        SCOPE_STATUS_ARMED,    // 等待触发 (ARMED)
+        SCOPE_STATUS_TRIGD,    // 已触发 (TRIG'D)
+        SCOPE_STATUS_AUTO      // 自动扫描超时后强制触发 (AUTO)
+    } SCOPE_Capture_Status;
+
+    /**
+     * @brief 保存的窗口的描述 (配合 SCOPE_Capture_Save / SCOPE_Capture_Load)
+     */
+    typedef struct
+    {
+        SCOPE_Acq_Mode mode; // 保存数据的格式 (单通道保存为快速交替模式的格式)
+        uint16_t pre;        // 触发点之前的采样数
+        uint16_t frac;       // 越过点的小数位置 (Q8)
+        uint8_t triggered;   // 1: 满足触发条件，0: 强制触发
+    } SCOPE_Capture_Info;
+
+    /**
+     * @brief  窗口冻结回调函数类型
+     * @retval 1: 窗口已取走，立即在中断中继续等待下一次触发；0: 保持冻结
+     * @note   在数据块回调 (DMA 中断) 中调用，此时可用 SCOPE_Capture_Save_Later 安排保存窗口
+     */
+    typedef uint8_t (*SCOPE_Capture_Window_Func)(void);
+
+    /**
+     * @brief  窗口保存完成回调函数类型 (配合 SCOPE_Capture_Save_Later)
+     */
+    typedef void (*SCOPE_Capture_Saved_Func)(void);
+
+/**
+ * @brief 环形缓冲区字数：一个窗口加一个 DMA 缓冲区 (两个数据块)，
+ *        使看门狗报告的越过点晚一个数据块查找时窗口起点仍未被覆盖
+ */
+#define SCOPE_CAPTURE_RING_WORDS (SCOPE_RECORD_LEN + SCOPE_ACQ_DMA_WORDS)
+
+/**
+ * @brief 等待触发期间采样序号达到此值时减去容量的整数倍，避免 32 位序号溢出
+ */
+#ifndef SCOPE_CAPTURE_REBASE
+#define SCOPE_CAPTURE_REBASE 0x80000000u
+#endif
+
+    /**
+     * @brief 环形缓冲区 (打包的双 ADC 数据字)
+     * @note  同步模式下每字一个采样，快速交替模式下每字两个采样。
+     *        请通过 SCOPE_Capture_Sample 访问冻结的窗口。
+     */
+    extern uint32_t scope_record[SCOPE_CAPTURE_RING_WORDS];
+
+    /**
+     * @brief  数据块回调，注册到 SCOPE_Acq_Set_Block_Handler
+     * @param  words 打包的数据字
+     * @param  count 字数
+     * @param  mode  采集模式
+     * @retval 无
+     * @note   在中断中调用。窗口冻结期间的数据块被丢弃，采集模式改变时重新开始装填。
+     */
+    void SCOPE_Capture_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode);
+
+    /**
+     * @brief  包络数据块回调，注册到 SCOPE_Decim_Set_Output
+     * @param  min_words 每列各通道的最小值 (同步模式打包)
+     * @param  max_words 每列各通道的最大值
+     * @param  count     列数
+     * @retval 无
+     * @note   在中断中调用。在普通数据块与包络数据块之间切换时重新开始装填。
+     */
+    void SCOPE_Capture_Envelope_Block(const uint32_t *min_words, const uint32_t *max_words, uint16_t count);
+
+#if SCOPE_TRIG_USE_AWD
+    /**
+     * @brief  模拟看门狗回调，注册到 SCOPE_Acq_Set_Watchdog_Handler
+     * @retval 无
+     * @note   在 ADC 中断中调用，只推进看门狗阶段，越过点由下一次数据块回调精确查找
+     */
+    void SCOPE_Capture_Watchdog(void);
+
+    /**
+     * @brief  设置是否用模拟看门狗粗检触发边沿
+     * @param  enable 1: 使用 (默认)，0: 每个数据块逐点查找
+     * @retval 无
+     * @note   数据在采集引擎之后被改变 (如数字耦合、带宽限制) 时，看门狗看到的原始码值与记录不一致，需要关闭
+     */
+    void SCOPE_Capture_Use_Watchdog(uint8_t enable);
+#endif
+
+    /**
+     * @brief  设置边沿触发条件
+     * @param  channel 触发源通道 (0: CH1，1: CH2)
+     * @param  level   触发电平 (12 位码值)
+     * @param  slope   触发边沿
+     * @retval 无
+     * @note   快速交替模式下只采集一个通道，此时在该通道上触发。
+     *         条件改变时看门狗在下一个数据块重新开始监视。
+     */
+    void SCOPE_Capture_Set_Trigger(uint8_t channel, uint16_t level, SCOPE_Slope slope);
+
+    /**
+     * @brief  设置触发迟滞
+     * @param  hysteresis 迟滞 (码值)
+     * @retval 无
+     * @note   上升沿触发前采样必须先低于 电平 - 迟滞，下降沿必须先高于 电平 + 迟滞，
+     *         幅度小于迟滞的噪声不会在电平附近重复触发。为 0 时即普通边沿触发。
+     */
+    void SCOPE_Capture_Set_Hysteresis(uint16_t hysteresis);
+
+    /**
+     * @brief  设置触发点在窗口中的位置
+     * @param  pre_samples 触发点之前的采样数 (0 ~ SCOPE_RECORD_LEN-1)，即触发点所在的列
+     * @retval 无
+     * @note   在下一次触发时生效
+     */
+    void SCOPE_Capture_Set_Pretrigger(uint16_t pre_samples);
+
+    /**
+     * @brief  设置扫描方式
+     * @param  sweep 扫描方式
+     * @retval 无
+     * @note   AUTO 的超时从下一次进入 ARMED 开始计算
+     */
+    void SCOPE_Capture_Set_Sweep(SCOPE_Sweep sweep);
+
+    /**
+     * @brief  获取扫描方式
+     * @retval 扫描方式
+     */
+    SCOPE_Sweep SCOPE_Capture_Get_Sweep(void);
+
+    /**
+     * @brief  获取触发状态
+     * @retval 触发状态：PRE 为 WAIT，ARMED 为 ARMED，
+     *         POST/READY 按窗口是否由触发条件产生分为 TRIG'D 和 AUTO
+     */
+    SCOPE_Capture_Status SCOPE_Capture_Get_Status(void);
+
+    /**
+     * @brief  读取并清除触发事件标志 (对应 SCPI :TER?)
+     * @retval 1: 上次读取以来发生过满足条件的触发，强制触发不计入
+     */
+    uint8_t SCOPE_Capture_Take_Event(void);
+
+    /**
+     * @brief  强制触发：预触发装满后立即把下一个采样当作触发点
+     * @retval 无
+     * @note   自动扫描的超时已在数据块回调中处理，本函数用于手动强制触发
+     */
+    void SCOPE_Capture_Force(void);
+
+    /**
+     * @brief  获取采集状态
+     * @retval 采集状态
+     */
+    SCOPE_Capture_State SCOPE_Capture_Get_State(void);
+
+    /**
+     * @brief  查询窗口是否已冻结
+     * @retval 1: 已冻结，0: 正在采集
+     */
+    uint8_t SCOPE_Capture_Ready(void);
+
+    /**
+     * @brief  释放窗口并重新开始预触发装填
+     * @retval 无
+     */
+    void SCOPE_Capture_Rearm(void);
+
+    /**
+     * @brief  获取冻结窗口的采集模式
+     * @retval 采集模式
+     */
+    SCOPE_Acq_Mode SCOPE_Capture_Get_Mode(void);
+
+    /**
+     * @brief  注册窗口冻结回调
+     * @param  handler 回调函数，NULL 表示窗口冻结后等待主循环取走
+     * @retval 无
+     * @note   回调返回 1 时不经过主循环直接开始下一次：缓冲区内容保留作为下一个窗口的预触发，
+     *         只在上一个窗口结束之后查找触发，两个窗口之间没有重新装填的死区。
+     *         用 SCOPE_Capture_Save_Later 保存窗口时，保存完成之前的数据块不查找触发。
+     */
+    void SCOPE_Capture_Set_Window_Handler(SCOPE_Capture_Window_Func handler);
+
+    /**
+     * @brief  把冻结的窗口打包保存到外部存储
+     * @param  dest     目标 (至少 2 * SCOPE_Smem_Bytes(format, SCOPE_RECORD_LEN) 字节)
+     * @param  channels 需要保存的通道 (bit0: CH1，bit1: CH2)，只对同步模式有效
+     * @param  format   存储格式 (12 位或 8 位)
+     * @param  info     输出：窗口的描述
+     * @retval 写入的字节数
+     * @note   两个通道时依次保存 CH1 和 CH2 的整个窗口，一个通道时只保存该通道；包络保存为中点，高分辨率方式四舍五入为 12 位。
+     */
+    uint16_t SCOPE_Capture_Save(uint8_t *dest, uint8_t channels, SCOPE_Smem_Format format, SCOPE_Capture_Info *info);
+
+    /**
+     * @brief  把保存的窗口解包装回缓冲区，作为冻结的窗口
+     * @param  src    SCOPE_Capture_Save 写入的数据
+     * @param  format 保存时的存储格式
+     * @param  info   窗口的描述
+     * @retval 无
+     * @note   只能在窗口冻结期间调用，之后的读取和转换函数都作用于装回的窗口
+     */
+    void SCOPE_Capture_Load(const uint8_t *src, SCOPE_Smem_Format format, const SCOPE_Capture_Info *info);
+
+    /**
+     * @brief  在窗口冻结回调中安排保存刚冻结的窗口，之后的数据块回调逐块打包
+     * @param  dest     目标，参数含义同 SCOPE_Capture_Save
+     * @param  channels 需要保存的通道
+     * @param  format   存储格式
+     * @param  info     输出：窗口的描述 (立即写入)
+     * @param  done     保存完成后调用 (数据块回调或 SCOPE_Capture_Save_Finish 中)，可为 NULL
+     * @retval 无
+     * @note   中断中只记录窗口的位置。之后每个数据块写入缓冲区之前打包与该块采样数相同的窗口采样，
+     *         缓冲区比窗口多出的一个 DMA 缓冲区保证窗口在被覆盖之前打包完。
+     *         保存期间不查找触发，死区为打包一个窗口所需的数据块。
+     *         回调返回 0 (保持冻结) 时剩余部分由主循环调用 SCOPE_Capture_Save_Finish 完成；
+     *         SCOPE_Capture_Rearm 放弃未完成的保存，不调用 done。
+     */
+    void SCOPE_Capture_Save_Later(uint8_t *dest, uint8_t channels, SCOPE_Smem_Format format, SCOPE_Capture_Info *info,
+                                  SCOPE_Capture_Saved_Func done);
+
+    /**
+     * @brief  在主循环中完成冻结窗口未完成的保存
+     * @retval 无
+     * @note   只在窗口冻结期间有效，其它时候保存由数据块回调完成
+     */
+    void SCOPE_Capture_Save_Finish(void);
+
+    /**
+     * @brief  获取冻结窗口中触发点的位置
+     * @retval 触发点之前的采样数，强制触发时同样有效
+     */
+    uint16_t SCOPE_Capture_Get_Trigger_Index(void);
+
+    /**
+     * @brief  获取冻结窗口中越过点的小数位置
+     * @retval Q8 (1 ~ 256)：越过点位于触发采样之前 (256 - 返回值) / 256 个采样处，
+     *         强制触发时为 256
+     */
+    uint16_t SCOPE_Capture_Get_Trigger_Fraction(void);
+
+    /**
+     * @brief  读取冻结窗口中指定通道的一个采样
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @param  index   窗口内的采样序号 (0 ~ SCOPE_RECORD_LEN-1)
+     * @retval 12 位码值
+     */
+    uint16_t SCOPE_Capture_Sample(uint8_t channel, uint16_t index);
+
+    /**
+     * @brief  读取冻结窗口中指定通道的一个采样，保留高分辨率方式的小数位
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @param  index   窗口内的采样序号 (0 ~ SCOPE_RECORD_LEN-1)
+     * @retval Q4 码值 (12 位码值 x 16)，其它采集方式下低 4 位为 0 (峰值检测的中点可能带半个码值)
+     */
+    uint16_t SCOPE_Capture_Sample_Q4(uint8_t channel, uint16_t index);
+
+    /**
+     * @brief  查询冻结窗口是否为包络 (峰值检测)
+     * @retval 1: 包络，0: 普通采样
+     */
+    uint8_t SCOPE_Capture_Is_Envelope(void);
+
+    /**
+     * @brief  把一个通道的窗口转换为屏幕Y坐标
+     * @param  channel       通道 (0: CH1，1: CH2)
+     * @param  wave_y        输出：每列的屏幕Y坐标
+     * @param  points        点数 (不超过 SCOPE_RECORD_LEN)
+     * @param  volts_per_div 电压刻度 (V/div)
+     * @retval 无
+     * @note   0V 位于屏幕中心，满屏高度为 ±4 格，超出范围的点限制在屏幕边缘。
+     *         按越过点的小数位置对采样插值，使越过点正好落在触发列上，波形不随采样相位抖动。
+     *         窗口中不含该通道 (快速交替模式下的另一通道) 时不修改输出。
+     */
+    void SCOPE_Capture_To_Screen(uint8_t channel, uint16_t *wave_y, uint16_t points, float volts_per_div);
+
+    /**
+     * @brief  把一个通道的包络转换为屏幕Y坐标
+     * @param  channel       通道 (0: CH1，1: CH2)
+     * @param  max_y         输出：每列最大值的屏幕Y坐标
+     * @param  min_y         输出：每列最小值的屏幕Y坐标
+     * @param  points        点数 (不超过 SCOPE_RECORD_LEN)
+     * @param  volts_per_div 电压刻度 (V/div)
+     * @retval 1: 已输出包络，0: 窗口不是包络或不含该通道 (不修改输出)
+     */
+    uint8_t SCOPE_Capture_Envelope_To_Screen(uint8_t channel, uint16_t *max_y, uint16_t *min_y, uint16_t points, float volts_per_div);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * @file    SCOPE_config.h
+ * @brief   示波器应用配置文件
+ *
+ * 本文件集中定义示波器显示区域、网格以及各功能模块的参数。
+ * STM32F103C8T6 只有 20KB SRAM，各模块的缓冲区大小在此统一调整。
+ */
+
+#ifndef __SCOPE_CONFIG_H
+#define __SCOPE_CONFIG_H
+
+/**
+ * @brief SRAM 预算 (字节)
+ *
+ * 链接脚本 STM32F103C8TX_FLASH.ld 的 _Min_Heap_Size / _Min_Stack_Size 与下面的堆、栈一致，
+ * 静态数据 (.data/.bss) 超出其余部分时链接失败：
+ * - 堆：两个屏幕共用的 TFT 发送缓冲区 (TFT_BUFFER_SIZE，TFT_IO_Init 中分配)，另留约 0.5KB 给 C 库
+ *   (浮点格式化的大数运算和 malloc 的块头)
+ * - 栈：中断嵌套加主循环最深的调用
+ * - 静态数据：各模块的缓冲区，大小见下面各项的说明
+ * 增大缓冲区时先从这里核对余量。
+ */
+#define SCOPE_RAM_BYTES (20 * 1024)
+#define SCOPE_RAM_HEAP_BYTES 0xA00  // 堆，与 _Min_Heap_Size 一致
+#define SCOPE_RAM_STACK_BYTES 0x400 // 栈，与 _Min_Stack_Size 一致
+#define SCOPE_RAM_STATIC_BYTES (SCOPE_RAM_BYTES - SCOPE_RAM_HEAP_BYTES - SCOPE_RAM_STACK_BYTES) // 静态数据的上限
+
+/**
+ * @brief 波形显示区域 (TFT1, ST7789 竖屏) 尺寸，单位像素
+ */
+#define SCOPE_PLOT_WIDTH 240  // 显示区域宽度 (时间轴)
+#define SCOPE_PLOT_HEIGHT 320 // 显示区域高度 (电压轴)
+
+/**
+ * @brief 网格大小 (像素/格)，与 main.c 中的 GRID_SIZE 一致
+ */
+#define SCOPE_GRID_SIZE 30
+
+/**
+ * @brief 余辉强度图的抽取系数
+ *
+ * 强度图每个单元为 4 位 (16 级亮度)，覆盖 DECIM_X * DECIM_Y 个像素。
+ * 全分辨率需要 240 * 320 / 2 = 37.5KB，无法放入 SRAM：
+ * - 4 x 4: 60 * 80 单元 = 2400 字节 (默认)
+ * - 2 x 4: 120 * 80 单元 = 4800 字节
+ * - 2 x 2: 120 * 160 单元 = 9600 字节 (需要减小 TFT 发送缓冲区)
+ */
+#define SCOPE_PERSIST_DECIM_X 4
+#define SCOPE_PERSIST_DECIM_Y 4
+
+/**
+ * @brief 每次采集命中一个单元时增加的亮度 (0-15)
+ */
+#define SCOPE_PERSIST_HIT 5
+#define SCOPE_PERSIST_POINT_HIT 2 // XY 散点每个点增加的亮度 (同一单元可多次命中)
+
+/**
+ * @brief 水平格数，时基 (ms/div) 乘以格数即为一屏对应的时间
+ */
+#define SCOPE_DIVS_X (SCOPE_PLOT_WIDTH / SCOPE_GRID_SIZE)
+
+/**
+ * @brief 垂直格数，电压刻度 (V/div) 按满屏高度 ±4 格换算 (与 main.c 中的触发电平映射一致)
+ */
+#define SCOPE_DIVS_Y 8
+
+/**
+ * @brief 采集源选择
+ *
+ * 0: ADC1 采集 PA0 (CH1) / PA1 (CH2)，TIM3 TRGO 触发，DMA1 通道1 循环传输
+ * 1: 合成信号 (CH1 正弦波、CH2 方波)，由 SCOPE_Acq_Sim_Pump 按实际采样率生成数据块，
+ *    经过与 DMA 中断相同的数据块回调，不依赖 STM32 外设，可在主机上编译测试
+ */
+#ifndef SCOPE_ACQ_SIM
+#define SCOPE_ACQ_SIM 0
+#endif
+
+/**
+ * @brief 采集记录长度 (每通道点数)，每个点对应屏幕上的一列
+ */
+#define SCOPE_RECORD_LEN SCOPE_PLOT_WIDTH
+
+/**
+ * @brief DMA 循环缓冲区字数
+ * @note  每个 32 位字为 ADC1 (低16位) 和 ADC2 (高16位) 的一次双 ADC 转换结果，
+ *        半传输和传输完成中断各交出一半，即每个数据块 SCOPE_ACQ_DMA_WORDS / 2 字
+ */
+#define SCOPE_ACQ_DMA_WORDS 128
+
+/**
+ * @brief 双 ADC 模式的采样率上限 (Hz，每通道)
+ * @note  ADC 时钟 72MHz / 6 = 12MHz。
+ *        同步模式：采样 7.5 周期 + 转换 12.5 周期 = 20 周期，CH1/CH2 同时转换，600kHz。
+ *        快速交替模式：采样 1.5 + 12.5 = 14 周期，两个 ADC 错开 7 周期交替转换同一通道，
+ *        连续转换，固定为 12MHz / 7 约 1.71MHz，只在单通道且需要超过同步模式上限时使用。
+ */
+#define SCOPE_ACQ_MAX_RATE 600000.0f
+#define SCOPE_ACQ_INTERLEAVED_RATE (12000000.0f / 7.0f)
+
+/**
+ * @brief 抽取时的 ADC 采样率 (Hz)
+ * @note  慢时基下 ADC 以不超过此值的采样率运行，每列合并多个原始采样 (峰值检测/高分辨率)。
+ *        每个原始采样都要经过数据块回调，此值限制了抽取占用的 CPU 时间。
+ */
+#define SCOPE_DECIM_MAX_RATE 100000.0f
+
+/**
+ * @brief 数字耦合与带宽限制 (SCOPE_filter)
+ * @note  交流耦合为一阶高通，下限频率约为 SCOPE_FILTER_AC_HZ；带宽限制为 SCOPE_FILTER_BWL_STAGES 个
+ *        二阶节级联的巴特沃斯低通。两者都按 ADC 采样率在数据块回调中处理，
+ *        每个二阶节每个采样约 15 个周期，同步模式最高采样率下两个通道都打开带宽限制约占一半 CPU。
+ */
+#define SCOPE_FILTER_AC_HZ 10.0f     // 交流耦合的下限频率 (Hz)
+#define SCOPE_FILTER_BWL_HZ 20000.0f // 带宽限制的截止频率 (Hz)
+#define SCOPE_FILTER_BWL_STAGES 2    // 带宽限制的二阶节数 (阶数的一半)
+
+/**
+ * @brief 多次采集平均的次数范围 (:ACQ:COUN)
+ */
+#define SCOPE_AVERAGE_MIN_COUNT 2
+#define SCOPE_AVERAGE_MAX_COUNT 256
+
+/**
+ * @brief 采样存储的大小 (字节)
+ * @note  记录区由分段存储、长记录和频谱分析分时使用。
+ *        分段存储每通道每段 SCOPE_RECORD_LEN 个采样，12 位打包时 1.5 字节/采样，8 位时 1 字节/采样。
+ *        工作区由各采集方式的中间结果分时使用：峰值检测的包络最小值 (与采集记录的环形缓冲区等长)、
+ *        平均的累加器 (2 x SCOPE_RECORD_LEN x 4 字节，决定工作区的大小)、
+ *        等效时间采样的各列码值、滚动模式的列队列。
+ */
+#define SCOPE_SMEM_BYTES 4096
+#define SCOPE_SMEM_WORK_BYTES (SCOPE_RECORD_LEN * 8) // 工作区
+#define SCOPE_SEGM_MAX (SCOPE_SMEM_BYTES / SCOPE_RECORD_LEN) // 最大分段数 (单通道 8 位)
+
+/**
+ * @brief 长记录 (滚动模式) 的关键帧参数
+ * @note  每 SCOPE_LOG_BLOCK 帧为一块，块首保存原始值，可从任一块开始解码；
+ *        关键帧表最多 SCOPE_LOG_MAX_BLOCKS 块
+ */
+#define SCOPE_LOG_BLOCK 64
+#define SCOPE_LOG_MAX_BLOCKS 128
+
+/**
+ * @brief 频谱分析的最大点数
+ * @note  实数采样 (16 位) 在采样存储区中原地变换，最大点数 * 2 字节不能超过 SCOPE_SMEM_BYTES
+ */
+#define SCOPE_FFT_MAX_SIZE 1024
+#define SCOPE_HARM_MAX_ORDER 10 // 总谐波失真计入的最高谐波次数
+
+/**
+ * @brief 数学通道的最大运算级数
+ */
+#define SCOPE_MATH_MAX_KERNELS 4
+
+/**
+ * @brief 等效时间采样的最大倍数 (等效采样率 / 实际采样率)
+ * @note  快速交替模式下约为 55 MSPS
+ */
+#define SCOPE_ETS_MAX_RATIO 32
+
+/**
+ * @brief 滚动模式列队列长度 (列，2 的幂)
+ * @note  主循环停顿不超过这么多列的时间时不丢失数据，100ms/div 下约 200ms
+ */
+#define SCOPE_ROLL_FIFO_LEN 64
+
+/**
+ * @brief 频率计 (TIM1 输入捕获，PA8)
+ * @note  闸门时间内第一个与最后一个输入边沿之间的 TIM1 计数值 (72MHz) 为分母，
+ *        1s 闸门约 8 位有效数字。输入高于 SCOPE_COUNTER_PSC_HZ 时每 8 个边沿捕获一次，限制 DMA 请求；
+ *        超过闸门时间加 SCOPE_COUNTER_TIMEOUT_MS 仍没有边沿时认为没有信号
+ */
+#define SCOPE_COUNTER_GATE_MS 1000      // 默认闸门时间 (ms)
+#define SCOPE_COUNTER_PSC_HZ 100000.0f  // 捕获分频的切换频率 (Hz)
+#define SCOPE_COUNTER_TIMEOUT_MS 10000  // 无信号判定时间 (ms)，也决定可测量的最低频率
+
+/**
+ * @brief ADC 码值与输入电压的换算
+ *
+ * 假设前端把输入信号衰减 SCOPE_FRONTEND_ATTEN 倍并偏置到 VREF/2，
+ * 即码值 SCOPE_ADC_ZERO_CODE 对应 0V，默认输入范围约 ±6.6V。
+ */
+#define SCOPE_ADC_VREF 3.3f       // ADC 参考电压 (V)
+#define SCOPE_ADC_FULL_SCALE 4096 // 12 位 ADC 满量程码值
+#define SCOPE_ADC_ZERO_CODE 2048  // 输入 0V 对应的码值
+#define SCOPE_FRONTEND_ATTEN 4.0f // 前端衰减倍数
+
+/**
+ * @brief 触发检测方式
+ *
+ * 为 1 时由 ADC 模拟看门狗在硬件中粗检触发边沿，软件只在看门狗报告的数据块中
+ * 精确查找越过点，CPU 占用与采样率无关；为 0 时软件逐个采样查找。
+ */
+#ifndef SCOPE_TRIG_USE_AWD
+#define SCOPE_TRIG_USE_AWD 1
+#endif
+
+#define SCOPE_TRIG_NREJ_DIVS 0.5f // 噪声抑制打开时的最小触发迟滞 (格)
+#define SCOPE_TRIG_AUTO_TIMEOUT_MS 100 // 自动扫描：进入等待触发后超过此时间仍未触发则强制触发
+
+/**
+ * @brief 合成信号参数 (仅 SCOPE_ACQ_SIM 为 1 时使用)
+ */
+#define SCOPE_ACQ_SIM_CH1_HZ 50.0f    // CH1 正弦波频率
+#define SCOPE_ACQ_SIM_CH1_VOLTS 2.0f  // CH1 正弦波幅值 (V)
+#define SCOPE_ACQ_SIM_CH2_HZ 100.0f   // CH2 方波频率
+#define SCOPE_ACQ_SIM_CH2_VOLTS 2.0f  // CH2 方波幅值 (V)
+#define SCOPE_ACQ_SIM_NOISE 4         // 叠加的噪声峰值 (码值)
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * @file    SCOPE_counter.h
+ * @brief   示波器硬件频率计头文件
+ * @details 数字输入 (或外部比较器输出) 接 PA8 (TIM1_CH1)，TIM1 以 72MHz 自由计数，
+ *          每个上升沿由输入捕获锁存计数值，DMA1 通道2 把捕获值写到同一个变量，
+ *          DMA 的剩余次数同时作为边沿计数器，捕获本身不需要 CPU。
+ *          TIM1 溢出中断 (约 1.1kHz) 把计数值扩展到 32 位，并记录最近一个边沿的时刻和累计边沿数。
+ *
+ * 倒数计数：闸门从一个输入边沿开始，到闸门时间之后的第一个输入边沿结束，
+ *   频率 = 边沿数 / 两个边沿之间的时间。分辨率为一个 TIM1 计数 (约 14ns) 相对整个闸门时间，
+ *   与输入频率和示波器时基都无关；低频信号同样有完整的有效数字。
+ *
+ * 使用说明:
+ * 1. SCOPE_Counter_Init 初始化后在后台持续测量，在 stm32f1xx_it.c 的 TIM1_UP_IRQHandler 中
+ *    调用 SCOPE_Counter_TIM_IRQHandler。
+ * 2. 主循环每次调用 SCOPE_Counter_Update，返回 1 时用 SCOPE_Counter_Get_Frequency 读取新结果。
+ * 3. SCOPE_ACQ_SIM 为 1 时不访问外设，以合成信号 CH1 的频率作为输入。
+ */
+#ifndef __SCOPE_COUNTER_H
+#define __SCOPE_COUNTER_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief  初始化频率计 (GPIO PA8、TIM1、DMA1 通道2) 并开始测量
+     * @retval 无
+     */
+    void SCOPE_Counter_Init(void);
+
+    /**
+     * @brief  设置闸门时间
+     * @param  gate_ms 闸门时间 (10 ~ 10000 ms)，越长有效数字越多
+     * @retval 无
+     * @note   当前闸门作废，从下一个边沿重新开始
+     */
+    void SCOPE_Counter_Set_Gate(uint32_t gate_ms);
+
+    /**
+     * @brief  获取闸门时间
+     * @retval 闸门时间 (ms)
+     */
+    uint32_t SCOPE_Counter_Get_Gate(void);
+
+    /**
+     * @brief  推进闸门，在主循环中调用
+     * @param  now_ms 当前时刻 (ms)
+     * @retval 1: 有新的测量结果 (含判定为没有信号)，0: 没有变化
+     */
+    uint8_t SCOPE_Counter_Update(uint32_t now_ms);
+
+    /**
+     * @brief  获取最近一次测量的频率
+     * @retval 频率 (Hz)，0 表示没有信号
+     */
+    double SCOPE_Counter_Get_Frequency(void);
+
+    /**
+     * @brief  TIM1 更新 (溢出) 中断处理
+     * @retval 无
+     */
+    void SCOPE_Counter_TIM_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
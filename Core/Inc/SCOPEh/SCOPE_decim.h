@@ -0,0 +1,137 @@
+/*
+ * @file    SCOPE_decim.h
+ * @brief   示波器抽取 (采集方式) 头文件
+ * @details 慢时基下 ADC 以高于显示所需的采样率运行，每 N 个原始采样合并为一列，
+ *          在 DMA 数据块回调中流式完成，内存中只保留显示分辨率的记录:
+ *          - 普通 (NORMAL)：每 N 个采样取第一个，与直接降低采样率相同
+ *          - 峰值检测 (PEAK)：保留每列的最小值和最大值，窄脉冲不会在抽取中丢失
+ *          - 高分辨率 (HRES)：每列取 N 个采样的平均值 (矩形窗平滑)，降低噪声，
+ *            平均值保留 SCOPE_DECIM_HIRES_BITS 位小数 (每个半字为 Q4 码值)
+ *
+ * 使用说明:
+ * 1. 把 SCOPE_Decim_Block 注册为采集引擎的数据块回调，再用 SCOPE_Decim_Set_Output
+ *    指定输出 (通常为 SCOPE_Capture_Block 和 SCOPE_Capture_Envelope_Block)。
+ * 2. 用 SCOPE_Decim_Set_Rate 代替 SCOPE_Acq_Set_Sample_Rate 设置每列的采样率，
+ *    抽取倍数按 SCOPE_DECIM_MAX_RATE 自动选择。
+ * 3. 抽取倍数为 1 (快时基) 时数据块原样转发，此时峰值检测与普通方式相同。
+ * 4. 输出回调中用 SCOPE_Decim_Get_Frac_Bits 判断本块是否为 Q4 码值，
+ *    SCOPE_Decim_Sample_Q4 统一按 Q4 读取 (SCOPE_Acq_Sample 只取低 12 位，会丢掉整数的高位)。
+ */
+#ifndef __SCOPE_DECIM_H
+#define __SCOPE_DECIM_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 采集方式
+     */
+    typedef enum
+    {
+        SCOPE_DECIM_NORMAL = 0, // 普通：每列取一个采样
+        SCOPE_DECIM_PEAK,       // 峰值检测：每列保留最小值和最大值
+        SCOPE_DECIM_HIRES       // 高分辨率：每列取平均值
+    } SCOPE_Decim_Type;
+
+/**
+ * @brief 高分辨率方式输出的码值小数位数：平均 N 个采样约提高 log2(N)/2 位分辨率，
+ *        4 位小数覆盖 N 到 256，12 位码值左移 4 位后正好占满 16 位半字
+ */
+#define SCOPE_DECIM_HIRES_BITS 4
+
+    /**
+     * @brief  包络数据块回调函数类型 (峰值检测方式的输出)
+     * @param  min_words 每列各通道的最小值 (打包格式同同步模式)
+     * @param  max_words 每列各通道的最大值
+     * @param  count     列数
+     * @note   在 DMA 中断中调用
+     */
+    typedef void (*SCOPE_Envelope_Func)(const uint32_t *min_words, const uint32_t *max_words, uint16_t count);
+
+    /**
+     * @brief  指定抽取结果的输出
+     * @param  block    普通/高分辨率方式及不抽取时的输出
+     * @param  envelope 峰值检测方式的输出
+     * @retval 无
+     */
+    void SCOPE_Decim_Set_Output(SCOPE_Block_Func block, SCOPE_Envelope_Func envelope);
+
+    /**
+     * @brief  设置采集方式
+     * @param  type 采集方式
+     * @retval 无
+     * @note   正在累积的一列被丢弃，之后的输出按新方式计算
+     */
+    void SCOPE_Decim_Set_Type(SCOPE_Decim_Type type);
+
+    /**
+     * @brief  获取采集方式
+     * @retval 采集方式
+     */
+    SCOPE_Decim_Type SCOPE_Decim_Get_Type(void);
+
+    /**
+     * @brief  设置每列的采样率，并选择抽取倍数和 ADC 采样率
+     * @param  rate 每列采样率 (Hz)，通常为 SCOPE_Acq_Rate_For_Time_Base 的结果
+     * @retval 实际每列采样率 (Hz)
+     * @note   ADC 采样率不超过 SCOPE_DECIM_MAX_RATE 时才抽取，限制数据块回调的 CPU 占用。
+     */
+    float SCOPE_Decim_Set_Rate(float rate);
+
+    /**
+     * @brief  获取实际每列采样率
+     * @retval 每列采样率 (Hz)，即 ADC 采样率除以抽取倍数
+     */
+    float SCOPE_Decim_Get_Rate(void);
+
+    /**
+     * @brief  获取抽取倍数
+     * @retval 每列合并的原始采样数 (1 表示不抽取)
+     */
+    uint16_t SCOPE_Decim_Get_Factor(void);
+
+    /**
+     * @brief  数据块回调，注册到 SCOPE_Acq_Set_Block_Handler
+     * @param  words 打包的数据字
+     * @param  count 字数
+     * @param  mode  采集模式
+     * @retval 无
+     * @note   在中断中调用，每个数据块最多输出一次，输出的列数不超过 SCOPE_ACQ_DMA_WORDS / 4。
+     */
+    void SCOPE_Decim_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode);
+
+    /**
+     * @brief  获取正在输出的数据块中码值的小数位数
+     * @retval SCOPE_DECIM_HIRES_BITS: 高分辨率方式的平均值 (同步模式，每个半字为 Q4 码值)；0: 12 位码值
+     * @note   只在输出回调中调用，结果与本块一致
+     */
+    uint8_t SCOPE_Decim_Get_Frac_Bits(void);
+
+    /**
+     * @brief  从输出的数据块中读取一个采样的 Q4 码值
+     * @param  words     打包的数据字
+     * @param  mode      采集模式
+     * @param  channel   通道
+     * @param  index     采样序号
+     * @param  frac_bits 数据块中码值的小数位数 (SCOPE_Decim_Get_Frac_Bits)
+     * @retval Q4 码值 (12 位码值 x 16)
+     */
+    static inline uint16_t SCOPE_Decim_Sample_Q4(const uint32_t *words, SCOPE_Acq_Mode mode, uint8_t channel, uint16_t index,
+                                                 uint8_t frac_bits)
+    {
+        if (frac_bits)
+            return channel ? (uint16_t)(words[index] >> 16) : (uint16_t)words[index];
+        return (uint16_t)(SCOPE_Acq_Sample(words, mode, channel, index) << SCOPE_DECIM_HIRES_BITS);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
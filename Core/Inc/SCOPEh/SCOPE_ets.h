@@ -0,0 +1,94 @@
+/*
+ * @file    SCOPE_ets.h
+ * @brief   示波器等效时间采样头文件
+ * @details 快时基下 ADC 的采样率不够一列一个采样。对重复信号，每次触发时采样时刻与
+ *          触发点之间的相位是随机的：按触发越过点的插值位置 (Q8) 计算每个采样相对触发点的时间，
+ *          落入以等效采样间隔划分的列中，多次采集后逐渐填满整个屏幕。
+ *          等效采样率 = 实际采样率 x 倍数，倍数不超过 SCOPE_ETS_MAX_RATIO。
+ *
+ * 每列保存最近一次落入的码值，覆盖率为已填充的列所占的比例。
+ * 未填充的列显示时在相邻的已填充列之间线性插值。
+ * 相位由采样插值得到，要求触发沿跨越至少一个采样间隔 (正弦、带宽受限的边沿)；
+ * 理想的阶跃每次得到相同的越过点，无法展开。
+ *
+ * 使用说明:
+ * 1. 期望采样率高于实际采样率时用 SCOPE_Ets_Set_Ratio 设置倍数，
+ *    SCOPE_Ets_Set_Trigger_Column 设置触发点所在的列，
+ *    采集记录的预触发采样数改为 SCOPE_Ets_Get_Pretrigger 的返回值。
+ * 2. 主循环在窗口冻结后调用 SCOPE_Ets_Add，再用 SCOPE_Ets_To_Screen 转换波形。
+ * 3. 只有满足触发条件的窗口才有相位信息，强制触发 (自动扫描超时) 的窗口被忽略。
+ * 4. 各列的码值在采样存储的工作区 (SCOPE_SMEM_ETS)，其它采集方式取得工作区后已填充的列失效，
+ *    下一次 SCOPE_Ets_Add 重新取得并从头填充。
+ */
+#ifndef __SCOPE_ETS_H
+#define __SCOPE_ETS_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief  设置等效采样倍数，倍数改变时丢弃已填充的列
+     * @param  ratio 等效采样率 / 实际采样率 (1 ~ SCOPE_ETS_MAX_RATIO，超出时限制)
+     * @retval 实际倍数 (量化为 1/256)
+     */
+    float SCOPE_Ets_Set_Ratio(float ratio);
+
+    /**
+     * @brief  获取等效采样倍数
+     * @retval 倍数
+     */
+    float SCOPE_Ets_Get_Ratio(void);
+
+    /**
+     * @brief  设置触发点所在的列，改变时丢弃已填充的列
+     * @param  column 列 (0 ~ SCOPE_RECORD_LEN - 1)
+     * @retval 无
+     */
+    void SCOPE_Ets_Set_Trigger_Column(uint16_t column);
+
+    /**
+     * @brief  获取采集记录需要的预触发采样数
+     * @retval 采样数：覆盖触发点左侧所有列，另留两个采样的余量
+     */
+    uint16_t SCOPE_Ets_Get_Pretrigger(void);
+
+    /**
+     * @brief  丢弃已填充的列
+     * @retval 无
+     */
+    void SCOPE_Ets_Reset(void);
+
+    /**
+     * @brief  把冻结的采集窗口中的采样按相位放入各列
+     * @retval 1: 已放入，0: 窗口由强制触发产生，没有相位信息
+     * @note   须在 SCOPE_Capture_Ready 之后、SCOPE_Capture_Rearm 之前调用。
+     *         窗口的采集模式与已填充的不同时自动重新开始。
+     */
+    uint8_t SCOPE_Ets_Add(void);
+
+    /**
+     * @brief  获取覆盖率
+     * @retval 已填充的列所占的百分比 (0 ~ 100)
+     */
+    uint8_t SCOPE_Ets_Get_Coverage(void);
+
+    /**
+     * @brief  把一个通道的等效时间记录转换为屏幕Y坐标
+     * @param  channel       通道 (0: CH1，1: CH2)
+     * @param  wave_y        输出：每列的屏幕Y坐标
+     * @param  points        点数 (不超过 SCOPE_RECORD_LEN)
+     * @param  volts_per_div 电压刻度 (V/div)
+     * @retval 1: 已输出，0: 还没有填充的列或不含该通道 (不修改输出)
+     */
+    uint8_t SCOPE_Ets_To_Screen(uint8_t channel, uint16_t *wave_y, uint16_t points, float volts_per_div);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ * @file    SCOPE_fft.h
+ * @brief   示波器频谱分析头文件
+ * @details 抽取后的采样流中连续 N 个采样 (256/512/1024) 收集到采样存储区，
+ *          主循环加窗后用 Q15 定点 FFT 原地变换，不需要另外的缓冲区：
+ *          N 个实数采样看作 N/2 个复数 (偶数采样为实部、奇数采样为虚部)，
+ *          做 N/2 点复数 FFT (基 4，级数为奇数时先做一级基 2；块浮点：只在可能溢出的级右移)，
+ *          再拆分出实数序列的 N/2 个频点，每个频点的功率 (re^2 + im^2，32 位) 写回该频点原来的位置。
+ *          正弦表和窗函数表在 Flash 中 (SCOPE_fft_table.c)。
+ *
+ * 幅度换算：每级都右移 (基 4 的级右移 2 位) 时结果为 X[k] * 2 / N，幅度为 A 码值的正弦在其频点上的幅度为 16 * A * 窗的相干增益，
+ *   每少移 1 位结果再放大一倍。SCOPE_Fft_Power_To_Dbv 据此换算为有效值的 dBV，与窗、点数和移位都无关；
+ *   功率值的刻度随帧变化，只能在同一帧内直接比较。
+ *
+ * 使用说明:
+ * 1. SCOPE_Fft_Start 取得采样存储区并开始收集，同时用 SCOPE_Decim_Set_Output 把抽取输出改为
+ *    SCOPE_Fft_Block 和 SCOPE_Fft_Envelope_Block。
+ * 2. 主循环在 SCOPE_Fft_Ready 返回 1 后调用 SCOPE_Fft_Compute，再用 SCOPE_Fft_To_Screen 转换为
+ *    屏幕坐标或 SCOPE_Fft_Get_Power 读取各频点，最后 SCOPE_Fft_Rearm 开始收集下一帧。
+ * 3. 存储区被其它使用者取得后不再收集，需要重新调用 SCOPE_Fft_Start。
+ */
+#ifndef __SCOPE_FFT_H
+#define __SCOPE_FFT_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 窗函数
+     */
+    typedef enum
+    {
+        SCOPE_FFT_RECT = 0,        // 矩形窗 (不加窗)
+        SCOPE_FFT_HANN,            // Hann 窗
+        SCOPE_FFT_HAMMING,         // Hamming 窗
+        SCOPE_FFT_BLACKMAN_HARRIS, // 4 项 Blackman-Harris 窗 (旁瓣最低)
+        SCOPE_FFT_FLATTOP          // 平顶窗 (幅度最准)
+    } SCOPE_Fft_Window;
+
+    /**
+     * @brief  取得采样存储区并开始收集
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @param  size    点数 (256、512 或 1024，其它值取不超过它的最大值)
+     * @param  window  窗函数
+     * @retval 无
+     * @note   分段存储和长记录的内容随之失效
+     */
+    void SCOPE_Fft_Start(uint8_t channel, uint16_t size, SCOPE_Fft_Window window);
+
+    /**
+     * @brief  数据块输出 (普通/高分辨率方式)，注册到 SCOPE_Decim_Set_Output
+     * @param  words 每列一个打包的数据字
+     * @param  count 字数
+     * @param  mode  采集模式
+     * @retval 无
+     * @note   在中断中调用
+     */
+    void SCOPE_Fft_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode);
+
+    /**
+     * @brief  包络输出 (峰值检测方式)，取每列最小值和最大值的中点
+     * @param  min_words 每列各通道的最小值
+     * @param  max_words 每列各通道的最大值
+     * @param  count     列数
+     * @retval 无
+     * @note   在中断中调用
+     */
+    void SCOPE_Fft_Envelope_Block(const uint32_t *min_words, const uint32_t *max_words, uint16_t count);
+
+    /**
+     * @brief  查询一帧是否已收集完
+     * @retval 1: 已收集完，0: 正在收集
+     */
+    uint8_t SCOPE_Fft_Ready(void);
+
+    /**
+     * @brief  加窗并原地变换，之后可读取各频点的功率
+     * @retval 无
+     */
+    void SCOPE_Fft_Compute(void);
+
+    /**
+     * @brief  开始收集下一帧
+     * @retval 无
+     */
+    void SCOPE_Fft_Rearm(void);
+
+    /**
+     * @brief  获取频点数
+     * @retval N / 2
+     */
+    uint16_t SCOPE_Fft_Get_Bins(void);
+
+    /**
+     * @brief  获取一个频点的功率
+     * @param  bin 频点 (0 为直流，频率为 bin * 采样率 / N)
+     * @retval 功率 (re^2 + im^2)
+     */
+    uint32_t SCOPE_Fft_Get_Power(uint16_t bin);
+
+    /**
+     * @brief  获取窗函数主瓣 (含近处旁瓣) 的半宽
+     * @retval 频点数，一个正弦分量的功率分布在峰值两侧各这么多个频点内
+     */
+    uint8_t SCOPE_Fft_Get_Lobe(void);
+
+    /**
+     * @brief  获取窗函数的等效噪声带宽
+     * @retval 频点数，一个正弦分量各频点功率之和 = 峰值功率 (频点上没有偏差时) * 等效噪声带宽
+     */
+    float SCOPE_Fft_Get_Enbw(void);
+
+    /**
+     * @brief  功率换算为 dBV (正弦有效值)
+     * @param  power 功率 (一个频点的功率，或多个频点之和除以等效噪声带宽)
+     * @retval dBV，功率为 0 时为 -200
+     */
+    float SCOPE_Fft_Power_To_Dbv(float power);
+
+    /**
+     * @brief  把频谱转换为屏幕Y坐标，每列为该列所含频点的最大值到最小值
+     * @param  max_y      输出：每列最大值的屏幕Y坐标 (0 ~ 直流，最后一列为采样率的一半)
+     * @param  min_y      输出：每列最小值的屏幕Y坐标
+     * @param  points     列数
+     * @param  top_dbv    屏幕顶部对应的电平 (dBV)
+     * @param  db_per_div 每格的分贝数
+     * @retval 无
+     */
+    void SCOPE_Fft_To_Screen(uint16_t *max_y, uint16_t *min_y, uint16_t points, float top_dbv, float db_per_div);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
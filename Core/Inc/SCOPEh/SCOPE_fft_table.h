@@ -0,0 +1,27 @@
+/*
+ * @file    SCOPE_fft_table.h
+ * @brief   示波器频谱分析常数表头文件
+ * @details 正弦表和窗函数表都是 const，由链接器放在 Flash 中，不占用 SRAM。
+ *          表按最大变换点数 SCOPE_FFT_MAX_SIZE (1024) 生成，较短的变换按步长取值。
+ */
+#ifndef __SCOPE_FFT_TABLE_H
+#define __SCOPE_FFT_TABLE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    extern const int16_t SCOPE_Fft_Sin_Table[257];             // sin(2πk/1024)，k = 0 ~ 256
+    extern const int16_t SCOPE_Fft_Hann_Table[513];            // Hann 窗，n = 0 ~ 512
+    extern const int16_t SCOPE_Fft_Hamming_Table[513];         // Hamming 窗
+    extern const int16_t SCOPE_Fft_BlackmanHarris_Table[513];  // 4 项 Blackman-Harris 窗
+    extern const int16_t SCOPE_Fft_Flattop_Table[513];         // 平顶窗
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
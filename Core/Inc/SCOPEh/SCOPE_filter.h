@@ -0,0 +1,72 @@
+/*
+ * @file    SCOPE_filter.h
+ * @brief   示波器数字耦合与带宽限制头文件
+ * @details 在 DMA 数据块回调中、抽取之前对原始采样滤波，之后的记录、触发和测量看到的都是滤波后的波形:
+ *          - 交流耦合：减去滑动的直流估计 (一阶高通)，输出以 SCOPE_ADC_ZERO_CODE 为中心
+ *          - 带宽限制：巴特沃斯低通，二阶节级联，定点系数在采样率改变时计算
+ *          滤波器状态跨数据块保存，数据块边界上没有暂态；状态复位后用第一个采样预置为稳态，
+ *          打开滤波或改变采样率时也没有起始暂态。
+ *
+ * 使用说明:
+ * 1. 把 SCOPE_Filter_Block 注册为采集引擎的数据块回调，它原地滤波后交给 SCOPE_Decim_Block。
+ * 2. 采样率或采集模式改变后用 SCOPE_Acq_Get_Sample_Rate 的结果调用 SCOPE_Filter_Set_Rate。
+ * 3. 滤波改变了采样，模拟看门狗看到的原始码值与记录不一致，打开滤波时需要关闭看门狗预检
+ *    (SCOPE_Capture_Use_Watchdog)。
+ */
+#ifndef __SCOPE_FILTER_H
+#define __SCOPE_FILTER_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief  设置耦合方式
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @param  ac      1: 交流耦合，0: 直流耦合
+     * @retval 无
+     */
+    void SCOPE_Filter_Set_Coupling(uint8_t channel, uint8_t ac);
+
+    /**
+     * @brief  设置带宽限制
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @param  on      1: 打开，0: 关闭
+     * @retval 无
+     * @note   截止频率不低于采样率的 0.45 倍时滤波没有意义，不处理
+     */
+    void SCOPE_Filter_Set_Bwl(uint8_t channel, uint8_t on);
+
+    /**
+     * @brief  按 ADC 采样率重新计算系数，并复位滤波器状态
+     * @param  sample_rate 每通道的 ADC 采样率 (Hz)，快速交替模式为交替后的采样率
+     * @retval 无
+     */
+    void SCOPE_Filter_Set_Rate(float sample_rate);
+
+    /**
+     * @brief  查询是否有通道在滤波
+     * @retval 1: 至少一个通道打开了交流耦合或带宽限制，0: 数据原样转发
+     */
+    uint8_t SCOPE_Filter_Is_Active(void);
+
+    /**
+     * @brief  数据块回调，注册到 SCOPE_Acq_Set_Block_Handler
+     * @param  words 打包的数据字，滤波结果原地写回
+     * @param  count 字数
+     * @param  mode  采集模式
+     * @retval 无
+     * @note   在中断中调用。DMA 此时写的是另一半缓冲区，写回本数据块是安全的。
+     */
+    void SCOPE_Filter_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * @file    SCOPE_graticule.h
+ * @brief   示波器网格 (刻度) 图层头文件
+ * @details 网格不再用 HLine/VLine 逐条绘制，而是用一个紧凑的参数描述：网格间距、中心轴、
+ *          中心轴上的小刻度和触发电平虚线。任意渲染器 (条带、逐列、滚动) 都可以 O(1)
+ *          查询某个像素的背景颜色，网格在合成波形时顺带输出，不需要单独重绘。
+ */
+#ifndef __SCOPE_GRATICULE_H
+#define __SCOPE_GRATICULE_H
+
+#include "TFTh/TFT_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 网格图层参数
+     * @note  由 SCOPE_Graticule_Init 填写默认值，颜色等字段可在之后修改
+     */
+    typedef struct
+    {
+        uint16_t width;         // 区域宽度 (时间轴)
+        uint16_t height;        // 区域高度 (电压轴)
+        uint16_t pitch;         // 网格间距 (像素/格)
+        uint16_t minor_pitch;   // 小刻度间距 (像素)
+        uint16_t center_x;      // 垂直中心轴的X坐标
+        uint16_t center_y;      // 水平中心轴的Y坐标
+        uint8_t tick_len;       // 小刻度向中心轴两侧伸出的长度 (像素)
+        uint8_t trigger_visible; // 是否显示触发电平虚线
+        uint16_t trigger_y;     // 触发电平的Y坐标
+        uint16_t bg_color;      // 背景颜色
+        uint16_t grid_color;    // 网格线颜色
+        uint16_t axis_color;    // 中心轴及小刻度颜色
+        uint16_t trigger_color; // 触发电平虚线颜色
+    } SCOPE_Graticule;
+
+/**
+ * @brief 触发电平虚线的实线/间隔长度 (像素)
+ */
+#define SCOPE_GRATICULE_DASH 3
+
+    /**
+     * @brief  初始化网格图层
+     * @param  g      网格图层
+     * @param  width  区域宽度
+     * @param  height 区域高度
+     * @param  pitch  网格间距 (像素/格)
+     * @retval 无
+     * @note   默认每格 5 个小刻度、刻度长 2 像素，配色与原先逐线绘制的网格一致。
+     */
+    void SCOPE_Graticule_Init(SCOPE_Graticule *g, uint16_t width, uint16_t height, uint16_t pitch);
+
+    /**
+     * @brief  设置触发电平虚线
+     * @param  g       网格图层
+     * @param  visible 是否显示
+     * @param  y       触发电平的Y坐标 (超出区域时不显示)
+     * @retval 无
+     */
+    void SCOPE_Graticule_Set_Trigger(SCOPE_Graticule *g, uint8_t visible, uint16_t y);
+
+    /**
+     * @brief  输出一整行的背景像素
+     * @param  g      网格图层
+     * @param  y      行坐标
+     * @param  row_be 输出缓冲区，写入 width 个大端序 RGB565 像素
+     * @retval 无
+     * @note   与逐像素调用 SCOPE_Graticule_Pixel 结果相同，但用计数器代替取模，供条带渲染器使用。
+     */
+    void SCOPE_Graticule_Fill_Row(const SCOPE_Graticule *g, uint16_t y, uint16_t *row_be);
+
+    /**
+     * @brief  查询单个像素的背景颜色
+     * @param  g 网格图层
+     * @param  x 列坐标
+     * @param  y 行坐标
+     * @retval RGB565 颜色 (本机字节序)
+     * @note   优先级从高到低：触发电平虚线、中心轴、小刻度、网格线、背景。
+     */
+    static inline uint16_t SCOPE_Graticule_Pixel(const SCOPE_Graticule *g, uint16_t x, uint16_t y)
+    {
+        if (g->trigger_visible && y == g->trigger_y && (x % (2 * SCOPE_GRATICULE_DASH)) < SCOPE_GRATICULE_DASH)
+            return g->trigger_color;
+        if (x == g->center_x || y == g->center_y)
+            return g->axis_color;
+        if ((uint16_t)(y - g->center_y + g->tick_len) <= 2 * g->tick_len && (x % g->minor_pitch) == 0)
+            return g->axis_color;
+        if ((uint16_t)(x - g->center_x + g->tick_len) <= 2 * g->tick_len && (y % g->minor_pitch) == 0)
+            return g->axis_color;
+        if ((x % g->pitch) == 0 || (y % g->pitch) == 0)
+            return g->grid_color;
+        return g->bg_color;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
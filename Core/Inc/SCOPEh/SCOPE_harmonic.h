@@ -0,0 +1,67 @@
+/*
+ * @file    SCOPE_harmonic.h
+ * @brief   示波器谐波分析头文件
+ * @details 直接在 SCOPE_Fft_Compute 之后的频点功率上计算，不需要另外的缓冲区。
+ *          基波为直流以外功率最大的频点，用相邻三个频点的对数功率做抛物线插值得到小数频点。
+ *          每个频点只归入一类 (优先级从高到低)：直流、基波、2 ~ SCOPE_HARM_MAX_ORDER 次谐波、噪声。
+ *          一个分量包括其中心两侧各 SCOPE_Fft_Get_Lobe 个频点；超过采样率一半的谐波按混叠后的位置计入。
+ *          噪声按被其它分量占用的频点数补偿 (取其余频点的平均值)。
+ *
+ * 计算方法 (功率均为频点之和):
+ *   THD   = 10 lg (谐波 / 基波)            (dB，越小越好)
+ *   SNR   = 10 lg (基波 / 噪声)            (dB)
+ *   SINAD = 10 lg (基波 / (噪声 + 谐波))   (dB)
+ *   ENOB  = (SINAD - 1.76) / 6.02         (位，输入不是满量程时偏低)
+ *
+ * 使用说明:
+ * 1. 矩形窗只适合整周期采样的信号，Hamming 窗远处旁瓣较高，泄漏都会被当作噪声；
+ *    测量 SNR/ENOB 时用 Blackman-Harris 窗 (动态范围最大) 或平顶窗。
+ * 2. 频谱模式下每一帧变换后 (SCOPE_Fft_Rearm 之前) 调用 SCOPE_Harmonic_Analyze。
+ */
+#ifndef __SCOPE_HARMONIC_H
+#define __SCOPE_HARMONIC_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 谐波分析项
+     */
+    typedef enum
+    {
+        SCOPE_HARM_FUND = 0, // 基波频率 (Hz)
+        SCOPE_HARM_LEVEL,    // 基波电平 (dBV)
+        SCOPE_HARM_THD,      // 总谐波失真 (dB)
+        SCOPE_HARM_SNR,      // 信噪比 (dB)
+        SCOPE_HARM_SINAD,    // 信纳比 (dB)
+        SCOPE_HARM_ENOB,     // 有效位数 (位)
+        SCOPE_HARM_COUNT     // 分析项数
+    } SCOPE_Harm_Item;
+
+    /**
+     * @brief 谐波分析结果
+     */
+    typedef struct
+    {
+        uint8_t valid;                 // 1: 结果有效 (找到了基波且有噪声频点)
+        float value[SCOPE_HARM_COUNT]; // 各项的值，单位见 SCOPE_Harm_Item
+    } SCOPE_Harm_Result;
+
+    /**
+     * @brief  分析当前帧的频谱
+     * @param  sample_rate 频谱的采样率 (Hz)，即 SCOPE_Decim_Get_Rate 的结果
+     * @param  result      输出：分析结果
+     * @retval 无
+     */
+    void SCOPE_Harmonic_Analyze(float sample_rate, SCOPE_Harm_Result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
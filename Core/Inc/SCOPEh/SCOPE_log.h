@@ -0,0 +1,88 @@
+/*
+ * @file    SCOPE_log.h
+ * @brief   示波器长记录 (差分编码) 头文件
+ * @details 滚动模式下把每一列按帧 (各打开的通道一个采样) 追加到采样存储区，用于慢信号的数据记录。
+ *          缓慢变化的信号相邻采样之差很小，按差值变长编码后比原始记录长数倍:
+ *          差值 d 先做 zig-zag 映射 z = (d << 1) ^ (d >> 31)，再按 4 位一组 (半字节) 输出:
+ *            0zzz                         z < 8         (1 组)
+ *            10zz zzzz                    z - 8 < 64    (2 组)
+ *            110z zzzz zzzz               z - 72 < 512  (3 组)
+ *            1110 vvvv vvvv vvvv          其它：直接给出 12 位码值 (4 组)
+ *
+ * 每 SCOPE_LOG_BLOCK 帧为一块 (关键帧)，块首保存各通道的原始值，因此可以从任一块开始解码，
+ * 缩放浏览时定位到某一帧最多只需解码一块。编码后比 12 位打包的原始数据还大的块 (噪声很大) 改为原样保存。
+ * 块在存储区中首尾相接，空间不够时丢弃最早的块，始终保留最近的记录。
+ *
+ * 块格式 (字节对齐):
+ *   头 (16 位小端)：bit15 = 1 表示原样保存，bit0~14 为整块字节数
+ *   编码块：各通道首帧码值 (16 位小端)，之后是其余帧的半字节码流 (先低 4 位)，帧内按通道顺序
+ *   原样块：全部采样按 12 位打包 (见 SCOPE_smem.h)，帧内按通道顺序
+ *
+ * 使用说明:
+ * 1. SCOPE_Log_Start 取得采样存储区并开始新的记录，之后每一列调用一次 SCOPE_Log_Append。
+ * 2. SCOPE_Log_Read 按帧序号读取任一通道的一段记录，SCOPE_Log_Get_Stats 获取压缩比等统计。
+ * 3. 只在主循环中调用。
+ */
+#ifndef __SCOPE_LOG_H
+#define __SCOPE_LOG_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 长记录的统计
+     */
+    typedef struct
+    {
+        uint32_t first;      // 最早一帧的序号 (开始记录以来)
+        uint32_t frames;     // 可读取的帧数
+        uint16_t bytes;      // 已写入的块占用的字节数
+        uint16_t blocks;     // 块数
+        uint16_t raw_blocks; // 其中原样保存的块数
+        float ratio;         // 压缩比：每采样 2 字节的原始记录所需字节数 / 实际字节数
+    } SCOPE_Log_Stats;
+
+    /**
+     * @brief  取得采样存储区并开始新的记录
+     * @param  channels 记录的通道 (bit0: CH1，bit1: CH2)
+     * @retval 无
+     * @note   分段存储已采集的段随之作废
+     */
+    void SCOPE_Log_Start(uint8_t channels);
+
+    /**
+     * @brief  追加一帧
+     * @param  ch1 通道1码值
+     * @param  ch2 通道2码值
+     * @retval 无
+     * @note   只保存开始记录时指定的通道；存储区被分段存储占用后不再记录
+     */
+    void SCOPE_Log_Append(uint16_t ch1, uint16_t ch2);
+
+    /**
+     * @brief  读取一个通道的一段记录
+     * @param  channel 通道 (0: CH1，1: CH2)
+     * @param  first   第一帧的序号 (早于最早一帧时从最早一帧开始)
+     * @param  count   帧数
+     * @param  codes   输出：12 位码值
+     * @retval 实际读取的帧数
+     */
+    uint16_t SCOPE_Log_Read(uint8_t channel, uint32_t first, uint16_t count, uint16_t *codes);
+
+    /**
+     * @brief  获取统计
+     * @param  stats 输出：统计
+     * @retval 无
+     */
+    void SCOPE_Log_Get_Stats(SCOPE_Log_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
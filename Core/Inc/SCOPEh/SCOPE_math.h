@@ -0,0 +1,109 @@
+/*
+ * @file    SCOPE_math.h
+ * @brief   示波器数学通道头文件
+ * @details 数学通道由一个信源通道和最多 SCOPE_MATH_MAX_KERNELS 级运算组成，
+ *          冻结窗口的每个采样依次流过各级运算后直接换算为屏幕Y坐标，只扫描窗口一遍，
+ *          中间结果不需要另外的缓冲区，各级只保存一两个状态量。
+ *          运算全部为定点：数据为 Q8 码值 (int32)，积分的累加器为 64 位，溢出时饱和。
+ *          每级运算改变结果的量纲 (V、V^2、Vs、V/s ...)，最后由浮点单位系数换算为物理量。
+ *
+ * 运算:
+ *   ADD/SUB/MUL 与另一个通道的同一采样相加、相减、相乘 (只能用在量纲为 V 的数据上)
+ *   INTG        积分：从窗口左端开始的累加和 * 采样间隔
+ *   DIFF        微分：一阶差分 / 采样间隔
+ *   LPF         一阶 IIR 低通，截止频率由 SCOPE_Math_Set_Lowpass 设置，以第一个采样为初值 (左端没有过渡)
+ *
+ * 刻度：可以固定每格的值，也可以自动选择 1-2-5 序列中使结果不超过 ±3.5 格的最小刻度；
+ *   自动刻度改变时按新刻度再扫描一遍。
+ *
+ * 使用说明:
+ * 1. SCOPE_Math_Set_Source 和 SCOPE_Math_Set_Kernels 设置运算，窗口冻结后 (重新装填之前)
+ *    调用 SCOPE_Math_To_Screen。
+ * 2. SCOPE_Math_Get_Scale 和 SCOPE_Math_Get_Unit 用于显示刻度。
+ */
+#ifndef __SCOPE_MATH_H
+#define __SCOPE_MATH_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 运算
+     */
+    typedef enum
+    {
+        SCOPE_MATH_ADD = 0, // 加另一个通道
+        SCOPE_MATH_SUB,     // 减另一个通道
+        SCOPE_MATH_MUL,     // 乘另一个通道
+        SCOPE_MATH_INTG,    // 积分
+        SCOPE_MATH_DIFF,    // 微分
+        SCOPE_MATH_LPF,     // 低通滤波
+        SCOPE_MATH_KERNEL_COUNT
+    } SCOPE_Math_Kernel;
+
+    /**
+     * @brief  设置信源通道
+     * @param  channel 通道 (0: CH1，1: CH2)，ADD/SUB/MUL 使用另一个通道
+     * @retval 无
+     */
+    void SCOPE_Math_Set_Source(uint8_t channel);
+
+    /**
+     * @brief  设置运算序列
+     * @param  kernels 运算 (按顺序执行)
+     * @param  count   级数 (0 表示直接显示信源)
+     * @retval 接受的级数：遇到超出 SCOPE_MATH_MAX_KERNELS 或量纲不允许的运算时截止
+     */
+    uint8_t SCOPE_Math_Set_Kernels(const SCOPE_Math_Kernel *kernels, uint8_t count);
+
+    /**
+     * @brief  设置低通滤波的截止频率
+     * @param  cutoff_hz 截止频率 (Hz)
+     * @retval 无
+     */
+    void SCOPE_Math_Set_Lowpass(float cutoff_hz);
+
+    /**
+     * @brief  获取低通滤波的截止频率
+     * @retval 截止频率 (Hz)
+     */
+    float SCOPE_Math_Get_Lowpass(void);
+
+    /**
+     * @brief  设置刻度
+     * @param  per_div 每格的值 (单位见 SCOPE_Math_Get_Unit)，0 表示自动
+     * @retval 无
+     */
+    void SCOPE_Math_Set_Scale(float per_div);
+
+    /**
+     * @brief  获取当前刻度 (自动刻度时为最近一次选择的值)
+     * @retval 每格的值
+     */
+    float SCOPE_Math_Get_Scale(void);
+
+    /**
+     * @brief  获取结果的单位
+     * @retval 单位字符串，例如 "V"、"V^2"、"Vs"、"V/s"
+     */
+    const char *SCOPE_Math_Get_Unit(void);
+
+    /**
+     * @brief  计算冻结窗口的数学通道并转换为屏幕Y坐标
+     * @param  wave_y      输出：每列的屏幕Y坐标
+     * @param  points      点数 (不超过 SCOPE_RECORD_LEN)
+     * @param  sample_rate 窗口的采样率 (Hz)，即 SCOPE_Decim_Get_Rate 的结果
+     * @retval 1: 已输出，0: 窗口不含需要的通道 (不修改输出)
+     */
+    uint8_t SCOPE_Math_To_Screen(uint16_t *wave_y, uint16_t points, float sample_rate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * @file    SCOPE_measure.h
+ * @brief   示波器自动测量头文件
+ * @details 直接在冻结窗口的原始码值上测量，结果与电压刻度和屏幕分辨率无关。
+ *          幅度测量用一遍整数累加 (最大值、最小值、和、平方和) 完成；时间测量需要用到
+ *          幅度得到的参考电平，只在选中了时间测量项时再扫描一遍。每次采集每项最多计算一次。
+ *
+ * 时间测量的参考电平 (与常见示波器相同):
+ *   低 10%、中 50%、高 90% (相对最小值到最大值)
+ *   只有越过高电平后再越过低电平 (或反之) 才算一个边沿，中间的噪声不会产生多余的边沿。
+ *   边沿时刻取越过中电平的位置，在相邻两个采样之间线性插值 (1/256 采样)。
+ *   上升时间为越过低电平到越过高电平的时间 (取平均)，下降时间相反。
+ *   周期取第一个与最后一个同向边沿之间的平均间隔，正脉宽为上升沿到下一个下降沿的平均时间。
+ *
+ * 使用说明:
+ * 1. 用 SCOPE_MEAS_BIT 组合需要的测量项，窗口冻结后 (重新装填之前) 调用 SCOPE_Measure_Capture。
+ * 2. 结果中 valid 的对应位为 1 时该项有效 (例如窗口内不足两个边沿时周期无效)。
+ */
+#ifndef __SCOPE_MEASURE_H
+#define __SCOPE_MEASURE_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 测量项
+     */
+    typedef enum
+    {
+        SCOPE_MEAS_VMAX = 0, // 最大值 (V)
+        SCOPE_MEAS_VMIN,     // 最小值 (V)
+        SCOPE_MEAS_VPP,      // 峰峰值 (V)
+        SCOPE_MEAS_VAVG,     // 平均值 (V)
+        SCOPE_MEAS_VRMS,     // 有效值 (V，含直流分量)
+        SCOPE_MEAS_PERIOD,   // 周期 (s)
+        SCOPE_MEAS_FREQ,     // 频率 (Hz)
+        SCOPE_MEAS_RISE,     // 上升时间 10%~90% (s)
+        SCOPE_MEAS_FALL,     // 下降时间 90%~10% (s)
+        SCOPE_MEAS_DUTY,     // 正占空比 (%)
+        SCOPE_MEAS_PWIDTH,   // 正脉宽 (s)
+        SCOPE_MEAS_COUNT     // 测量项数
+    } SCOPE_Meas_Item;
+
+/**
+ * @brief 测量项对应的选择位
+ */
+#define SCOPE_MEAS_BIT(item) ((uint16_t)(1u << (item)))
+#define SCOPE_MEAS_ALL ((uint16_t)(SCOPE_MEAS_BIT(SCOPE_MEAS_COUNT) - 1))
+
+    /**
+     * @brief 测量结果
+     */
+    typedef struct
+    {
+        uint16_t valid;                 // 有效的测量项 (SCOPE_MEAS_BIT 组合)
+        float value[SCOPE_MEAS_COUNT];  // 各项的值，单位见 SCOPE_Meas_Item
+    } SCOPE_Meas_Result;
+
+    /**
+     * @brief  测量冻结窗口中一个通道的采样
+     * @param  channel     通道 (0: CH1，1: CH2)
+     * @param  mask        需要的测量项 (SCOPE_MEAS_BIT 组合)
+     * @param  sample_rate 窗口的采样率 (Hz)，即 SCOPE_Decim_Get_Rate 的结果
+     * @param  result      输出：测量结果
+     * @retval 无
+     */
+    void SCOPE_Measure_Capture(uint8_t channel, uint16_t mask, float sample_rate, SCOPE_Meas_Result *result);
+
+    /**
+     * @brief  测量一段码值
+     * @param  codes       12 位码值
+     * @param  count       采样数
+     * @param  mask        需要的测量项 (SCOPE_MEAS_BIT 组合)
+     * @param  sample_rate 采样率 (Hz)
+     * @param  result      输出：测量结果
+     * @retval 无
+     */
+    void SCOPE_Measure_Codes(const uint16_t *codes, uint16_t count, uint16_t mask, float sample_rate, SCOPE_Meas_Result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * @file    SCOPE_persist.h
+ * @brief   示波器余辉 (荧光) 显示头文件
+ * @details 多次采集的波形累积到一张 4 位强度图中并随时间衰减，渲染时通过颜色查找表上色，
+ *          使抖动和偶发毛刺在屏幕上留下可见的痕迹。
+ */
+#ifndef __SCOPE_PERSIST_H
+#define __SCOPE_PERSIST_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 余辉模式
+     */
+    typedef enum
+    {
+        SCOPE_PERSIST_OFF = 0,   // 关闭
+        SCOPE_PERSIST_100MS,     // 100ms 余辉
+        SCOPE_PERSIST_1S,        // 1s 余辉
+        SCOPE_PERSIST_INFINITE   // 无限余辉 (不衰减)
+    } SCOPE_Persist_Mode;
+
+#define SCOPE_PERSIST_COLS (SCOPE_PLOT_WIDTH / SCOPE_PERSIST_DECIM_X)  // 强度图列数
+#define SCOPE_PERSIST_ROWS (SCOPE_PLOT_HEIGHT / SCOPE_PERSIST_DECIM_Y) // 强度图行数
+
+    /**
+     * @brief 强度 (0-15) 到 RGB565 颜色的查找表，0 表示无余辉 (显示背景)
+     */
+    extern const uint16_t SCOPE_Persist_LUT[16];
+
+    /**
+     * @brief 强度图，每字节存放两个单元 (低4位为偶数列，高4位为奇数列)
+     * @note  仅供渲染器内联读取，修改请使用本模块函数
+     */
+    extern uint8_t scope_persist_map[SCOPE_PERSIST_ROWS][SCOPE_PERSIST_COLS / 2];
+
+    /**
+     * @brief  设置余辉模式，切换模式时清空强度图
+     * @param  mode 余辉模式
+     * @retval 无
+     */
+    void SCOPE_Persist_Set_Mode(SCOPE_Persist_Mode mode);
+
+    /**
+     * @brief  获取当前余辉模式
+     * @retval 当前余辉模式
+     */
+    SCOPE_Persist_Mode SCOPE_Persist_Get_Mode(void);
+
+    /**
+     * @brief  清空强度图
+     * @retval 无
+     */
+    void SCOPE_Persist_Clear(void);
+
+    /**
+     * @brief  按经过的时间衰减强度图
+     * @param  now_ms 当前时刻 (ms)，通常为 HAL_GetTick()
+     * @retval 1: 有单元变暗，需要重绘；0: 强度图未改变
+     * @note   余辉时间内从满亮度 (15) 衰减到 0。无限余辉和关闭模式下不做任何事。
+     *         没有新的采集时也要衰减，应在主循环每一轮调用，而不只是在累积之前。
+     */
+    uint8_t SCOPE_Persist_Decay(uint32_t now_ms);
+
+    /**
+     * @brief  把一次采集的波形累积到强度图
+     * @param  wave_y 每列的屏幕Y坐标
+     * @param  points 点数 (列数)
+     * @retval 无
+     * @note   相邻两点之间的连线区域都会被点亮；同一单元在一次采集中只累加一次。
+     */
+    void SCOPE_Persist_Accumulate(const uint16_t *wave_y, uint16_t points);
+
+    /**
+     * @brief  把一次采集的散点累积到强度图 (XY 显示)
+     * @param  xs     每个点的屏幕X坐标
+     * @param  ys     每个点的屏幕Y坐标
+     * @param  points 点数
+     * @retval 无
+     * @note   每个点都累加一次，点越密集的单元越亮。
+     */
+    void SCOPE_Persist_Accumulate_Points(const uint16_t *xs, const uint16_t *ys, uint16_t points);
+
+    /**
+     * @brief  读取单元强度
+     * @param  cx 单元列 (0 ~ SCOPE_PERSIST_COLS-1)
+     * @param  cy 单元行 (0 ~ SCOPE_PERSIST_ROWS-1)
+     * @retval 强度 0-15
+     */
+    static inline uint8_t SCOPE_Persist_Get(uint16_t cx, uint16_t cy)
+    {
+        uint8_t cell = scope_persist_map[cy][cx >> 1];
+        return (cx & 1) ? (cell >> 4) : (cell & 0x0F);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * @file    SCOPE_render.h
+ * @brief   示波器波形区域条带渲染器头文件
+ * @details 网格图层、余辉和波形在每个像素处合成后一次性发送，
+ *          整个波形区域只设置一次地址窗口，不再先清屏再逐条画线。
+ */
+#ifndef __SCOPE_RENDER_H
+#define __SCOPE_RENDER_H
+
+#include "TFTh/TFT_io.h"
+#include "SCOPEh/SCOPE_config.h"
+#include "SCOPEh/SCOPE_graticule.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 一帧波形区域的绘制参数
+     */
+    typedef struct
+    {
+        const uint16_t *wave1;   // 通道1每列的屏幕Y坐标 (XY 显示时为各点的X坐标)
+        const uint16_t *wave2;   // 通道2每列的屏幕Y坐标 (XY 显示时为各点的Y坐标，从小到大)
+        const uint16_t *env1;    // 通道1包络最小值的屏幕Y坐标 (峰值检测，NULL 表示不是包络)
+        const uint16_t *env2;    // 通道2包络最小值的屏幕Y坐标
+        const uint16_t *math;    // 数学通道每列的屏幕Y坐标 (NULL 表示不绘制)
+        uint16_t points;         // 每个通道的点数 (不超过 SCOPE_PLOT_WIDTH)
+        uint8_t ch1_enabled;     // 是否绘制通道1
+        uint8_t ch2_enabled;     // 是否绘制通道2
+        const SCOPE_Graticule *graticule; // 背景网格图层 (含触发电平虚线)
+        uint8_t persist_enabled; // 是否叠加余辉强度图
+        uint8_t xy;              // XY 显示：wave1/wave2 为 points 个点，不绘制包络和数学通道
+    } SCOPE_Plot;
+
+    /**
+     * @brief  渲染整个波形区域
+     * @param  htft TFT句柄指针
+     * @param  plot 绘制参数
+     * @retval 无
+     * @note   图层从下到上依次为：网格图层 (含触发电平)、余辉、数学通道、通道2、通道1。
+     *         XY 显示时余辉之上只有点。
+     *         文字和触发标志等叠加元素由调用者在之后绘制。
+     */
+    void SCOPE_Render_Plot(TFT_HandleTypeDef *htft, const SCOPE_Plot *plot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * @file    SCOPE_roll.h
+ * @brief   示波器滚动模式数据流头文件
+ * @details 慢时基下等待一整个窗口再显示会让画面停顿数秒。滚动模式不经过触发和采集记录：
+ *          抽取得到的每一列在数据块回调中立即放入列队列，主循环取出后绘制为一行，
+ *          从采样到显示的延迟为一列的时间加一个数据块，再加上主循环两次取出之间的间隔
+ *          (主循环在滚动模式下不延时，间隔取决于同一轮中的其它显示和串口处理)。
+ *          峰值检测方式下每列保留最小值和最大值，其余方式最小值与最大值相同。
+ *
+ * 使用说明:
+ * 1. 进入滚动模式时用 SCOPE_Decim_Set_Output 把抽取输出改为 SCOPE_Roll_Block 和
+ *    SCOPE_Roll_Envelope_Block，退出时改回采集记录。
+ * 2. 主循环用 SCOPE_Roll_Read 逐列取出；停止显示期间调用 SCOPE_Roll_Reset 丢弃积压的列。
+ *    队列在采样存储的工作区 (SCOPE_SMEM_ROLL)，进入滚动模式时须先调用 SCOPE_Roll_Reset 取得。
+ * 3. 队列满时丢弃新的列 (中断不能移动读位置)。
+ */
+#ifndef __SCOPE_ROLL_H
+#define __SCOPE_ROLL_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 一列数据 (12 位码值)
+     */
+    typedef struct
+    {
+        uint16_t max[2]; // 各通道最大值
+        uint16_t min[2]; // 各通道最小值
+    } SCOPE_Roll_Column;
+
+    /**
+     * @brief  数据块输出 (普通/高分辨率方式)，注册到 SCOPE_Decim_Set_Output
+     * @param  words 每列一个打包的数据字
+     * @param  count 字数
+     * @param  mode  采集模式 (快速交替模式下每字两列，另一通道为零点)
+     * @retval 无
+     * @note   在中断中调用
+     */
+    void SCOPE_Roll_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode);
+
+    /**
+     * @brief  包络输出 (峰值检测方式)，注册到 SCOPE_Decim_Set_Output
+     * @param  min_words 每列各通道的最小值
+     * @param  max_words 每列各通道的最大值
+     * @param  count     列数
+     * @retval 无
+     * @note   在中断中调用
+     */
+    void SCOPE_Roll_Envelope_Block(const uint32_t *min_words, const uint32_t *max_words, uint16_t count);
+
+    /**
+     * @brief  取出最早的一列
+     * @param  column 输出：列数据
+     * @retval 1: 已取出，0: 队列为空
+     */
+    uint8_t SCOPE_Roll_Read(SCOPE_Roll_Column *column);
+
+    /**
+     * @brief  丢弃队列中尚未取出的列
+     * @retval 无
+     * @note   工作区被其它使用者取得过时重新取得，须在抽取输出改为本模块之前调用
+     */
+    void SCOPE_Roll_Reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
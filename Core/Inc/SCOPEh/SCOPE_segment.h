@@ -0,0 +1,76 @@
+/*
+ * @file    SCOPE_segment.h
+ * @brief   示波器分段存储头文件
+ * @details 把采样存储分为 N 段，每段保存一个触发窗口和触发时刻的 32 位微秒时间戳。
+ *          窗口冻结回调在中断中安排保存窗口后立即重新等待触发，段与段之间没有主循环参与，
+ *          适合捕获间隔很长的突发信号：死区时间只是之后几个数据块的打包，而不是一整屏的长记录。
+ *          全部段采集完后采集记录保持冻结，由主循环用 SCOPE_Segment_Select 逐段浏览。
+ *
+ * 段以紧凑格式保存 (见 SCOPE_smem.h)，每段的大小取决于通道和存储格式，
+ * 在 SCOPE_SMEM_BYTES 字节的采样存储区中可容纳的段数为:
+ *              两个通道    一个通道
+ *   12 位         5          11
+ *   8 位          8          17
+ */
+#ifndef __SCOPE_SEGMENT_H
+#define __SCOPE_SEGMENT_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief  设置分段数并开始新的分段序列
+     * @param  count    分段数，不大于 1 时关闭分段存储
+     * @param  channels 采集的通道 (bit0: CH1，bit1: CH2)，决定每段的大小
+     * @param  format   存储格式：12 位无损，8 位可存放更多段
+     * @retval 实际分段数 (受 SCOPE_SMEM_BYTES 限制)，关闭时为 1
+     * @note   通道或存储格式改变后需要重新调用
+     */
+    uint16_t SCOPE_Segment_Set_Count(uint16_t count, uint8_t channels, SCOPE_Smem_Format format);
+
+    /**
+     * @brief  获取分段数
+     * @retval 分段数，1 表示未使用分段存储
+     */
+    uint16_t SCOPE_Segment_Get_Count(void);
+
+    /**
+     * @brief  丢弃已采集的段，下一次触发保存为第 1 段
+     * @retval 无
+     * @note   分段存储打开时取得采样存储区，长记录或频谱分析结束、回到触发模式时需要调用
+     */
+    void SCOPE_Segment_Reset(void);
+
+    /**
+     * @brief  获取已采集的段数
+     * @retval 段数 (0 ~ 分段数)
+     * @note   在主循环中调用，序列完成后先保存完最后一段
+     */
+    uint16_t SCOPE_Segment_Get_Done(void);
+
+    /**
+     * @brief  把一段装入采集记录的冻结窗口，之后按普通窗口读取和转换
+     * @param  index 段序号 (0 起)
+     * @retval 1: 成功，0: 该段尚未采集或窗口未冻结
+     */
+    uint8_t SCOPE_Segment_Select(uint16_t index);
+
+    /**
+     * @brief  获取一段相对第 1 段的触发时刻
+     * @param  index 段序号 (0 起)
+     * @retval 时间差 (us)
+     * @note   时间戳在保存窗口时读取，精度为一个数据块
+     */
+    uint32_t SCOPE_Segment_Get_Time(uint16_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
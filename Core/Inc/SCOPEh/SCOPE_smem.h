@@ -0,0 +1,187 @@
+/*
+ * @file    SCOPE_smem.h
+ * @brief   示波器紧凑采样存储头文件
+ * @details DMA 的数据字中每个 12 位采样占 16 位，保存较长的记录时浪费 1/4 的内存。
+ *          本模块把采样流打包保存:
+ *          - 12 位：每两个采样占三个字节，无损，比 16 位多存 1/3
+ *          - 8 位：只保留高 8 位，每个采样一个字节，比 16 位多存一倍，用于长记录
+ *
+ * 打包格式 (12 位，采样 a、b 为一对):
+ *   字节0 = a[7:0]，字节1 = a[11:8] | b[3:0] << 4，字节2 = b[11:4]
+ *
+ * 使用说明:
+ * 1. 写入：SCOPE_Smem_Writer_Init 指定目标后逐个 SCOPE_Smem_Put，最后 SCOPE_Smem_Flush。
+ * 2. 读取：SCOPE_Smem_Get 随机读取单个采样，SCOPE_Smem_Unpack 按块连续解包 (逐对解码，更快)。
+ * 3. 本模块还管理采样存储区，用 SCOPE_Smem_Claim 按使用者取得，同一区域的其它使用者的内容随之失效:
+ *    - 记录区 (SCOPE_SMEM_BYTES)：分段存储 (触发模式)、长记录 (滚动模式) 和频谱分析不会同时使用
+ *    - 工作区 (SCOPE_SMEM_WORK_BYTES)：各采集方式的中间结果，同一时刻只有一种采集方式，
+ *      可以与记录区的使用者同时存在 (例如峰值检测的分段存储)
+ */
+#ifndef __SCOPE_SMEM_H
+#define __SCOPE_SMEM_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 存储格式
+     */
+    typedef enum
+    {
+        SCOPE_SMEM_12BIT = 0, // 12 位打包 (两个采样三个字节)
+        SCOPE_SMEM_8BIT       // 8 位 (丢弃低 4 位)
+    } SCOPE_Smem_Format;
+
+    /**
+     * @brief 采样存储区的使用者
+     */
+    typedef enum
+    {
+        SCOPE_SMEM_FREE = 0, // 未使用
+        SCOPE_SMEM_SEGMENT,  // 分段存储
+        SCOPE_SMEM_LOG,      // 长记录
+        SCOPE_SMEM_FFT,      // 频谱分析
+        SCOPE_SMEM_ENVELOPE, // 峰值检测的包络最小值 (此项及之后的使用者在工作区)
+        SCOPE_SMEM_AVERAGE,  // 平均的累加器
+        SCOPE_SMEM_ETS,      // 等效时间采样的各列码值
+        SCOPE_SMEM_ROLL      // 滚动模式的列队列
+    } SCOPE_Smem_Owner;
+
+    /**
+     * @brief 顺序写入状态
+     */
+    typedef struct
+    {
+        uint8_t *dest;            // 下一个写入的字节
+        uint16_t pending;         // 12 位格式下等待配对的采样
+        uint8_t has_pending;      // pending 是否有效
+        SCOPE_Smem_Format format; // 存储格式
+    } SCOPE_Smem_Writer;
+
+    /**
+     * @brief  指定数量的采样占用的字节数
+     * @param  format  存储格式
+     * @param  samples 采样数
+     * @retval 字节数
+     */
+    static inline uint16_t SCOPE_Smem_Bytes(SCOPE_Smem_Format format, uint16_t samples)
+    {
+        return (format == SCOPE_SMEM_12BIT) ? (uint16_t)(((uint32_t)samples * 3 + 1) / 2) : samples;
+    }
+
+    /**
+     * @brief  开始顺序写入
+     * @param  w      写入状态
+     * @param  dest   目标
+     * @param  format 存储格式
+     * @retval 无
+     */
+    static inline void SCOPE_Smem_Writer_Init(SCOPE_Smem_Writer *w, uint8_t *dest, SCOPE_Smem_Format format)
+    {
+        w->dest = dest;
+        w->pending = 0;
+        w->has_pending = 0;
+        w->format = format;
+    }
+
+    /**
+     * @brief  写入一个采样
+     * @param  w    写入状态
+     * @param  code 12 位码值
+     * @retval 无
+     */
+    static inline void SCOPE_Smem_Put(SCOPE_Smem_Writer *w, uint16_t code)
+    {
+        if (w->format == SCOPE_SMEM_8BIT)
+        {
+            *w->dest++ = (uint8_t)(code >> 4);
+        }
+        else if (!w->has_pending)
+        {
+            w->pending = code;
+            w->has_pending = 1;
+        }
+        else
+        {
+            w->dest[0] = (uint8_t)w->pending;
+            w->dest[1] = (uint8_t)((w->pending >> 8) | (code << 4));
+            w->dest[2] = (uint8_t)(code >> 4);
+            w->dest += 3;
+            w->has_pending = 0;
+        }
+    }
+
+    /**
+     * @brief  结束顺序写入，采样数为奇数时写出最后半对
+     * @param  w 写入状态
+     * @retval 无
+     */
+    static inline void SCOPE_Smem_Flush(SCOPE_Smem_Writer *w)
+    {
+        if (w->has_pending)
+        {
+            w->dest[0] = (uint8_t)w->pending;
+            w->dest[1] = (uint8_t)(w->pending >> 8);
+            w->dest += 2;
+            w->has_pending = 0;
+        }
+    }
+
+    /**
+     * @brief  随机读取一个采样
+     * @param  src    打包数据
+     * @param  format 存储格式
+     * @param  index  采样序号
+     * @retval 12 位码值 (8 位格式补上低 4 位的中间值)
+     */
+    static inline uint16_t SCOPE_Smem_Get(const uint8_t *src, SCOPE_Smem_Format format, uint16_t index)
+    {
+        if (format == SCOPE_SMEM_8BIT)
+            return (uint16_t)((src[index] << 4) | 0x08);
+        const uint8_t *p = src + (uint32_t)(index >> 1) * 3;
+        if (index & 1)
+            return (uint16_t)((p[1] >> 4) | (p[2] << 4));
+        return (uint16_t)(p[0] | ((p[1] & 0x0F) << 8));
+    }
+
+    /**
+     * @brief  按块连续解包
+     * @param  src    打包数据
+     * @param  format 存储格式
+     * @param  first  第一个采样的序号
+     * @param  count  采样数
+     * @param  codes  输出：12 位码值
+     * @retval 无
+     */
+    void SCOPE_Smem_Unpack(const uint8_t *src, SCOPE_Smem_Format format, uint16_t first, uint16_t count, uint16_t *codes);
+
+    /**
+     * @brief  取得采样存储区
+     * @param  owner 新的使用者
+     * @retval 使用者所在的区域 (记录区 SCOPE_SMEM_BYTES 字节，工作区 SCOPE_SMEM_WORK_BYTES 字节，按字对齐)，
+     *         使用者改变时该区域原有的内容失效
+     */
+    uint8_t *SCOPE_Smem_Claim(SCOPE_Smem_Owner owner);
+
+    /**
+     * @brief  获取记录区当前的使用者
+     * @retval 使用者
+     */
+    SCOPE_Smem_Owner SCOPE_Smem_Get_Owner(void);
+
+    /**
+     * @brief  获取工作区当前的使用者
+     * @retval 使用者
+     */
+    SCOPE_Smem_Owner SCOPE_Smem_Get_Work_Owner(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
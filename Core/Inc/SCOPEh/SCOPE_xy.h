@@ -0,0 +1,67 @@
+/*
+ * @file    SCOPE_xy.h
+ * @brief   示波器 XY (李萨如) 显示头文件
+ * @details 冻结窗口中每个采样对 (CH1, CH2) 为一个点：CH1 为横坐标，CH2 为纵坐标，
+ *          两轴都按 SCOPE_GRID_SIZE 像素/格换算，点落在以屏幕中心为原点、
+ *          边长 SCOPE_XY_SIZE 的正方形内 (超出的点压在边上)。
+ *          点按纵坐标排序后交给条带渲染器，每一行用二分查找定位本行的点，
+ *          不需要逐点设置地址窗口，也不需要额外的缓冲区 (坐标直接存放在两个通道的波形数组中)。
+ *
+ * 使用说明:
+ * 1. 需要两个通道同时采集 (同步模式)，窗口冻结后调用 SCOPE_Xy_To_Screen。
+ * 2. 余辉打开时用 SCOPE_Persist_Accumulate_Points 累积点的密度。
+ */
+#ifndef __SCOPE_XY_H
+#define __SCOPE_XY_H
+
+#include "SCOPEh/SCOPE_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief XY 显示区域：边长与水平方向相同，垂直居中
+ */
+#define SCOPE_XY_SIZE (SCOPE_DIVS_X * SCOPE_GRID_SIZE)
+#define SCOPE_XY_TOP ((SCOPE_PLOT_HEIGHT - SCOPE_XY_SIZE) / 2)
+
+    /**
+     * @brief  把冻结窗口转换为按纵坐标排序的点
+     * @param  xs      输出：每个点的屏幕X坐标 (CH1)
+     * @param  ys      输出：每个点的屏幕Y坐标 (CH2)，从小到大
+     * @param  points  点数 (不超过 SCOPE_RECORD_LEN)
+     * @param  x_volts_per_div CH1 电压刻度 (V/div)
+     * @param  y_volts_per_div CH2 电压刻度 (V/div)
+     * @retval 1: 已输出，0: 窗口不是双通道同步采集 (不修改输出)
+     */
+    uint8_t SCOPE_Xy_To_Screen(uint16_t *xs, uint16_t *ys, uint16_t points, float x_volts_per_div, float y_volts_per_div);
+
+    /**
+     * @brief  查找纵坐标不小于 y 的第一个点
+     * @param  ys     按纵坐标排序的点
+     * @param  points 点数
+     * @param  y      纵坐标
+     * @retval 点的序号 (没有时为 points)
+     */
+    static inline uint16_t SCOPE_Xy_Lower_Bound(const uint16_t *ys, uint16_t points, uint16_t y)
+    {
+        uint16_t lo = 0, hi = points;
+        while (lo < hi)
+        {
+            uint16_t mid = (lo + hi) / 2;
+            if (ys[mid] < y)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -51,7 +51,15 @@
  * 例如htft1.buffer_size = 4096;   // 第一屏使用较大缓冲
  */
 
-#define TFT_BUFFER_SIZE 4096 // 2048 字节 (1024 像素, RGB565 格式)
+#define TFT_BUFFER_SIZE 2048 // 2048 字节 (1024 像素, RGB565 格式)
+
+/**
+ * @brief 多个屏幕共用一个发送缓冲区
+ *
+ * 为 1 时 TFT_IO_Init 复用已初始化设备的缓冲区 (不小于本设备的 buffer_size)，整个程序只分配一次。
+ * 写入共用的缓冲区前会先发送其它设备未发送的数据并等待其 DMA 完成，不同屏幕的传输不再重叠。
+ */
+#define TFT_SHARE_BUFFER 1
 
 /**
  * @brief 定义最大支持的 TFT 设备数量
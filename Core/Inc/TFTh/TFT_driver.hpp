@@ -0,0 +1,232 @@
+/*
+ * @file    TFT_driver.hpp
+ * @brief   编译期特化的 TFT 驱动模板 (可选，仅 C++)
+ * @details C 接口的 TFT_HandleTypeDef 在运行时保存方向、偏移和引脚端口，
+ *          每次 TFT_Set_Address 都要重新判断方向，引脚操作也要经过 HAL_GPIO_WritePin。
+ *          本头文件把控制器型号、屏幕尺寸、显示方向和引脚全部作为模板参数，
+ *          地址偏移和 MADCTL 在编译期算好，CS/DC 操作直接编译为对 BSRR/BRR 的常量写入，
+ *          SPI 数据直接写 DR 寄存器，适合大量单点/短线这类以开销为主的绘图操作。
+ *
+ * 使用说明:
+ * 1. 屏幕仍由 C 接口初始化 (TFT_Init_ST7789v3 等)，本驱动只接管之后的绘图传输。
+ * 2. 本驱动使用阻塞式寄存器访问，与 C 接口的 DMA 传输共用同一 SPI 时，
+ *    切换前需先调用 TFT_Flush_Buffer(htft, 1) 确保 DMA 已结束。
+ * 3. 示例 (与 main.c 中 TFT1 的配置一致):
+ *
+ *    using Scope = tft::Driver<tft::ST7789, 240, 320, 0, 0, 0,
+ *                              tft::Pin<GPIOB_BASE, TFT_CS_Pin>,
+ *                              tft::Pin<GPIOB_BASE, TFT_DC_Pin>,
+ *                              SPI1_BASE>;
+ *    Scope::begin();
+ *    Scope::draw_point(10, 20, YELLOW);
+ *
+ * 4. Tests/test_tft_driver.cpp 按 main.c 中两块屏幕的配置实例化本模板，make -C Tests 时随主机测试编译检查。
+ *
+ * C 接口 (TFT_CAD.h 等) 保持不变，不依赖本文件。
+ */
+#ifndef __TFT_DRIVER_HPP
+#define __TFT_DRIVER_HPP
+
+#ifdef __cplusplus
+
+#include "main.h"
+#include <stdint.h>
+
+namespace tft
+{
+
+    /**
+     * @brief  编译期引脚描述
+     * @tparam PortBase GPIO 端口基地址 (如 GPIOB_BASE)
+     * @tparam PinMask  引脚掩码 (如 GPIO_PIN_7)
+     * @note   high()/low() 各编译为一条对 BSRR/BRR 的常量写入，可在中断中安全使用。
+     */
+    template <uint32_t PortBase, uint16_t PinMask>
+    struct Pin
+    {
+        static inline GPIO_TypeDef *port() { return reinterpret_cast<GPIO_TypeDef *>(PortBase); }
+        static inline void high() { port()->BSRR = PinMask; }
+        static inline void low() { port()->BRR = PinMask; }
+        static inline void set(bool level) { port()->BSRR = level ? (uint32_t)PinMask : ((uint32_t)PinMask << 16); }
+    };
+
+    /**
+     * @brief  ST7789 控制器特性
+     * @note   MADCTL 表与 TFT_init.c 中 TFT_Set_Direction 一致
+     */
+    struct ST7789
+    {
+        static constexpr uint16_t memory_width = 240;  // 帧存储器列数
+        static constexpr uint16_t memory_height = 320; // 帧存储器行数
+        static constexpr uint8_t madctl(uint8_t direction)
+        {
+            return direction == 0 ? 0x00 : direction == 1 ? 0xA0 : direction == 2 ? 0xC0 : 0x60;
+        }
+    };
+
+    /**
+     * @brief  ST7735S 控制器特性
+     */
+    struct ST7735S
+    {
+        static constexpr uint16_t memory_width = 132;
+        static constexpr uint16_t memory_height = 162;
+        static constexpr uint8_t madctl(uint8_t direction)
+        {
+            return direction == 0 ? 0x00 : direction == 1 ? 0xA0 : direction == 2 ? 0xC0 : 0x60;
+        }
+    };
+
+    /**
+     * @brief  编译期特化的 TFT 驱动
+     * @tparam Controller 控制器特性 (ST7789 / ST7735S)
+     * @tparam Width      逻辑宽度 (当前方向下)
+     * @tparam Height     逻辑高度 (当前方向下)
+     * @tparam Direction  显示方向 0-3，含义同 TFT_Config_Display
+     * @tparam XOffset    X偏移量，含义同 TFT_Config_Display
+     * @tparam YOffset    Y偏移量，含义同 TFT_Config_Display
+     * @tparam CS         片选引脚 (tft::Pin)
+     * @tparam DC         数据/命令引脚 (tft::Pin)
+     * @tparam SpiBase    SPI 外设基地址 (如 SPI1_BASE)
+     */
+    template <class Controller, uint16_t Width, uint16_t Height, uint8_t Direction,
+              uint8_t XOffset, uint8_t YOffset, class CS, class DC, uint32_t SpiBase>
+    class Driver
+    {
+    public:
+        static constexpr uint16_t width = Width;
+        static constexpr uint16_t height = Height;
+
+        // 与 TFT_Set_Address 相同的偏移规则，但在编译期决定
+        static constexpr bool swap_xy = (Direction & 1) != 0;
+        static constexpr uint16_t column_offset = swap_xy ? YOffset : XOffset;
+        static constexpr uint16_t row_offset = swap_xy ? XOffset : YOffset;
+        static constexpr uint8_t madctl = Controller::madctl(Direction);
+
+        static_assert(Direction < 4, "Direction must be 0-3");
+        static_assert(Width + (swap_xy ? YOffset : XOffset) <= (swap_xy ? Controller::memory_height : Controller::memory_width),
+                      "Width exceeds controller memory");
+        static_assert(Height + (swap_xy ? XOffset : YOffset) <= (swap_xy ? Controller::memory_width : Controller::memory_height),
+                      "Height exceeds controller memory");
+
+        /**
+         * @brief  使能 SPI 并写入本方向的 MADCTL
+         * @note   HAL 只在第一次传输时才置位 SPE，直接访问寄存器前必须确保 SPI 已使能。
+         */
+        static void begin()
+        {
+            spi()->CR1 |= SPI_CR1_SPE;
+            CS::high();
+            command(0x36); // MADCTL
+            write8(madctl);
+            end();
+        }
+
+        /**
+         * @brief  设置 GRAM 访问窗口并发送写 GRAM 命令，之后保持片选有效
+         */
+        static void set_address(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end)
+        {
+            command(0x2A); // CASET
+            write16(x_start + column_offset);
+            write16(x_end + column_offset);
+            command(0x2B); // RASET
+            write16(y_start + row_offset);
+            write16(y_end + row_offset);
+            command(0x2C); // RAMWR
+        }
+
+        /**
+         * @brief  绘制一个点
+         */
+        static void draw_point(uint16_t x, uint16_t y, uint16_t color)
+        {
+            if (x >= Width || y >= Height)
+                return;
+            set_address(x, y, x, y);
+            write16(color);
+            end();
+        }
+
+        /**
+         * @brief  填充矩形区域 (x, y 为左上角，w, h 为宽高)
+         */
+        static void fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+        {
+            if (w == 0 || h == 0)
+                return;
+            set_address(x, y, x + w - 1, y + h - 1);
+            write_repeat(color, (uint32_t)w * h);
+            end();
+        }
+
+        static void draw_hline(uint16_t x, uint16_t y, uint16_t w, uint16_t color) { fill_rect(x, y, w, 1, color); }
+        static void draw_vline(uint16_t x, uint16_t y, uint16_t h, uint16_t color) { fill_rect(x, y, 1, h, color); }
+
+        /**
+         * @brief  发送 count 个相同颜色的像素 (需先调用 set_address)
+         */
+        static void write_repeat(uint16_t color, uint32_t count)
+        {
+            const uint8_t hi = color >> 8;
+            const uint8_t lo = color & 0xFF;
+            while (count--)
+            {
+                write8(hi);
+                write8(lo);
+            }
+        }
+
+        /**
+         * @brief  等待发送结束并释放片选
+         */
+        static void end()
+        {
+            wait_idle();
+            CS::high();
+        }
+
+    private:
+        static inline SPI_TypeDef *spi() { return reinterpret_cast<SPI_TypeDef *>(SpiBase); }
+
+        static inline void write8(uint8_t data)
+        {
+            while ((spi()->SR & SPI_SR_TXE) == 0)
+            {
+            }
+            *reinterpret_cast<volatile uint8_t *>(&spi()->DR) = data;
+        }
+
+        static inline void write16(uint16_t data)
+        {
+            write8(data >> 8); // 大端
+            write8(data & 0xFF);
+        }
+
+        static inline void wait_idle()
+        {
+            while ((spi()->SR & SPI_SR_TXE) == 0)
+            {
+            }
+            while (spi()->SR & SPI_SR_BSY)
+            {
+            }
+        }
+
+        // DC 只能在移位寄存器空闲时切换，否则会改变正在发送的字节的含义
+        static inline void command(uint8_t cmd)
+        {
+            wait_idle();
+            DC::low();
+            CS::low();
+            write8(cmd);
+            wait_idle();
+            DC::high();
+        }
+    };
+
+} // namespace tft
+
+#endif // __cplusplus
+
+#endif
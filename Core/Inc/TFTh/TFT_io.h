@@ -42,8 +42,28 @@ extern "C"
         uint8_t display_direction; // 显示方向
         uint8_t x_offset;          // X偏移量
         uint8_t y_offset;          // Y偏移量
+
+        // 预先计算的 BSRR 写入值，[0]=拉低 (高16位复位)，[1]=拉高 (低16位置位)
+        // 由 TFT_Init_Instance / TFT_Config_Pins 填写，引脚操作只需一次寄存器写入
+        uint32_t cs_bsrr[2]; // CS引脚
+        uint32_t dc_bsrr[2]; // DC引脚
     } TFT_HandleTypeDef;
 
+    /**
+     * @brief  逐行渲染回调函数类型，用于 TFT_Render_Bands
+     * @param  ctx    调用者传入的上下文指针
+     * @param  y      当前行的行坐标 (与 TFT_Render_Bands 的 y 参数同一坐标系)
+     * @param  row_be 行像素输出缓冲区，需写入 width 个像素，
+     *                每个像素为大端序 RGB565 (可用 TFT_COLOR_BE() 预先转换颜色)
+     * @retval 无
+     */
+    typedef void (*TFT_Row_Render_Func)(void *ctx, uint16_t y, uint16_t *row_be);
+
+/**
+ * @brief 将 RGB565 颜色转换为发送缓冲区中的大端字节序 (小端 MCU 上即交换高低字节)
+ */
+#define TFT_COLOR_BE(c) ((uint16_t)((((c) >> 8) & 0x00FF) | (((c) << 8) & 0xFF00)))
+
     //----------------- TFT 控制引脚函数声明 (硬件抽象) -----------------
 
     /**
@@ -101,6 +121,7 @@ extern "C"
      * @param  bl_port: BL引脚端口
      * @param  bl_pin: BL引脚号
      * @note   必须手动配置 GPIO 引脚模式和速度。否则无法显示。
+     *         同时预先计算 CS/DC 的 BSRR 写入值，之后的引脚切换不再经过 HAL_GPIO_WritePin。
      */
     void TFT_Config_Pins(TFT_HandleTypeDef *htft,
                          GPIO_TypeDef *dc_port, uint16_t dc_pin,
@@ -200,6 +221,23 @@ extern "C"
      */
     void TFT_Set_Address(TFT_HandleTypeDef *htft, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end);
 
+    /**
+     * @brief  分条带渲染一个矩形区域 (双缓冲)
+     * @param  htft   TFT句柄指针
+     * @param  x      区域左上角列坐标
+     * @param  y      区域左上角行坐标
+     * @param  width  区域宽度
+     * @param  height 区域高度
+     * @param  render 逐行渲染回调
+     * @param  ctx    传给回调的上下文指针
+     * @retval 无
+     * @note   整个区域只设置一次地址窗口。发送缓冲区被分为两半，一半通过 DMA 发送时，
+     *         回调在另一半中渲染下一条带，渲染与传输并行且不会改写正在发送的数据。
+     *         要求一行像素 (width * 2 字节) 不超过缓冲区的一半。函数返回时传输已完成。
+     */
+    void TFT_Render_Bands(TFT_HandleTypeDef *htft, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                          TFT_Row_Render_Func render, void *ctx);
+
     //----------------- 平台相关的 SPI 传输函数声明 (内部使用) -----------------
 
     /**
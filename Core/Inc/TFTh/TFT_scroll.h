@@ -0,0 +1,94 @@
+/*
+ * @file    TFT_scroll.h
+ * @brief   TFT硬件垂直滚动函数头文件
+ * @details 封装 ST7789/ST7735 的 VSCRDEF (0x33) / VSCSAD (0x37) 硬件滚动寄存器，
+ *          并提供"滚动条带"(Roll) 辅助接口：每次只写入一行新像素，再移动滚动起始行，
+ *          即可让整屏内容沿滚动轴平移，适合示波器慢时基下的滚动显示。
+ */
+#ifndef __TFT_SCROLL_H
+#define __TFT_SCROLL_H
+
+#include "main.h"
+#include "TFTh/TFT_io.h" // 包含TFT_io.h以获取TFT_HandleTypeDef结构体定义
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief  滚动条带句柄
+     * @note   硬件滚动总是沿帧存储器的"行"方向进行，与 MADCTL 的旋转设置无关。
+     *         因此屏幕上的滚动轴取决于显示方向：
+     *         - 方向 0/2 (MV=0): 滚动轴为屏幕 Y，每一"行"是一条水平像素线
+     *         - 方向 1/3 (MV=1): 滚动轴为屏幕 X，每一"行"是一条垂直像素线
+     */
+    typedef struct
+    {
+        TFT_HandleTypeDef *htft; // 所属TFT句柄
+        uint16_t lines;          // 滚动轴方向的行数 (即帧存储器行数，ST7789为320)
+        uint16_t depth;          // 每行像素数 (垂直于滚动轴)
+        uint16_t head;           // 下一次写入的帧存储器行
+        uint8_t along_x;         // 1: 滚动轴为屏幕X (MV=1)，0: 滚动轴为屏幕Y
+        uint8_t reversed;        // 1: 逻辑坐标与帧存储器行方向相反 (MY=1)
+    } TFT_Roll;
+
+    /**
+     * @brief  设置垂直滚动区域 (VSCRDEF, 0x33)
+     * @param  htft TFT句柄指针
+     * @param  top_fixed    顶部固定区域行数
+     * @param  scroll_lines 滚动区域行数
+     * @param  bottom_fixed 底部固定区域行数
+     * @retval 无
+     * @note   三者之和必须等于控制器帧存储器的行数 (ST7789 为 320, ST7735S 为 162)。
+     */
+    void TFT_Set_Scroll_Area(TFT_HandleTypeDef *htft, uint16_t top_fixed, uint16_t scroll_lines, uint16_t bottom_fixed);
+
+    /**
+     * @brief  设置垂直滚动起始地址 (VSCSAD, 0x37)
+     * @param  htft TFT句柄指针
+     * @param  line 显示在滚动区域第一行的帧存储器行号
+     * @retval 无
+     */
+    void TFT_Set_Scroll_Start(TFT_HandleTypeDef *htft, uint16_t line);
+
+    /**
+     * @brief  初始化滚动条带，并把整个帧存储器设为滚动区域
+     * @param  roll  滚动条带句柄
+     * @param  htft  TFT句柄指针 (需已完成初始化，方向取自 htft->display_direction)
+     * @param  lines 滚动轴方向的行数
+     * @param  depth 每行像素数
+     * @retval 无
+     */
+    void TFT_Roll_Init(TFT_Roll *roll, TFT_HandleTypeDef *htft, uint16_t lines, uint16_t depth);
+
+    /**
+     * @brief  开始写入新的一行
+     * @param  roll 滚动条带句柄
+     * @retval 该行在滚动轴上的逻辑坐标 (即 Set_Address 使用的坐标)
+     * @note   调用后地址窗口已设为该行，调用者需紧接着用 TFT_Buffer_Write16 写入 depth 个像素，
+     *         然后调用 TFT_Roll_End_Line()。像素顺序为逻辑坐标递增方向。
+     */
+    uint16_t TFT_Roll_Begin_Line(TFT_Roll *roll);
+
+    /**
+     * @brief  结束当前行：刷新缓冲区并移动滚动起始行，使新行出现在滚动方向的末端
+     * @param  roll 滚动条带句柄
+     * @retval 无
+     */
+    void TFT_Roll_End_Line(TFT_Roll *roll);
+
+    /**
+     * @brief  退出滚动显示，恢复滚动起始行为 0
+     * @param  roll 滚动条带句柄
+     * @retval 无
+     * @note   恢复后屏幕内容仍是错位的，调用者通常需要随后重绘整屏。
+     */
+    void TFT_Roll_Reset(TFT_Roll *roll);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
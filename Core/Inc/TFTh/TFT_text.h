@@ -41,7 +41,7 @@ extern "C"
      * @param  mode       模式 (0: 背景不透明, 1: 背景透明)
      * @retval 无
      */
-    void TFT_Show_String(TFT_HandleTypeDef *htft, uint16_t x, uint16_t y, const uint8_t *str, uint16_t color, uint16_t back_color, uint8_t size, uint8_t mode);
+    void TFT_Show_String(TFT_HandleTypeDef *htft, uint16_t x, uint16_t y, const char *str, uint16_t color, uint16_t back_color, uint8_t size, uint8_t mode);
 
 #ifdef __cplusplus
 }
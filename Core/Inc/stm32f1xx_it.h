@@ -59,6 +59,9 @@ void DMA1_Channel3_IRQHandler(void);
 void DMA1_Channel5_IRQHandler(void);
 void USART1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Channel1_IRQHandler(void);
+void ADC1_2_IRQHandler(void);
+void TIM1_UP_IRQHandler(void);
 
 /* USER CODE END EFP */
 
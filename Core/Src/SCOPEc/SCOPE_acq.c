@@ -0,0 +1,714 @@
+/**
+ * @file    SCOPE_acq.c
+ * @brief   示波器采集引擎实现
+ * @details STM32 HAL 未包含 ADC/TIM 模块，外设按寄存器直接配置：
+ *          - ADC1/ADC2: 双 ADC 模式 (同步或快速交替)，ADC1 为主，ADC2 为从
+ *          - TIM3: 更新事件作为 TRGO，PSC/ARR 由采样率计算 (仅同步模式使用)
+ *          - DMA1 通道1: 外设 ADC1->DR 到内存，32 位，循环模式，半传输/传输完成中断
+ *          - TIM2/TIM4: 级联为 32 位 1MHz 自由计数器，作为分段采集的时间戳
+ *          SCOPE_ACQ_SIM 为 1 时以上全部替换为合成信号发生器，数据块回调保持不变。
+ */
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if !SCOPE_ACQ_SIM
+#include "main.h"
+#endif
+
+static SCOPE_Block_Func acq_block_handler = NULL;         // 数据块回调
+static float acq_sample_rate = 1000.0f;                   // 当前实际采样率 (Hz，每通道)
+static float acq_requested_rate = 1000.0f;                // 期望采样率 (Hz)，通道切换时重新评估
+static SCOPE_Acq_Mode acq_mode = SCOPE_ACQ_SIMULTANEOUS; // 当前采集模式
+static uint8_t acq_ch1_enabled = 1;                       // 通道1使能
+static uint8_t acq_ch2_enabled = 1;                       // 通道2使能
+static uint8_t acq_running = 0;                           // 是否正在采集
+static SCOPE_Watchdog_Func acq_watchdog_handler = NULL;  // 模拟看门狗回调
+static uint8_t acq_awd_channel = 0;                       // 看门狗监视的通道
+static uint16_t acq_awd_low = 0;                          // 看门狗窗口下限
+static uint16_t acq_awd_high = SCOPE_ADC_FULL_SCALE - 1;  // 看门狗窗口上限
+
+static void SCOPE_Acq_Apply_Mode(SCOPE_Acq_Mode mode); // 切换采集模式 (平台相关)
+static float SCOPE_Acq_Apply_Rate(float rate);         // 设置同步模式采样率 (平台相关)
+
+/**
+ * @brief  注册数据块回调
+ * @param  handler 回调函数，NULL 表示丢弃数据
+ * @retval 无
+ */
+void SCOPE_Acq_Set_Block_Handler(SCOPE_Block_Func handler)
+{
+	acq_block_handler = handler;
+}
+
+/**
+ * @brief  注册模拟看门狗回调
+ * @param  handler 回调函数，NULL 表示不使用看门狗
+ * @retval 无
+ */
+void SCOPE_Acq_Set_Watchdog_Handler(SCOPE_Watchdog_Func handler)
+{
+	acq_watchdog_handler = handler;
+	if (handler == NULL)
+		SCOPE_Acq_Watchdog_Disarm();
+}
+
+/**
+ * @brief  获取当前实际采样率
+ * @retval 每通道采样率 (Hz)
+ */
+float SCOPE_Acq_Get_Sample_Rate(void)
+{
+	return acq_sample_rate;
+}
+
+/**
+ * @brief  获取当前采集模式
+ * @retval 采集模式
+ */
+SCOPE_Acq_Mode SCOPE_Acq_Get_Mode(void)
+{
+	return acq_mode;
+}
+
+/**
+ * @brief  根据时基计算采样率
+ * @param  time_base 时基 (ms/div)
+ * @retval 采样率 (Hz)
+ * @note   一屏时间为 SCOPE_DIVS_X * time_base 毫秒，采集 SCOPE_RECORD_LEN 个采样
+ */
+float SCOPE_Acq_Rate_For_Time_Base(float time_base)
+{
+	if (time_base <= 0)
+		return SCOPE_ACQ_INTERLEAVED_RATE;
+	return SCOPE_RECORD_LEN * 1000.0f / (SCOPE_DIVS_X * time_base);
+}
+
+/**
+ * @brief  设置通道使能，并据此重新选择采集模式
+ * @param  ch1_enabled 通道1是否打开
+ * @param  ch2_enabled 通道2是否打开
+ * @retval 无
+ */
+void SCOPE_Acq_Set_Channels(uint8_t ch1_enabled, uint8_t ch2_enabled)
+{
+	acq_ch1_enabled = ch1_enabled ? 1 : 0;
+	acq_ch2_enabled = ch2_enabled ? 1 : 0;
+	SCOPE_Acq_Set_Sample_Rate(acq_requested_rate);
+}
+
+/**
+ * @brief  设置每通道采样率，并据此重新选择采集模式
+ * @param  rate 期望采样率 (Hz)
+ * @retval 实际采样率 (Hz)
+ * @note   只有单通道且同步模式达不到期望采样率时才使用快速交替模式，
+ *         两个通道都关闭时仍按同步模式采集，以便随时打开通道。
+ */
+float SCOPE_Acq_Set_Sample_Rate(float rate)
+{
+	SCOPE_Acq_Mode mode = SCOPE_ACQ_SIMULTANEOUS;
+
+	acq_requested_rate = rate;
+	if (rate > SCOPE_ACQ_MAX_RATE && acq_ch1_enabled != acq_ch2_enabled)
+		mode = acq_ch1_enabled ? SCOPE_ACQ_INTERLEAVED_CH1 : SCOPE_ACQ_INTERLEAVED_CH2;
+
+	if (mode != acq_mode)
+		SCOPE_Acq_Apply_Mode(mode);
+
+	if (mode == SCOPE_ACQ_SIMULTANEOUS)
+	{
+		if (rate > SCOPE_ACQ_MAX_RATE)
+			rate = SCOPE_ACQ_MAX_RATE;
+		if (rate < 1.0f)
+			rate = 1.0f;
+		acq_sample_rate = SCOPE_Acq_Apply_Rate(rate);
+	}
+	else
+	{
+		acq_sample_rate = SCOPE_ACQ_INTERLEAVED_RATE; // 连续转换，速率由 ADC 时钟决定
+	}
+	return acq_sample_rate;
+}
+
+#if !SCOPE_ACQ_SIM
+
+static uint32_t acq_dma_buffer[SCOPE_ACQ_DMA_WORDS]; // DMA 循环缓冲区 (ADC1 | ADC2 << 16)
+static uint32_t acq_adc1_cr2 = 0;                    // 当前模式下 ADC1 运行时的 CR2
+static uint32_t acq_adc2_cr2 = 0;                    // 当前模式下 ADC2 运行时的 CR2
+
+// 看门狗相关的 CR1 位：规则通道看门狗、单通道模式、监视的通道号
+#define SCOPE_ACQ_AWD_CR1_MASK (ADC_CR1_AWDEN | ADC_CR1_AWDSGL | ADC_CR1_AWDCH | ADC_CR1_AWDIE)
+
+/**
+ * @brief  写入 ADC 的 CR2
+ * @param  adc ADC1 或 ADC2
+ * @param  cr2 新的 CR2 值
+ * @retval 无
+ * @note   ADON 已置位时再次写入 ADON=1 且其他位不变会启动一次软件转换，
+ *         在 DMA 数据流中插入一个额外的字，因此值未变化时不写入。
+ */
+static inline void SCOPE_Acq_Write_CR2(ADC_TypeDef *adc, uint32_t cr2)
+{
+	if (adc->CR2 != cr2)
+		adc->CR2 = cr2;
+}
+
+/**
+ * @brief  ADC 上电并自校准
+ * @param  adc ADC1 或 ADC2
+ * @retval 无
+ */
+static void SCOPE_Acq_Calibrate(ADC_TypeDef *adc)
+{
+	adc->CR2 = ADC_CR2_ADON;
+	for (volatile uint32_t i = 0; i < 72; i++) // 上电稳定时间 tSTAB (约 1us)
+	{
+	}
+	adc->CR2 |= ADC_CR2_RSTCAL;
+	while (adc->CR2 & ADC_CR2_RSTCAL)
+	{
+	}
+	adc->CR2 |= ADC_CR2_CAL;
+	while (adc->CR2 & ADC_CR2_CAL)
+	{
+	}
+}
+
+/**
+ * @brief  切换采集模式
+ * @param  mode 新的采集模式
+ * @retval 无
+ * @note   双 ADC 模式位只能在两个 ADC 都断电时修改，因此先断电、重新配置，
+ *         再上电校准。正在采集时自动重新启动。
+ */
+static void SCOPE_Acq_Apply_Mode(SCOPE_Acq_Mode mode)
+{
+	uint8_t running = acq_running;
+	uint32_t awd_irq = ADC1->CR1 & ADC_CR1_AWDIE;
+	if (running)
+		SCOPE_Acq_Stop();
+
+	ADC1->CR2 = 0;
+	ADC2->CR2 = 0;
+
+	if (mode == SCOPE_ACQ_SIMULTANEOUS)
+	{
+		// 规则同步：ADC1 转换 IN0 (CH1)，ADC2 同时转换 IN1 (CH2)，采样 7.5 周期
+		ADC1->CR1 = ADC_CR1_DUALMOD_2 | ADC_CR1_DUALMOD_1;
+		ADC1->SMPR2 = ADC2->SMPR2 = (1U << ADC_SMPR2_SMP0_Pos) | (1U << ADC_SMPR2_SMP1_Pos);
+		ADC1->SQR3 = 0U << ADC_SQR3_SQ1_Pos;
+		ADC2->SQR3 = 1U << ADC_SQR3_SQ1_Pos;
+		// ADC1 由 TIM3 TRGO 触发 (EXTSEL = 100)，ADC2 随 ADC1 启动，外部触发设为软件启动
+		acq_adc1_cr2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_EXTTRIG | ADC_CR2_EXTSEL_2;
+		acq_adc2_cr2 = ADC_CR2_ADON | ADC_CR2_EXTTRIG | ADC_CR2_EXTSEL;
+	}
+	else
+	{
+		// 快速交替：两个 ADC 连续转换同一通道，采样时间必须小于 7 个周期 (1.5 周期)
+		uint32_t channel = (mode == SCOPE_ACQ_INTERLEAVED_CH1) ? 0U : 1U;
+		ADC1->CR1 = ADC_CR1_DUALMOD_2 | ADC_CR1_DUALMOD_1 | ADC_CR1_DUALMOD_0;
+		ADC1->SMPR2 = ADC2->SMPR2 = 0;
+		ADC1->SQR3 = ADC2->SQR3 = channel << ADC_SQR3_SQ1_Pos;
+		acq_adc1_cr2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_CONT | ADC_CR2_EXTTRIG | ADC_CR2_EXTSEL;
+		acq_adc2_cr2 = ADC_CR2_ADON | ADC_CR2_CONT | ADC_CR2_EXTTRIG | ADC_CR2_EXTSEL;
+	}
+	ADC2->CR1 = 0;
+	ADC1->SQR1 = ADC2->SQR1 = 0; // 规则序列长度 1
+	// CR1 已被改写，恢复看门狗设置和中断使能
+	SCOPE_Acq_Watchdog_Config(acq_awd_channel, acq_awd_low, acq_awd_high);
+	ADC1->CR1 |= awd_irq;
+	ADC2->CR1 |= awd_irq;
+
+	SCOPE_Acq_Calibrate(ADC2);
+	SCOPE_Acq_Calibrate(ADC1);
+	acq_mode = mode;
+
+	if (running)
+		SCOPE_Acq_Start();
+}
+
+/**
+ * @brief  初始化采集外设 (GPIO、ADC1、ADC2、TIM3、DMA1 通道1)
+ * @retval 无
+ */
+void SCOPE_Acq_Init(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_ADC1_CLK_ENABLE();
+	__HAL_RCC_ADC2_CLK_ENABLE();
+	__HAL_RCC_TIM3_CLK_ENABLE();
+	__HAL_RCC_TIM2_CLK_ENABLE();
+	__HAL_RCC_TIM4_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	__HAL_RCC_ADC_CONFIG(RCC_ADCPCLK2_DIV6); // 72MHz / 6 = 12MHz (ADC 时钟上限 14MHz)
+
+	// PA0 / PA1 模拟输入
+	GPIO_InitStruct.Pin = GPIO_PIN_0 | GPIO_PIN_1;
+	GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+	// TIM3: 更新事件输出到 TRGO
+	TIM3->CR1 = 0;
+	TIM3->CR2 = TIM_CR2_MMS_1;
+
+	// 时间戳：TIM2 以 1MHz 计数，溢出 (更新事件) 经 TRGO/ITR1 驱动 TIM4 计数，合成 32 位微秒计数
+	uint32_t tim_clk = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+		tim_clk *= 2;
+	TIM2->CR1 = 0;
+	TIM2->CR2 = TIM_CR2_MMS_1;
+	TIM2->PSC = tim_clk / 1000000 - 1;
+	TIM2->ARR = 0xFFFF;
+	TIM2->EGR = TIM_EGR_UG;
+	TIM4->CR1 = 0;
+	TIM4->PSC = 0;
+	TIM4->ARR = 0xFFFF;
+	TIM4->SMCR = TIM_SMCR_TS_0 | TIM_SMCR_SMS; // 触发源 ITR1 (TIM2)，外部时钟模式1
+	TIM4->CR1 = TIM_CR1_CEN;
+	TIM4->CNT = 0;
+	TIM2->CNT = 0;
+	TIM2->CR1 = TIM_CR1_CEN;
+
+	// DMA1 通道1: ADC1->DR (含 ADC2 数据) -> acq_dma_buffer，32 位，循环
+	DMA1_Channel1->CCR = 0;
+	DMA1_Channel1->CPAR = (uint32_t)&ADC1->DR;
+	DMA1_Channel1->CMAR = (uint32_t)acq_dma_buffer;
+	DMA1_Channel1->CNDTR = SCOPE_ACQ_DMA_WORDS;
+	DMA1_Channel1->CCR = DMA_CCR_PL_1 | DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 |
+						 DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE;
+
+	// 优先级低于 SPI DMA 和串口，数据块处理不会推迟屏幕传输
+	HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+	HAL_NVIC_SetPriority(ADC1_2_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(ADC1_2_IRQn);
+
+	acq_running = 0;
+	SCOPE_Acq_Apply_Mode(SCOPE_ACQ_SIMULTANEOUS);
+	SCOPE_Acq_Set_Sample_Rate(acq_requested_rate);
+}
+
+/**
+ * @brief  设置同步模式的触发定时器
+ * @param  rate 期望采样率 (Hz)
+ * @retval 实际采样率 (Hz)
+ * @note   TIM3 挂在 APB1 上，APB1 分频不为 1 时定时器时钟为 PCLK1 的 2 倍。
+ *         先取最小的预分频使 ARR 不超过 16 位，以获得最细的采样率分辨率。
+ */
+static float SCOPE_Acq_Apply_Rate(float rate)
+{
+	uint32_t tim_clk = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+		tim_clk *= 2;
+
+	uint32_t ticks = (uint32_t)(tim_clk / rate + 0.5f);
+	uint32_t psc = (ticks - 1) / 65536;
+	uint32_t arr = ticks / (psc + 1) - 1;
+
+	TIM3->PSC = psc;
+	TIM3->ARR = arr;
+	TIM3->EGR = TIM_EGR_UG; // 立即装载新的分频值
+
+	return (float)tim_clk / ((psc + 1) * (arr + 1));
+}
+
+/**
+ * @brief  开始采集
+ * @retval 无
+ * @note   每次启动都从缓冲区起点写入。同步模式由 TIM3 触发，
+ *         快速交替模式写入 SWSTART 后两个 ADC 连续转换。
+ */
+void SCOPE_Acq_Start(void)
+{
+	DMA1_Channel1->CCR &= ~DMA_CCR_EN;
+	DMA1->IFCR = DMA_IFCR_CGIF1;
+	DMA1_Channel1->CNDTR = SCOPE_ACQ_DMA_WORDS;
+	DMA1_Channel1->CCR |= DMA_CCR_EN;
+
+	SCOPE_Acq_Write_CR2(ADC2, acq_adc2_cr2);
+	SCOPE_Acq_Write_CR2(ADC1, acq_adc1_cr2);
+	acq_running = 1;
+
+	if (acq_mode == SCOPE_ACQ_SIMULTANEOUS)
+	{
+		TIM3->CNT = 0;
+		TIM3->CR1 |= TIM_CR1_CEN;
+	}
+	else
+	{
+		ADC1->CR2 = acq_adc1_cr2 | ADC_CR2_SWSTART;
+	}
+}
+
+/**
+ * @brief  停止采集
+ * @retval 无
+ * @note   快速交替模式清除 CONT 后两个 ADC 在当前转换结束时停止
+ */
+void SCOPE_Acq_Stop(void)
+{
+	TIM3->CR1 &= ~TIM_CR1_CEN;
+	SCOPE_Acq_Write_CR2(ADC1, acq_adc1_cr2 & ~ADC_CR2_CONT);
+	SCOPE_Acq_Write_CR2(ADC2, acq_adc2_cr2 & ~ADC_CR2_CONT);
+	DMA1_Channel1->CCR &= ~DMA_CCR_EN;
+	acq_running = 0;
+}
+
+/**
+ * @brief  DMA1 通道1 中断处理
+ * @retval 无
+ * @note   半传输时前半个缓冲区已写满，传输完成时后半个缓冲区已写满，
+ *         DMA 此时正在写另一半，回调处理期间两者互不干扰。
+ */
+void SCOPE_Acq_DMA_IRQHandler(void)
+{
+	uint32_t isr = DMA1->ISR;
+	const uint16_t half = SCOPE_ACQ_DMA_WORDS / 2;
+
+	if (isr & DMA_ISR_HTIF1)
+	{
+		DMA1->IFCR = DMA_IFCR_CHTIF1;
+		if (acq_block_handler != NULL)
+			acq_block_handler(&acq_dma_buffer[0], half, acq_mode);
+	}
+	if (isr & DMA_ISR_TCIF1)
+	{
+		DMA1->IFCR = DMA_IFCR_CTCIF1;
+		if (acq_block_handler != NULL)
+			acq_block_handler(&acq_dma_buffer[half], half, acq_mode);
+	}
+	if (isr & DMA_ISR_TEIF1)
+	{
+		DMA1->IFCR = DMA_IFCR_CGIF1; // 传输错误时 DMA 已自动关闭，需要重新启动采集
+	}
+}
+
+/**
+ * @brief  读取 32 位微秒时间戳
+ * @retval 时间戳 (us)
+ * @note   高16位在两次读取之间变化时说明低16位刚好溢出，重新读取
+ */
+uint32_t SCOPE_Acq_Timestamp(void)
+{
+	uint16_t high, low;
+	do
+	{
+		high = (uint16_t)TIM4->CNT;
+		low = (uint16_t)TIM2->CNT;
+	} while (high != (uint16_t)TIM4->CNT);
+	return ((uint32_t)high << 16) | low;
+}
+
+/**
+ * @brief  设置模拟看门狗的监视通道和窗口
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  low     窗口下限 (码值)
+ * @param  high    窗口上限 (码值)
+ * @retval 无
+ * @note   只修改看门狗相关的位，保留 CR1 中的双 ADC 模式和中断使能
+ */
+void SCOPE_Acq_Watchdog_Config(uint8_t channel, uint16_t low, uint16_t high)
+{
+	acq_awd_channel = channel;
+	acq_awd_low = low;
+	acq_awd_high = high;
+
+	ADC1->LTR = ADC2->LTR = low;
+	ADC1->HTR = ADC2->HTR = high;
+	uint32_t bits = ADC_CR1_AWDEN | ADC_CR1_AWDSGL | ((uint32_t)channel << ADC_CR1_AWDCH_Pos);
+	ADC1->CR1 = (ADC1->CR1 & ~(SCOPE_ACQ_AWD_CR1_MASK & ~ADC_CR1_AWDIE)) | bits;
+	ADC2->CR1 = (ADC2->CR1 & ~(SCOPE_ACQ_AWD_CR1_MASK & ~ADC_CR1_AWDIE)) | bits;
+}
+
+/**
+ * @brief  清除看门狗标志并打开看门狗中断
+ * @retval 无
+ */
+void SCOPE_Acq_Watchdog_Arm(void)
+{
+	if (acq_watchdog_handler == NULL)
+		return;
+	ADC1->SR = ~ADC_SR_AWD; // 写 0 清除
+	ADC2->SR = ~ADC_SR_AWD;
+	ADC1->CR1 |= ADC_CR1_AWDIE;
+	ADC2->CR1 |= ADC_CR1_AWDIE;
+}
+
+/**
+ * @brief  关闭看门狗中断
+ * @retval 无
+ */
+void SCOPE_Acq_Watchdog_Disarm(void)
+{
+	ADC1->CR1 &= ~ADC_CR1_AWDIE;
+	ADC2->CR1 &= ~ADC_CR1_AWDIE;
+}
+
+/**
+ * @brief  ADC1/ADC2 全局中断处理 (模拟看门狗)
+ * @retval 无
+ * @note   看门狗在每个越界的采样上都会置位，先关闭中断再调用回调，
+ *         避免信号停留在窗口外时每次转换都进入中断。
+ */
+void SCOPE_Acq_ADC_IRQHandler(void)
+{
+	if ((ADC1->SR | ADC2->SR) & ADC_SR_AWD)
+	{
+		SCOPE_Acq_Watchdog_Disarm();
+		ADC1->SR = ~ADC_SR_AWD;
+		ADC2->SR = ~ADC_SR_AWD;
+		if (acq_watchdog_handler != NULL)
+			acq_watchdog_handler();
+	}
+}
+
+#else // SCOPE_ACQ_SIM
+
+#include <math.h>
+
+static uint32_t sim_block[SCOPE_ACQ_DMA_WORDS / 2]; // 合成数据块 (半个 DMA 缓冲区)
+static uint32_t sim_tick = 0;                        // 上一次生成数据的时刻 (ms)
+static float sim_pending = 0.0f;                     // 尚未生成的字数 (含小数部分)
+static float sim_phase1 = 0.0f;                      // CH1 相位 (周期，0 ~ 1)
+static float sim_phase2 = 0.0f;                      // CH2 相位 (周期，0 ~ 1)
+static uint32_t sim_noise_seed = 1;                  // 噪声发生器状态
+static uint8_t sim_awd_armed = 0;                    // 模拟的看门狗中断使能
+static uint32_t sim_time_us = 0;                     // 已生成数据对应的时间 (us)，作为时间戳
+static float sim_hz[2] = {SCOPE_ACQ_SIM_CH1_HZ, SCOPE_ACQ_SIM_CH2_HZ}; // 各通道信号频率
+
+/**
+ * @brief  合成信号没有外设，模式只影响数据打包方式
+ */
+static void SCOPE_Acq_Apply_Mode(SCOPE_Acq_Mode mode)
+{
+	acq_mode = mode;
+}
+
+/**
+ * @brief  合成信号不受定时器量化
+ */
+static float SCOPE_Acq_Apply_Rate(float rate)
+{
+	return rate;
+}
+
+/**
+ * @brief  初始化合成信号发生器
+ * @retval 无
+ */
+void SCOPE_Acq_Init(void)
+{
+	acq_running = 0;
+	sim_phase1 = sim_phase2 = 0.0f;
+	sim_noise_seed = 1; // 每次初始化后的合成信号相同，可重现
+	SCOPE_Acq_Set_Sample_Rate(acq_requested_rate);
+}
+
+/**
+ * @brief  开始采集
+ * @retval 无
+ */
+void SCOPE_Acq_Start(void)
+{
+	acq_running = 1;
+	sim_pending = 0.0f;
+	sim_tick = 0xFFFFFFFF; // 下一次 Pump 时以当时时刻为起点
+}
+
+/**
+ * @brief  停止采集
+ * @retval 无
+ */
+void SCOPE_Acq_Stop(void)
+{
+	acq_running = 0;
+}
+
+/**
+ * @brief  合成信号没有 DMA，保留空实现以便中断向量表保持一致
+ * @retval 无
+ */
+void SCOPE_Acq_DMA_IRQHandler(void)
+{
+}
+
+/**
+ * @brief  设置模拟看门狗的监视通道和窗口
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  low     窗口下限 (码值)
+ * @param  high    窗口上限 (码值)
+ * @retval 无
+ */
+void SCOPE_Acq_Watchdog_Config(uint8_t channel, uint16_t low, uint16_t high)
+{
+	acq_awd_channel = channel;
+	acq_awd_low = low;
+	acq_awd_high = high;
+}
+
+/**
+ * @brief  打开模拟的看门狗中断
+ * @retval 无
+ */
+void SCOPE_Acq_Watchdog_Arm(void)
+{
+	sim_awd_armed = (acq_watchdog_handler != NULL);
+}
+
+/**
+ * @brief  关闭模拟的看门狗中断
+ * @retval 无
+ */
+void SCOPE_Acq_Watchdog_Disarm(void)
+{
+	sim_awd_armed = 0;
+}
+
+/**
+ * @brief  合成信号没有 ADC 中断，保留空实现以便中断向量表保持一致
+ * @retval 无
+ */
+void SCOPE_Acq_ADC_IRQHandler(void)
+{
+}
+
+/**
+ * @brief  读取 32 位微秒时间戳
+ * @retval 已生成数据对应的时间 (us)，按数据块递增
+ */
+uint32_t SCOPE_Acq_Timestamp(void)
+{
+	return sim_time_us;
+}
+
+/**
+ * @brief  对一个刚"转换"完成的采样执行看门狗比较，与硬件一样越界时关闭中断并调用回调
+ * @param  channel 采样所属通道
+ * @param  code    采样码值
+ * @retval 无
+ */
+static void SCOPE_Sim_Watchdog(uint8_t channel, uint16_t code)
+{
+	if (sim_awd_armed && channel == acq_awd_channel && (code > acq_awd_high || code < acq_awd_low))
+	{
+		sim_awd_armed = 0;
+		if (acq_watchdog_handler != NULL)
+			acq_watchdog_handler();
+	}
+}
+
+/**
+ * @brief  生成 [-SCOPE_ACQ_SIM_NOISE, SCOPE_ACQ_SIM_NOISE] 的噪声
+ * @retval 噪声码值
+ */
+static int32_t SCOPE_Sim_Noise(void)
+{
+	if (SCOPE_ACQ_SIM_NOISE == 0)
+		return 0;
+	sim_noise_seed = sim_noise_seed * 1103515245U + 12345U;
+	return (int32_t)((sim_noise_seed >> 16) % (2 * SCOPE_ACQ_SIM_NOISE + 1)) - SCOPE_ACQ_SIM_NOISE;
+}
+
+/**
+ * @brief  生成一个通道的下一个采样并推进相位
+ * @param  channel 通道 (0: CH1 正弦波，1: CH2 方波)
+ * @retval 12 位码值
+ */
+static uint16_t SCOPE_Sim_Next(uint8_t channel)
+{
+	int32_t code;
+
+	if (channel == 0)
+	{
+		code = SCOPE_ADC_ZERO_CODE + (int32_t)(SCOPE_ACQ_SIM_CH1_VOLTS * SCOPE_CODES_PER_VOLT * sinf(2 * 3.14159265f * sim_phase1));
+		sim_phase1 += sim_hz[0] / acq_sample_rate;
+		if (sim_phase1 >= 1.0f)
+			sim_phase1 -= (float)(int32_t)sim_phase1;
+	}
+	else
+	{
+		int32_t amp = (int32_t)(SCOPE_ACQ_SIM_CH2_VOLTS * SCOPE_CODES_PER_VOLT);
+		code = SCOPE_ADC_ZERO_CODE + (sim_phase2 < 0.5f ? amp : -amp);
+		sim_phase2 += sim_hz[1] / acq_sample_rate;
+		if (sim_phase2 >= 1.0f)
+			sim_phase2 -= (float)(int32_t)sim_phase2;
+	}
+
+	code += SCOPE_Sim_Noise();
+	code = (code < 0) ? 0 : (code > SCOPE_ADC_FULL_SCALE - 1) ? SCOPE_ADC_FULL_SCALE - 1 : code;
+	SCOPE_Sim_Watchdog(channel, (uint16_t)code);
+	return (uint16_t)code;
+}
+
+/**
+ * @brief  设置合成信号的频率
+ * @param  channel 通道 (0: CH1 正弦波，1: CH2 方波)
+ * @param  hz      频率 (Hz)
+ * @retval 无
+ */
+void SCOPE_Acq_Sim_Set_Frequency(uint8_t channel, float hz)
+{
+	if (channel < 2 && hz > 0)
+		sim_hz[channel] = hz;
+}
+
+/**
+ * @brief  获取合成信号的频率
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @retval 频率 (Hz)
+ */
+float SCOPE_Acq_Sim_Get_Frequency(uint8_t channel)
+{
+	return sim_hz[channel & 1];
+}
+
+/**
+ * @brief  按经过的时间生成合成数据块
+ * @param  now_ms 当前时刻 (ms)
+ * @retval 无
+ */
+void SCOPE_Acq_Sim_Pump(uint32_t now_ms)
+{
+	if (!acq_running)
+		return;
+	if (sim_tick == 0xFFFFFFFF)
+	{
+		sim_tick = now_ms;
+		return;
+	}
+
+	float words_per_ms = acq_sample_rate / SCOPE_Acq_Samples_Per_Word(acq_mode) / 1000.0f;
+	sim_pending += (float)(now_ms - sim_tick) * words_per_ms;
+	sim_tick = now_ms;
+	if (sim_pending > 4.0f * SCOPE_RECORD_LEN)
+		sim_pending = 4.0f * SCOPE_RECORD_LEN;
+
+	// 与 DMA 一样按半个缓冲区交出数据块
+	const uint16_t half = SCOPE_ACQ_DMA_WORDS / 2;
+	while (sim_pending >= half)
+	{
+		for (uint16_t i = 0; i < half; i++)
+		{
+			if (acq_mode == SCOPE_ACQ_SIMULTANEOUS)
+			{
+				uint16_t ch1 = SCOPE_Sim_Next(0);
+				sim_block[i] = ch1 | ((uint32_t)SCOPE_Sim_Next(1) << 16);
+			}
+			else
+			{
+				uint8_t channel = (acq_mode == SCOPE_ACQ_INTERLEAVED_CH1) ? 0 : 1;
+				uint16_t first = SCOPE_Sim_Next(channel); // 较早的采样在高16位 (ADC2)
+				sim_block[i] = SCOPE_Sim_Next(channel) | ((uint32_t)first << 16);
+			}
+		}
+		sim_pending -= half;
+		sim_time_us += (uint32_t)(half * SCOPE_Acq_Samples_Per_Word(acq_mode) * 1000000.0f / acq_sample_rate + 0.5f);
+
+		if (acq_block_handler != NULL)
+			acq_block_handler(sim_block, half, acq_mode);
+	}
+}
+
+#endif // SCOPE_ACQ_SIM
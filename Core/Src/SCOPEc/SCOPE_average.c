@@ -0,0 +1,186 @@
+/**
+ * @file    SCOPE_average.c
+ * @brief   示波器多次采集平均实现
+ * @details 每列每通道一个 32 位累加器，共 2 x SCOPE_RECORD_LEN x 4 字节，在采样存储的工作区中。
+ *          累加的是按越过点插值后的 Q12 码值 (Q4 采样乘 Q8 权重，不超过 24 位)，256 次的和不超过 32 位。
+ *          线性平均中累加器存放和，指数平均中存放 Q12 平均值本身。
+ */
+#include "SCOPEh/SCOPE_average.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if 2 * SCOPE_RECORD_LEN * 4 > SCOPE_SMEM_WORK_BYTES
+#error "SCOPE_SMEM_WORK_BYTES 放不下平均的累加器"
+#endif
+
+static uint32_t (*avg_acc)[SCOPE_RECORD_LEN] = NULL; // 累加器 (采样存储的工作区)
+
+static SCOPE_Average_Mode avg_type = SCOPE_AVERAGE_LINEAR; // 平均方式
+static uint16_t avg_count = 16;                           // 平均次数
+static uint16_t avg_done = 0;                             // 累加器中的采集次数
+static uint8_t avg_first = 1;                             // 复位后的第一批 (逐次显示)
+static SCOPE_Acq_Mode avg_mode = SCOPE_ACQ_SIMULTANEOUS;  // 累加器中数据的采集模式
+
+/**
+ * @brief  设置平均次数
+ * @param  count 平均次数
+ * @retval 无
+ */
+void SCOPE_Average_Set_Count(uint16_t count)
+{
+	if (count < SCOPE_AVERAGE_MIN_COUNT)
+		count = SCOPE_AVERAGE_MIN_COUNT;
+	if (count > SCOPE_AVERAGE_MAX_COUNT)
+		count = SCOPE_AVERAGE_MAX_COUNT;
+	avg_count = count;
+	SCOPE_Average_Reset();
+}
+
+/**
+ * @brief  获取平均次数
+ * @retval 平均次数
+ */
+uint16_t SCOPE_Average_Get_Count(void)
+{
+	return avg_count;
+}
+
+/**
+ * @brief  设置平均方式
+ * @param  mode 平均方式
+ * @retval 无
+ */
+void SCOPE_Average_Set_Mode(SCOPE_Average_Mode mode)
+{
+	avg_type = mode;
+	SCOPE_Average_Reset();
+}
+
+/**
+ * @brief  获取平均方式
+ * @retval 平均方式
+ */
+SCOPE_Average_Mode SCOPE_Average_Get_Mode(void)
+{
+	return avg_type;
+}
+
+/**
+ * @brief  丢弃已累积的结果
+ * @retval 无
+ */
+void SCOPE_Average_Reset(void)
+{
+	avg_done = 0;
+	avg_first = 1;
+}
+
+/**
+ * @brief  把冻结的采集窗口累加到平均结果
+ * @retval 1: 平均结果已更新，0: 线性平均的一批尚未完成
+ */
+uint8_t SCOPE_Average_Add(void)
+{
+	if (SCOPE_Capture_Is_Envelope())
+		return 0; // 包络最小值与累加器共用工作区
+
+	if (SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_AVERAGE)
+	{
+		avg_acc = (uint32_t (*)[SCOPE_RECORD_LEN])SCOPE_Smem_Claim(SCOPE_SMEM_AVERAGE);
+		SCOPE_Average_Reset();
+	}
+
+	SCOPE_Acq_Mode mode = SCOPE_Capture_Get_Mode();
+	if (mode != avg_mode)
+	{
+		avg_mode = mode;
+		SCOPE_Average_Reset();
+	}
+
+	// 线性平均：上一批已完成 (并已显示)，开始下一批
+	if (avg_type == SCOPE_AVERAGE_LINEAR && avg_done == avg_count)
+	{
+		avg_done = 0;
+		avg_first = 0;
+	}
+
+	// 指数平均的权重：前 n 次为 1/k (即累积平均)，之后固定为 1/n
+	const int32_t k = (avg_done < avg_count) ? avg_done + 1 : avg_count;
+	const int32_t frac = SCOPE_Capture_Get_Trigger_Fraction();
+
+	for (uint8_t channel = 0; channel < 2; channel++)
+	{
+		if (!SCOPE_Acq_Has_Channel(mode, channel))
+			continue;
+
+		uint32_t *acc = avg_acc[channel];
+		uint32_t prev = SCOPE_Capture_Sample_Q4(channel, 0);
+		for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i++)
+		{
+			// 与 SCOPE_Capture_To_Screen 相同的插值，使越过点在每次采集中都落在同一位置
+			uint32_t cur = SCOPE_Capture_Sample_Q4(channel, i);
+			uint32_t x = prev * (256 - frac) + cur * frac;
+			prev = cur;
+
+			if (avg_done == 0)
+				acc[i] = x;
+			else if (avg_type == SCOPE_AVERAGE_LINEAR)
+				acc[i] += x;
+			else
+				acc[i] = (uint32_t)((int32_t)acc[i] + ((int32_t)x - (int32_t)acc[i]) / k);
+		}
+	}
+
+	if (avg_done < avg_count)
+		avg_done++;
+
+	return avg_type == SCOPE_AVERAGE_EXPONENTIAL || avg_first || avg_done == avg_count;
+}
+
+/**
+ * @brief  获取当前结果包含的采集次数
+ * @retval 采集次数
+ */
+uint16_t SCOPE_Average_Get_Done(void)
+{
+	return (SCOPE_Smem_Get_Work_Owner() == SCOPE_SMEM_AVERAGE) ? avg_done : 0;
+}
+
+/**
+ * @brief  把一个通道的平均结果转换为屏幕Y坐标
+ * @param  channel       通道 (0: CH1，1: CH2)
+ * @param  wave_y        输出：每列的屏幕Y坐标
+ * @param  points        点数
+ * @param  volts_per_div 电压刻度 (V/div)
+ * @retval 无
+ */
+void SCOPE_Average_To_Screen(uint8_t channel, uint16_t *wave_y, uint16_t points, float volts_per_div)
+{
+	if (channel > 1 || wave_y == NULL || volts_per_div <= 0)
+		return;
+	if (SCOPE_Average_Get_Done() == 0 || !SCOPE_Acq_Has_Channel(avg_mode, channel))
+		return;
+	if (points > SCOPE_RECORD_LEN)
+		points = SCOPE_RECORD_LEN;
+
+	// 与 SCOPE_Capture_To_Screen 相同的 Q16 比例
+	float pixels_per_volt = (float)(SCOPE_PLOT_HEIGHT / SCOPE_DIVS_Y) / volts_per_div;
+	int32_t scale_q16 = (int32_t)(pixels_per_volt / SCOPE_CODES_PER_VOLT * 65536.0f);
+	int32_t center = SCOPE_PLOT_HEIGHT / 2;
+	const uint32_t *acc = avg_acc[channel];
+
+	for (uint16_t i = 0; i < points; i++)
+	{
+		uint32_t avg_q12 = (avg_type == SCOPE_AVERAGE_LINEAR) ? acc[i] / avg_done : acc[i];
+		int32_t delta_q12 = (int32_t)avg_q12 - (SCOPE_ADC_ZERO_CODE << 12);
+		int32_t y = center - (int32_t)(((int64_t)delta_q12 * scale_q16) >> 28);
+		if (y < 0)
+			y = 0;
+		if (y >= SCOPE_PLOT_HEIGHT)
+			y = SCOPE_PLOT_HEIGHT - 1;
+		wave_y[i] = (uint16_t)y;
+	}
+}
@@ -0,0 +1,976 @@
+/**
+ * @file    SCOPE_capture.c
+ * @brief   示波器触发采集记录实现
+ * @details 环形缓冲区按数据字写入，采样位置 = 字位置 * 每字采样数 + 字内序号，
+ *          容量为 SCOPE_CAPTURE_RING_WORDS 字，除一个完整窗口外还能多容纳一个 DMA 缓冲区，
+ *          因此触发边沿最多可以晚两个数据块才被找到。
+ *          PRE/ARMED/POST 只由中断推进，READY -> PRE 只由主循环推进，
+ *          每一方只在自己拥有缓冲区时访问它，因此不需要临界区。
+ *
+ *          触发带迟滞：采样先要到达触发电平"之前"一侧的迟滞门限之外 (上升沿为低于电平 - 迟滞)，
+ *          之后第一次越过电平才算触发，电平附近的噪声不会重复触发。
+ *          使用模拟看门狗时按同样的两步监视触发源，第二步命中后才在最近两个数据块中
+ *          逐点查找越过点，其余数据块只复制不检查。
+ *          越过点在两个采样之间线性插值，小数部分用于显示时对齐波形。
+ *          自动扫描的超时按等待触发期间写入的采样数计算，同样在数据块回调中完成。
+ *          峰值检测的包络数据块把最小值写入并行的 capture_min (采样存储的工作区)，最大值写入 scope_record，
+ *          触发和 SCOPE_Capture_Sample 使用两者的中点。
+ *          高分辨率方式的数据块每个半字为 Q4 码值，原样存入缓冲区；读取缓冲区统一得到 Q4 码值，
+ *          触发、屏幕坐标和 SCOPE_Capture_Sample_Q4 保留小数位，SCOPE_Capture_Sample 四舍五入为 12 位。
+ *          注册了窗口冻结回调 (分段采集) 时，回调取走窗口后直接回到 ARMED，
+ *          从窗口结束处继续查找下一次触发，本数据块剩余的数据属于下一个窗口。
+ *          回调只记录要保存的窗口，之后每个数据块写入之前打包与该块采样数相同的窗口采样，
+ *          中断中的工作量与逐点查找触发相当，不会因为保存一整个窗口而超过一个数据块的时间。
+ */
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if SCOPE_CAPTURE_RING_WORDS * 4 > SCOPE_SMEM_WORK_BYTES
+#error "SCOPE_SMEM_WORK_BYTES 放不下峰值检测的包络最小值"
+#endif
+
+uint32_t scope_record[SCOPE_CAPTURE_RING_WORDS]; // 环形缓冲区 (打包的数据字，包络时为最大值)
+static uint32_t *capture_min = NULL;             // 包络的最小值 (仅峰值检测，与 scope_record 一一对应)
+
+static volatile SCOPE_Capture_State capture_state = SCOPE_CAPTURE_PRE; // 采集状态
+static volatile uint8_t capture_force = 0;                             // 强制触发请求 (主循环置位，中断清除)
+static SCOPE_Acq_Mode capture_mode = SCOPE_ACQ_SIMULTANEOUS;           // 缓冲区中数据的采集模式
+static uint8_t capture_envelope = 0;                                   // 缓冲区中为包络 (最小值/最大值)
+static uint8_t capture_frac_bits = 0;                                  // 缓冲区中码值的小数位数 (高分辨率方式为 Q4)
+static volatile SCOPE_Sweep capture_sweep = SCOPE_SWEEP_AUTO;          // 扫描方式
+static volatile uint8_t capture_triggered = 0;                         // 当前窗口由触发条件产生 (而非强制)
+static volatile uint8_t capture_event = 0;                             // 触发事件标志 (中断置位，查询时清除)
+static SCOPE_Capture_Window_Func capture_window_handler = NULL;        // 窗口冻结回调
+
+// 触发条件 (主循环写，中断读)
+static uint8_t trig_channel = 0;                    // 触发源通道
+static uint16_t trig_level = SCOPE_ADC_ZERO_CODE;   // 触发电平 (码值)
+static SCOPE_Slope trig_slope = SCOPE_SLOPE_RISING; // 触发边沿
+static uint16_t trig_pre = SCOPE_RECORD_LEN / 2;    // 设定的预触发采样数
+static uint16_t trig_hyst = 0;                      // 迟滞 (码值)
+static volatile uint8_t trig_changed = 0;           // 触发条件已修改 (主循环置位，中断清除)
+
+// 以下仅由中断访问 (READY 状态下由主循环读取)
+static uint16_t capture_head = 0;      // 下一个写入的字位置
+static uint32_t capture_written = 0;   // 本次装填以来写入的采样数
+static uint32_t capture_scan_from = 0; // 尚未检查过触发边沿的第一个采样
+static uint16_t capture_post = 0;      // 剩余的触发后采样数
+static uint16_t capture_start = 0;     // 窗口起点的采样位置
+static uint32_t capture_end = 0;       // 窗口之后的第一个采样序号 (本次装填以来)
+static uint16_t capture_pre_used = 0;  // 本次触发使用的预触发采样数
+static uint16_t capture_frac = 256;    // 越过点在触发采样之前的位置 (Q8，256 表示正好在触发采样上)
+static uint8_t capture_hyst_armed = 0; // capture_scan_from 处是否已越过迟滞门限
+static uint32_t capture_wait = 0;      // 进入 ARMED 以来写入的采样数
+static uint32_t capture_timeout = 0;   // 自动扫描的超时 (采样数)
+
+/**
+ * @brief 打包保存一个窗口的进度
+ */
+typedef struct
+{
+	SCOPE_Smem_Writer w1, w2;     // 单通道只用 w1
+	uint16_t pos;                 // 下一个打包的采样位置
+	uint16_t left;                // 尚未打包的采样数
+	uint8_t channel;              // 保存的通道，2 表示两个通道
+	SCOPE_Capture_Saved_Func done; // 完成回调
+} SCOPE_Capture_Job;
+
+static SCOPE_Capture_Job capture_job; // 窗口冻结回调安排的保存 (中断推进，READY 状态下由主循环完成)
+
+#if SCOPE_TRIG_USE_AWD
+// 看门狗状态 (ADC 中断与 DMA 中断优先级相同，互不打断)
+static uint8_t awd_phase = 0; // 0: 等待到达电平之前的一侧，1: 等待越过电平
+static uint8_t awd_armed = 0; // 看门狗中断已打开
+static uint8_t awd_hit = 0;   // 已报告越过电平，等待数据块回调精确查找
+static uint8_t awd_phase_seen = 0; // 上一次数据块回调结束时的阶段
+static volatile uint8_t awd_enabled = 1; // 使用看门狗粗检
+#endif
+
+/**
+ * @brief  环形缓冲区的采样容量
+ */
+static inline uint16_t SCOPE_Capture_Capacity(void)
+{
+	return SCOPE_CAPTURE_RING_WORDS * SCOPE_Acq_Samples_Per_Word(capture_mode);
+}
+
+/**
+ * @brief  读取缓冲区中的一个采样，包络时取最小值与最大值的中点
+ * @param  channel 通道
+ * @param  pos     缓冲区中的采样位置
+ * @retval Q4 码值
+ */
+static inline uint16_t SCOPE_Capture_Ring_Sample(uint8_t channel, uint16_t pos)
+{
+	uint16_t v = SCOPE_Decim_Sample_Q4(scope_record, capture_mode, channel, pos, capture_frac_bits);
+	if (capture_envelope)
+		v = (v + SCOPE_Decim_Sample_Q4(capture_min, capture_mode, channel, pos, 0)) >> 1;
+	return v;
+}
+
+/**
+ * @brief  Q4 码值四舍五入为 12 位码值
+ */
+static inline uint16_t SCOPE_Capture_Round(uint16_t q4)
+{
+	return (uint16_t)((q4 + (1 << (SCOPE_DECIM_HIRES_BITS - 1))) >> SCOPE_DECIM_HIRES_BITS);
+}
+
+/**
+ * @brief  实际使用的触发源：快速交替模式只采集一个通道，在该通道上触发
+ */
+static inline uint8_t SCOPE_Capture_Trigger_Channel(void)
+{
+	return (capture_mode == SCOPE_ACQ_SIMULTANEOUS) ? trig_channel : (uint8_t)(capture_mode - SCOPE_ACQ_INTERLEAVED_CH1);
+}
+
+/**
+ * @brief  迟滞门限：越过它才允许下一次触发
+ * @retval 码值，可能超出 0 ~ 4095 (此时永远不会越过)
+ */
+static inline int32_t SCOPE_Capture_Arm_Level(void)
+{
+	if (trig_slope == SCOPE_SLOPE_RISING)
+		return (int32_t)trig_level - trig_hyst;
+	return (int32_t)trig_level + trig_hyst;
+}
+
+#if SCOPE_TRIG_USE_AWD
+/**
+ * @brief  按当前阶段装载看门狗窗口并打开中断
+ * @retval 无
+ * @note   看门狗在采样超出 [low, high] 时命中，A 为迟滞门限：
+ *         上升沿 阶段0 [A, 4095] (低于门限)，阶段1 [0, L-1] (达到电平)；
+ *         下降沿 阶段0 [0, A] (高于门限)，    阶段1 [L+1, 4095] (回到电平)。
+ *         门限超出码值范围时阶段0 的窗口覆盖全部码值，永远不会命中。
+ *         阶段1 只在阶段0 命中后进入，此时 L 不会是窗口无法表示的端点值。
+ */
+static void SCOPE_Capture_Awd_Arm(void)
+{
+	int32_t arm = SCOPE_Capture_Arm_Level();
+	uint16_t low, high;
+
+	if (trig_slope == SCOPE_SLOPE_RISING)
+	{
+		low = awd_phase ? 0 : (arm < 0 ? 0 : (uint16_t)arm);
+		high = awd_phase ? trig_level - 1 : SCOPE_ADC_FULL_SCALE - 1;
+	}
+	else
+	{
+		low = awd_phase ? trig_level + 1 : 0;
+		high = awd_phase ? SCOPE_ADC_FULL_SCALE - 1 : (arm > SCOPE_ADC_FULL_SCALE - 1 ? SCOPE_ADC_FULL_SCALE - 1 : (uint16_t)arm);
+	}
+	SCOPE_Acq_Watchdog_Config(SCOPE_Capture_Trigger_Channel(), low, high);
+	SCOPE_Acq_Watchdog_Arm();
+	awd_armed = 1;
+}
+
+/**
+ * @brief  模拟看门狗回调
+ * @retval 无
+ */
+void SCOPE_Capture_Watchdog(void)
+{
+	awd_armed = 0;
+	if (!awd_enabled)
+		return; // 关闭前已打开的中断
+	if (awd_phase == 0)
+	{
+		awd_phase = 1; // 已越过迟滞门限，立即监视越过电平
+		SCOPE_Capture_Awd_Arm();
+	}
+	else
+	{
+		awd_phase = 0;
+		awd_hit = 1; // 越过点在当前或刚交出的数据块中，由数据块回调查找
+	}
+}
+
+/**
+ * @brief  设置是否用模拟看门狗粗检触发边沿
+ * @param  enable 1: 使用，0: 每个数据块逐点查找
+ * @retval 无
+ */
+void SCOPE_Capture_Use_Watchdog(uint8_t enable)
+{
+	enable = enable ? 1 : 0;
+	if (enable == awd_enabled)
+		return;
+	awd_enabled = enable;
+	if (!enable)
+		SCOPE_Acq_Watchdog_Disarm();
+	trig_changed = 1; // 看门狗在下一个数据块重新开始监视
+}
+#endif
+
+/**
+ * @brief  把数据字追加到环形缓冲区
+ * @param  words     打包的数据字 (包络时为最大值)
+ * @param  min_words 包络的最小值，NULL 表示不是包络
+ * @param  count     字数
+ * @param  spw       每字采样数
+ * @retval 无
+ */
+static void SCOPE_Capture_Append(const uint32_t *words, const uint32_t *min_words, uint16_t count, uint8_t spw)
+{
+	for (uint16_t i = 0; i < count; i++)
+	{
+		scope_record[capture_head] = words[i];
+		if (min_words != NULL)
+			capture_min[capture_head] = min_words[i];
+		if (++capture_head == SCOPE_CAPTURE_RING_WORDS)
+			capture_head = 0;
+	}
+	capture_written += (uint32_t)count * spw;
+}
+
+/**
+ * @brief  在缓冲区中查找触发边沿
+ * @param  channel 触发源通道
+ * @param  from    第一个检查的采样序号 (本次装填以来，不小于 1)
+ * @param  to      检查到此序号为止 (不含)
+ * @retval 越过电平的采样序号，未找到返回 -1
+ * @note   从 capture_hyst_armed 记录的迟滞状态开始，未找到时把结束处的状态写回。
+ *         找到时在 capture_frac 中记录插值得到的越过点。采样和电平都按 Q4 比较。
+ */
+static int32_t SCOPE_Capture_Find_Edge(uint8_t channel, uint32_t from, uint32_t to)
+{
+	const uint16_t capacity = SCOPE_Capture_Capacity();
+	const int32_t arm_level = SCOPE_Capture_Arm_Level() * (1 << SCOPE_DECIM_HIRES_BITS);
+	const int32_t level = (int32_t)trig_level << SCOPE_DECIM_HIRES_BITS;
+	const uint8_t rising = (trig_slope == SCOPE_SLOPE_RISING);
+	uint8_t armed = capture_hyst_armed;
+	uint16_t pos = (uint16_t)((from - 1) % capacity);
+	uint16_t prev = SCOPE_Capture_Ring_Sample(channel, pos);
+
+	for (uint32_t t = from; t < to; t++)
+	{
+		if (++pos == capacity)
+			pos = 0;
+		uint16_t cur = SCOPE_Capture_Ring_Sample(channel, pos);
+		if (rising ? (cur < arm_level) : (cur > arm_level))
+		{
+			armed = 1;
+		}
+		else if (armed && (rising ? (cur >= level) : (cur <= level)))
+		{
+			// 在 prev 与 cur 之间线性插值：frac = (L - prev) / (cur - prev)
+			int32_t span = (int32_t)cur - prev;
+			int32_t frac = span ? ((level - prev) * 256) / span : 256;
+			capture_frac = (frac < 1) ? 1 : (frac > 256) ? 256 : (uint16_t)frac;
+			capture_hyst_armed = 0;
+			return (int32_t)t;
+		}
+		prev = cur;
+	}
+	capture_hyst_armed = armed;
+	return -1;
+}
+
+/**
+ * @brief  等待触发期间把采样序号减去容量的整数倍
+ * @retval 无
+ * @note   普通/单次扫描长时间等不到触发、分段采集冻结后直接回到 ARMED 时序号一直增加，
+ *         2^32 不是容量的整数倍，溢出后用序号对容量取模得到的位置会错开。
+ *         减去容量的整数倍后各序号在环形缓冲区中的位置不变。
+ */
+static void SCOPE_Capture_Rebase(void)
+{
+	const uint16_t capacity = SCOPE_Capture_Capacity();
+	uint32_t shift = (capture_scan_from / capacity - 1) * capacity; // 保留至少一个容量，仍大于预触发采样数
+	capture_written -= shift;
+	capture_scan_from -= shift;
+	capture_end -= shift;
+}
+
+/**
+ * @brief  开始打包冻结的窗口
+ * @param  job      保存进度
+ * @param  dest     目标
+ * @param  channels 需要保存的通道 (bit0: CH1，bit1: CH2)
+ * @param  format   存储格式
+ * @param  info     输出：窗口的描述
+ * @param  done     完成回调，可为 NULL
+ * @retval 写入的字节数
+ */
+static uint16_t SCOPE_Capture_Job_Begin(SCOPE_Capture_Job *job, uint8_t *dest, uint8_t channels, SCOPE_Smem_Format format,
+										SCOPE_Capture_Info *info, SCOPE_Capture_Saved_Func done)
+{
+	uint16_t bytes = SCOPE_Smem_Bytes(format, SCOPE_RECORD_LEN);
+
+	info->pre = capture_pre_used;
+	info->frac = capture_frac;
+	info->triggered = capture_triggered;
+	job->pos = capture_start;
+	job->done = done;
+	SCOPE_Smem_Writer_Init(&job->w1, dest, format);
+
+	// 两个通道：CH1 的整个窗口之后是 CH2 的整个窗口，一次遍历同时写两段
+	if (capture_mode == SCOPE_ACQ_SIMULTANEOUS && (channels & 3) == 3)
+	{
+		info->mode = SCOPE_ACQ_SIMULTANEOUS;
+		job->channel = 2;
+		SCOPE_Smem_Writer_Init(&job->w2, dest + bytes, format);
+		bytes *= 2;
+	}
+	else
+	{
+		// 单通道：装回时为快速交替模式的格式
+		if (capture_mode == SCOPE_ACQ_SIMULTANEOUS)
+			job->channel = (channels & 1) ? 0 : 1;
+		else
+			job->channel = (capture_mode == SCOPE_ACQ_INTERLEAVED_CH1) ? 0 : 1;
+		info->mode = job->channel ? SCOPE_ACQ_INTERLEAVED_CH2 : SCOPE_ACQ_INTERLEAVED_CH1;
+	}
+	job->left = SCOPE_RECORD_LEN; // 最后写入：中断中看到非零时其余字段已经就绪
+	return bytes;
+}
+
+/**
+ * @brief  继续打包窗口
+ * @param  job   保存进度
+ * @param  count 本次最多打包的采样数 (每通道)
+ * @retval 无
+ */
+static void SCOPE_Capture_Job_Step(SCOPE_Capture_Job *job, uint16_t count)
+{
+	const uint16_t capacity = SCOPE_Capture_Capacity();
+	uint16_t pos = job->pos;
+
+	if (count > job->left)
+		count = job->left;
+	for (uint16_t i = 0; i < count; i++)
+	{
+		if (job->channel == 2)
+		{
+			SCOPE_Smem_Put(&job->w1, SCOPE_Capture_Round(SCOPE_Capture_Ring_Sample(0, pos)));
+			SCOPE_Smem_Put(&job->w2, SCOPE_Capture_Round(SCOPE_Capture_Ring_Sample(1, pos)));
+		}
+		else
+		{
+			SCOPE_Smem_Put(&job->w1, SCOPE_Capture_Round(SCOPE_Capture_Ring_Sample(job->channel, pos)));
+		}
+		if (++pos == capacity)
+			pos = 0;
+	}
+	job->pos = pos;
+	job->left -= count;
+	if (job->left || count == 0)
+		return;
+
+	SCOPE_Smem_Flush(&job->w1);
+	if (job->channel == 2)
+		SCOPE_Smem_Flush(&job->w2);
+	if (job->done != NULL)
+		job->done();
+}
+
+/**
+ * @brief  冻结窗口，有窗口冻结回调且回调取走窗口时直接等待下一次触发
+ * @retval 无
+ */
+static void SCOPE_Capture_Freeze(void)
+{
+	capture_state = SCOPE_CAPTURE_READY;
+	if (capture_window_handler == NULL || !capture_window_handler())
+		return;
+
+	// 缓冲区内容保留为下一个窗口的预触发，迟滞和看门狗从窗口结束处重新开始
+	capture_scan_from = capture_end;
+	capture_hyst_armed = 0;
+	capture_force = 0;
+	capture_wait = 0;
+	trig_changed = 1;
+	capture_state = SCOPE_CAPTURE_ARMED;
+}
+
+/**
+ * @brief  以指定采样为触发点，计算窗口起点和剩余的触发后采样数
+ * @param  t         触发采样序号 (本次装填以来，不小于 trig_pre)
+ * @param  triggered 1: 满足触发条件，0: 强制触发 (capture_frac 置为 256)
+ * @retval 无
+ */
+static void SCOPE_Capture_Trigger(uint32_t t, uint8_t triggered)
+{
+	uint32_t after = capture_written - 1 - t; // 触发点之后已写入的采样数
+	uint16_t post = SCOPE_RECORD_LEN - 1 - trig_pre;
+
+	capture_triggered = triggered;
+	if (triggered)
+		capture_event = 1;
+	else
+		capture_frac = 256;
+	capture_force = 0;
+	capture_pre_used = trig_pre;
+	capture_start = (uint16_t)((t - trig_pre) % SCOPE_Capture_Capacity());
+	capture_end = t + post + 1;
+	if (after >= post)
+	{
+		SCOPE_Capture_Freeze(); // 窗口已经完整
+		return;
+	}
+	capture_post = post - (uint16_t)after;
+	capture_state = SCOPE_CAPTURE_POST;
+}
+
+/**
+ * @brief  处理一个数据块 (普通或包络)
+ * @param  words     打包的数据字 (包络时为最大值)
+ * @param  min_words 包络的最小值，NULL 表示不是包络
+ * @param  count     字数
+ * @param  mode      采集模式
+ * @retval 无
+ */
+static void SCOPE_Capture_Process(const uint32_t *words, const uint32_t *min_words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	if (capture_state == SCOPE_CAPTURE_READY)
+		return;
+
+	// 同一个缓冲区中的数据字必须按同一种方式解释
+	uint8_t envelope = (min_words != NULL);
+	uint8_t frac_bits = SCOPE_Decim_Get_Frac_Bits();
+	uint8_t claim = envelope && SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_ENVELOPE;
+	if (mode != capture_mode || envelope != capture_envelope || frac_bits != capture_frac_bits || claim)
+	{
+		if (claim)
+			capture_min = (uint32_t *)SCOPE_Smem_Claim(SCOPE_SMEM_ENVELOPE); // 工作区被其它采集方式使用过，重新装填
+		capture_mode = mode;
+		capture_envelope = envelope;
+		capture_frac_bits = frac_bits;
+		capture_job.left = 0; // 缓冲区按新的方式解释，未保存完的窗口作废
+		capture_head = 0;
+		capture_written = 0;
+		capture_scan_from = 0;
+		capture_hyst_armed = 0;
+		capture_state = SCOPE_CAPTURE_PRE;
+	}
+
+	const uint8_t spw = SCOPE_Acq_Samples_Per_Word(mode);
+
+	// 触发后装填：只复制到窗口结束为止，不再检查采样
+	if (capture_state == SCOPE_CAPTURE_POST)
+	{
+		uint16_t need = (capture_post + spw - 1) / spw;
+		uint16_t take = (count > need) ? need : count;
+		SCOPE_Capture_Append(words, min_words, take, spw);
+		if (capture_post > take * spw)
+		{
+			capture_post -= take * spw;
+			return;
+		}
+		SCOPE_Capture_Freeze(); // 窗口完整，冻结
+		if (capture_state == SCOPE_CAPTURE_READY || take == count)
+			return;
+
+		// 窗口已被取走，本块剩余的数据属于下一个窗口
+		words += take;
+		if (min_words != NULL)
+			min_words += take;
+		count -= take;
+	}
+
+	if (capture_state == SCOPE_CAPTURE_ARMED && capture_written >= SCOPE_CAPTURE_REBASE)
+		SCOPE_Capture_Rebase();
+
+	// 上一个窗口尚未保存完：在被本块覆盖之前继续打包
+	const uint8_t saving = (capture_job.left != 0);
+	if (saving)
+		SCOPE_Capture_Job_Step(&capture_job, count * spw);
+
+	uint32_t block_first = capture_written;
+	SCOPE_Capture_Append(words, min_words, count, spw);
+
+	if (saving)
+	{
+		// 死区：保存期间不查找触发，之后迟滞和看门狗从下一块开始
+		capture_scan_from = capture_written;
+		trig_changed = 1;
+		return;
+	}
+
+	uint8_t scan = 1;
+	if (capture_state == SCOPE_CAPTURE_PRE)
+	{
+		if (capture_written <= trig_pre)
+			return;
+		capture_state = SCOPE_CAPTURE_ARMED; // 刚装满预触发，本块中可触发的部分必须逐点检查
+		trig_changed = 1;
+		capture_wait = 0;
+		capture_timeout = (uint32_t)(SCOPE_Decim_Get_Rate() * (SCOPE_TRIG_AUTO_TIMEOUT_MS / 1000.0f));
+	}
+#if SCOPE_TRIG_USE_AWD
+	else
+	{
+		scan = capture_force || awd_hit || trig_changed || !awd_enabled;
+	}
+	awd_hit = 0;
+#endif
+	if (trig_changed)
+	{
+		// 迟滞状态和看门狗都从头开始，旧条件下的结果作废
+		trig_changed = 0;
+		capture_hyst_armed = 0;
+#if SCOPE_TRIG_USE_AWD
+		awd_phase = 0;
+		awd_armed = 0;
+#endif
+	}
+
+	if (capture_force)
+	{
+		SCOPE_Capture_Trigger(block_first > trig_pre ? block_first : trig_pre, 0);
+		return;
+	}
+
+	if (scan)
+	{
+		// 看门狗中断可能晚于交出越过点所在数据块的 DMA 中断，因此从上一个未检查的数据块开始
+		uint32_t from = capture_scan_from > trig_pre ? capture_scan_from : trig_pre;
+		if (from == 0)
+			from = 1;
+		int32_t t = SCOPE_Capture_Find_Edge(SCOPE_Capture_Trigger_Channel(), from, capture_written);
+		capture_scan_from = capture_written;
+		if (t >= 0)
+		{
+			SCOPE_Capture_Trigger((uint32_t)t, 1);
+			return;
+		}
+	}
+#if SCOPE_TRIG_USE_AWD
+	else
+	{
+		// 上一次回调结束时已处于阶段1，说明迟滞门限在本块之前已越过
+		capture_scan_from = block_first;
+		capture_hyst_armed = awd_phase_seen;
+	}
+#endif
+
+	// 自动扫描：超时仍未触发时以本块最后一个采样为触发点，无信号时也能看到基线
+	capture_wait += (uint32_t)count * spw;
+	if (capture_sweep == SCOPE_SWEEP_AUTO && capture_wait > capture_timeout)
+	{
+		SCOPE_Capture_Trigger(capture_written - 1, 0);
+		return;
+	}
+
+#if SCOPE_TRIG_USE_AWD
+	if (!awd_armed && awd_enabled)
+	{
+		awd_phase = capture_hyst_armed; // 与软件迟滞状态一致，已越过门限时直接监视越过电平
+		SCOPE_Capture_Awd_Arm();
+	}
+	awd_phase_seen = awd_phase;
+#endif
+}
+
+/**
+ * @brief  数据块回调
+ * @param  words 打包的数据字
+ * @param  count 字数
+ * @param  mode  采集模式
+ * @retval 无
+ */
+void SCOPE_Capture_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	SCOPE_Capture_Process(words, NULL, count, mode);
+}
+
+/**
+ * @brief  包络数据块回调
+ * @param  min_words 每列各通道的最小值
+ * @param  max_words 每列各通道的最大值
+ * @param  count     列数
+ * @retval 无
+ */
+void SCOPE_Capture_Envelope_Block(const uint32_t *min_words, const uint32_t *max_words, uint16_t count)
+{
+	SCOPE_Capture_Process(max_words, min_words, count, SCOPE_ACQ_SIMULTANEOUS);
+}
+
+/**
+ * @brief  设置边沿触发条件
+ * @param  channel 触发源通道
+ * @param  level   触发电平 (码值)
+ * @param  slope   触发边沿
+ * @retval 无
+ */
+void SCOPE_Capture_Set_Trigger(uint8_t channel, uint16_t level, SCOPE_Slope slope)
+{
+	channel = channel ? 1 : 0;
+	if (channel == trig_channel && level == trig_level && slope == trig_slope)
+		return;
+	trig_channel = channel;
+	trig_level = level;
+	trig_slope = slope;
+	trig_changed = 1;
+}
+
+/**
+ * @brief  设置触发迟滞
+ * @param  hysteresis 迟滞 (码值)
+ * @retval 无
+ */
+void SCOPE_Capture_Set_Hysteresis(uint16_t hysteresis)
+{
+	if (hysteresis > SCOPE_ADC_FULL_SCALE - 1)
+		hysteresis = SCOPE_ADC_FULL_SCALE - 1;
+	if (hysteresis == trig_hyst)
+		return;
+	trig_hyst = hysteresis;
+	trig_changed = 1;
+}
+
+/**
+ * @brief  设置触发点在窗口中的位置
+ * @param  pre_samples 触发点之前的采样数
+ * @retval 无
+ */
+void SCOPE_Capture_Set_Pretrigger(uint16_t pre_samples)
+{
+	if (pre_samples > SCOPE_RECORD_LEN - 1)
+		pre_samples = SCOPE_RECORD_LEN - 1;
+	trig_pre = pre_samples;
+}
+
+/**
+ * @brief  设置扫描方式
+ * @param  sweep 扫描方式
+ * @retval 无
+ */
+void SCOPE_Capture_Set_Sweep(SCOPE_Sweep sweep)
+{
+	capture_sweep = sweep;
+}
+
+/**
+ * @brief  获取扫描方式
+ * @retval 扫描方式
+ */
+SCOPE_Sweep SCOPE_Capture_Get_Sweep(void)
+{
+	return capture_sweep;
+}
+
+/**
+ * @brief  获取触发状态
+ * @retval 触发状态
+ */
+SCOPE_Capture_Status SCOPE_Capture_Get_Status(void)
+{
+	switch (capture_state)
+	{
+	case SCOPE_CAPTURE_PRE:
+		return SCOPE_STATUS_WAIT;
+	case SCOPE_CAPTURE_ARMED:
+		return SCOPE_STATUS_ARMED;
+	default:
+		return capture_triggered ? SCOPE_STATUS_TRIGD : SCOPE_STATUS_AUTO;
+	}
+}
+
+/**
+ * @brief  读取并清除触发事件标志
+ * @retval 1: 上次读取以来发生过满足条件的触发
+ */
+uint8_t SCOPE_Capture_Take_Event(void)
+{
+	uint8_t event = capture_event;
+	capture_event = 0;
+	return event;
+}
+
+/**
+ * @brief  强制触发
+ * @retval 无
+ */
+void SCOPE_Capture_Force(void)
+{
+	capture_force = 1;
+}
+
+/**
+ * @brief  获取采集状态
+ * @retval 采集状态
+ */
+SCOPE_Capture_State SCOPE_Capture_Get_State(void)
+{
+	return capture_state;
+}
+
+/**
+ * @brief  查询窗口是否已冻结
+ * @retval 1: 已冻结，0: 正在采集
+ */
+uint8_t SCOPE_Capture_Ready(void)
+{
+	return capture_state == SCOPE_CAPTURE_READY;
+}
+
+/**
+ * @brief  释放窗口并重新开始预触发装填
+ * @retval 无
+ * @note   先复位中断使用的计数再切换状态，中断看到 PRE 时计数已经复位。
+ *         在采集过程中调用 (例如修改时基后) 同样安全：中断打断这几次写入时
+ *         最多多写入一个按旧设置采集的数据块，随后的窗口会把它挤出。
+ */
+void SCOPE_Capture_Rearm(void)
+{
+	capture_job.left = 0; // 放弃未完成的保存
+	capture_head = 0;
+	capture_written = 0;
+	capture_scan_from = 0;
+	capture_force = 0;
+	capture_state = SCOPE_CAPTURE_PRE;
+}
+
+/**
+ * @brief  获取冻结窗口的采集模式
+ * @retval 采集模式
+ */
+SCOPE_Acq_Mode SCOPE_Capture_Get_Mode(void)
+{
+	return capture_mode;
+}
+
+/**
+ * @brief  注册窗口冻结回调
+ * @param  handler 回调函数，NULL 表示窗口冻结后等待主循环取走
+ * @retval 无
+ */
+void SCOPE_Capture_Set_Window_Handler(SCOPE_Capture_Window_Func handler)
+{
+	capture_window_handler = handler;
+}
+
+/**
+ * @brief  获取冻结窗口中触发点的位置
+ * @retval 触发点之前的采样数
+ */
+uint16_t SCOPE_Capture_Get_Trigger_Index(void)
+{
+	return capture_pre_used;
+}
+
+/**
+ * @brief  获取冻结窗口中越过点的小数位置
+ * @retval Q8：越过点位于触发采样之前 (256 - 返回值) / 256 个采样处
+ */
+uint16_t SCOPE_Capture_Get_Trigger_Fraction(void)
+{
+	return capture_frac;
+}
+
+/**
+ * @brief  查询冻结窗口是否为包络 (峰值检测)
+ * @retval 1: 包络，0: 普通采样
+ */
+uint8_t SCOPE_Capture_Is_Envelope(void)
+{
+	return capture_envelope;
+}
+
+/**
+ * @brief  读取冻结窗口中的一个采样
+ * @param  ring    读取的缓冲区，NULL 表示普通采样 (包络时为中点)
+ * @param  channel 通道
+ * @param  index   窗口内的采样序号
+ * @retval Q4 码值
+ */
+static inline uint16_t SCOPE_Capture_Read(const uint32_t *ring, uint8_t channel, uint16_t index)
+{
+	uint16_t capacity = SCOPE_Capture_Capacity();
+	uint16_t pos = capture_start + index;
+	if (pos >= capacity)
+		pos -= capacity;
+	if (ring == NULL)
+		return SCOPE_Capture_Ring_Sample(channel, pos);
+	return SCOPE_Decim_Sample_Q4(ring, capture_mode, channel, pos, 0); // 包络的最大值/最小值
+}
+
+/**
+ * @brief  读取冻结窗口中指定通道的一个采样
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  index   窗口内的采样序号
+ * @retval 12 位码值
+ */
+uint16_t SCOPE_Capture_Sample(uint8_t channel, uint16_t index)
+{
+	return SCOPE_Capture_Round(SCOPE_Capture_Read(NULL, channel, index));
+}
+
+/**
+ * @brief  读取冻结窗口中指定通道的一个采样，保留高分辨率方式的小数位
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  index   窗口内的采样序号
+ * @retval Q4 码值
+ */
+uint16_t SCOPE_Capture_Sample_Q4(uint8_t channel, uint16_t index)
+{
+	return SCOPE_Capture_Read(NULL, channel, index);
+}
+
+/**
+ * @brief  把冻结窗口中一个通道的数据转换为屏幕Y坐标
+ * @param  ring          读取的缓冲区，NULL 表示普通采样
+ * @param  channel       通道 (0: CH1，1: CH2)
+ * @param  wave_y        输出：每列的屏幕Y坐标
+ * @param  points        点数
+ * @param  volts_per_div 电压刻度 (V/div)
+ * @retval 无
+ */
+static void SCOPE_Capture_Convert(const uint32_t *ring, uint8_t channel, uint16_t *wave_y, uint16_t points, float volts_per_div)
+{
+	if (points > SCOPE_RECORD_LEN)
+		points = SCOPE_RECORD_LEN;
+
+	// 每个码值对应的像素数，用定点数 (Q16) 避免逐点浮点运算
+	float pixels_per_volt = (float)(SCOPE_PLOT_HEIGHT / SCOPE_DIVS_Y) / volts_per_div;
+	int32_t scale_q16 = (int32_t)(pixels_per_volt / SCOPE_CODES_PER_VOLT * 65536.0f);
+	int32_t center = SCOPE_PLOT_HEIGHT / 2;
+
+	// 越过点在触发采样之前 1 - frac 个采样处，整条波形右移这么多，使越过点正好落在触发列上：
+	// 第 i 列取采样 i-1 与 i 之间 frac 处的插值 (Q4 码值再乘 Q8 权重，共 Q12)
+	const int32_t frac = capture_frac;
+	int32_t prev = SCOPE_Capture_Read(ring, channel, 0);
+
+	for (uint16_t i = 0; i < points; i++)
+	{
+		int32_t cur = SCOPE_Capture_Read(ring, channel, i);
+		int32_t delta_q12 = prev * (256 - frac) + cur * frac - (SCOPE_ADC_ZERO_CODE << 12);
+		int32_t y = center - (int32_t)(((int64_t)delta_q12 * scale_q16) >> 28);
+		prev = cur;
+		if (y < 0)
+			y = 0;
+		if (y >= SCOPE_PLOT_HEIGHT)
+			y = SCOPE_PLOT_HEIGHT - 1;
+		wave_y[i] = (uint16_t)y;
+	}
+}
+
+/**
+ * @brief  把一个通道的窗口转换为屏幕Y坐标
+ * @param  channel       通道 (0: CH1，1: CH2)
+ * @param  wave_y        输出：每列的屏幕Y坐标
+ * @param  points        点数
+ * @param  volts_per_div 电压刻度 (V/div)
+ * @retval 无
+ */
+void SCOPE_Capture_To_Screen(uint8_t channel, uint16_t *wave_y, uint16_t points, float volts_per_div)
+{
+	if (channel > 1 || wave_y == NULL || volts_per_div <= 0)
+		return;
+	if (!SCOPE_Acq_Has_Channel(capture_mode, channel))
+		return;
+	SCOPE_Capture_Convert(NULL, channel, wave_y, points, volts_per_div);
+}
+
+/**
+ * @brief  把一个通道的包络转换为屏幕Y坐标
+ * @param  channel       通道 (0: CH1，1: CH2)
+ * @param  max_y         输出：每列最大值的屏幕Y坐标
+ * @param  min_y         输出：每列最小值的屏幕Y坐标
+ * @param  points        点数
+ * @param  volts_per_div 电压刻度 (V/div)
+ * @retval 1: 已输出包络，0: 窗口不是包络或不含该通道
+ */
+uint8_t SCOPE_Capture_Envelope_To_Screen(uint8_t channel, uint16_t *max_y, uint16_t *min_y, uint16_t points, float volts_per_div)
+{
+	if (channel > 1 || max_y == NULL || min_y == NULL || volts_per_div <= 0)
+		return 0;
+	if (!capture_envelope || !SCOPE_Acq_Has_Channel(capture_mode, channel))
+		return 0;
+	SCOPE_Capture_Convert(scope_record, channel, max_y, points, volts_per_div);
+	SCOPE_Capture_Convert(capture_min, channel, min_y, points, volts_per_div);
+	return 1;
+}
+
+/**
+ * @brief  把冻结的窗口打包保存到外部存储
+ * @param  dest     目标
+ * @param  channels 需要保存的通道 (bit0: CH1，bit1: CH2)
+ * @param  format   存储格式
+ * @param  info     输出：窗口的描述
+ * @retval 写入的字节数
+ */
+uint16_t SCOPE_Capture_Save(uint8_t *dest, uint8_t channels, SCOPE_Smem_Format format, SCOPE_Capture_Info *info)
+{
+	SCOPE_Capture_Job job;
+	uint16_t bytes = SCOPE_Capture_Job_Begin(&job, dest, channels, format, info, NULL);
+	SCOPE_Capture_Job_Step(&job, SCOPE_RECORD_LEN);
+	return bytes;
+}
+
+/**
+ * @brief  安排保存刚冻结的窗口
+ * @param  dest     目标
+ * @param  channels 需要保存的通道 (bit0: CH1，bit1: CH2)
+ * @param  format   存储格式
+ * @param  info     输出：窗口的描述
+ * @param  done     保存完成回调
+ * @retval 无
+ */
+void SCOPE_Capture_Save_Later(uint8_t *dest, uint8_t channels, SCOPE_Smem_Format format, SCOPE_Capture_Info *info,
+							  SCOPE_Capture_Saved_Func done)
+{
+	SCOPE_Capture_Job_Begin(&capture_job, dest, channels, format, info, done);
+}
+
+/**
+ * @brief  在主循环中完成冻结窗口未完成的保存
+ * @retval 无
+ */
+void SCOPE_Capture_Save_Finish(void)
+{
+	if (capture_state == SCOPE_CAPTURE_READY && capture_job.left)
+		SCOPE_Capture_Job_Step(&capture_job, capture_job.left);
+}
+
+/**
+ * @brief  把保存的窗口解包装回缓冲区
+ * @param  src    打包数据
+ * @param  format 存储格式
+ * @param  info   窗口的描述
+ * @retval 无
+ */
+void SCOPE_Capture_Load(const uint8_t *src, SCOPE_Smem_Format format, const SCOPE_Capture_Info *info)
+{
+	uint16_t a[16], b[16]; // 按块解包的暂存
+
+	if (capture_state != SCOPE_CAPTURE_READY)
+		return;
+
+	if (info->mode == SCOPE_ACQ_SIMULTANEOUS)
+	{
+		const uint8_t *src2 = src + SCOPE_Smem_Bytes(format, SCOPE_RECORD_LEN);
+		for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i += 16)
+		{
+			uint16_t n = (SCOPE_RECORD_LEN - i < 16) ? SCOPE_RECORD_LEN - i : 16;
+			SCOPE_Smem_Unpack(src, format, i, n, a);
+			SCOPE_Smem_Unpack(src2, format, i, n, b);
+			for (uint8_t k = 0; k < n; k++)
+				scope_record[i + k] = a[k] | ((uint32_t)b[k] << 16);
+		}
+	}
+	else
+	{
+		// 每字两个连续采样，较早的采样在高16位
+		for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i += 16)
+		{
+			uint16_t n = (SCOPE_RECORD_LEN - i < 16) ? SCOPE_RECORD_LEN - i : 16;
+			SCOPE_Smem_Unpack(src, format, i, n, a);
+			for (uint8_t k = 0; k + 1 < n; k += 2)
+				scope_record[(i + k) / 2] = a[k + 1] | ((uint32_t)a[k] << 16);
+		}
+	}
+	capture_mode = info->mode;
+	capture_envelope = 0;
+	capture_frac_bits = 0;
+	capture_start = 0;
+	capture_pre_used = info->pre;
+	capture_frac = info->frac;
+	capture_triggered = info->triggered;
+}
@@ -0,0 +1,302 @@
+/**
+ * @file    SCOPE_counter.c
+ * @brief   示波器硬件频率计实现
+ * @details 中断只维护 (累计边沿数，最近边沿时刻) 一对数据，闸门的开关都在主循环中完成。
+ *          最近边沿的 16 位捕获值在溢出中断中扩展为 32 位：捕获值大于中断时的计数值
+ *          说明边沿发生在溢出之前。两次溢出中断之间没有新边沿时保留上一次的结果，
+ *          因此慢信号的边沿时刻同样有效。
+ *          捕获分频只在溢出中断中修改，修改前的边沿已按旧分频计入，不会混在一起。
+ *          SCOPE_ACQ_SIM 为 1 时由合成信号的频率直接生成这对数据。
+ */
+#include "SCOPEh/SCOPE_counter.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+
+#if !SCOPE_ACQ_SIM
+#include "main.h"
+#endif
+
+#define SCOPE_COUNTER_SHIFT 3 // 高频时每 2^3 个边沿捕获一次
+
+/**
+ * @brief 闸门状态
+ */
+typedef enum
+{
+	SCOPE_COUNTER_IDLE = 0, // 下一次更新时开始等待
+	SCOPE_COUNTER_WAIT,     // 等待一个新的边沿打开闸门
+	SCOPE_COUNTER_OPEN      // 闸门已打开，等待闸门时间后的边沿
+} SCOPE_Counter_State;
+
+static uint32_t counter_gate_ms = SCOPE_COUNTER_GATE_MS; // 闸门时间
+static SCOPE_Counter_State counter_state = SCOPE_COUNTER_IDLE;
+static uint32_t counter_start_ms = 0;    // 闸门打开 (或开始等待) 的时刻
+static uint32_t counter_start_edges = 0; // 闸门起点的累计边沿数
+static uint32_t counter_start_time = 0;  // 闸门起点边沿的时刻 (计数值)
+static uint8_t counter_start_shift = 0;  // 闸门起点的捕获分频
+static double counter_hz = 0.0;          // 最近一次测量的频率
+static float counter_clock = 72000000.0f; // 计数时钟 (Hz)
+
+static void SCOPE_Counter_Read(uint32_t now_ms, uint32_t *edges, uint32_t *time, uint8_t *shift); // 读取边沿数据 (平台相关)
+static void SCOPE_Counter_Request_Shift(uint8_t shift);                                          // 请求修改捕获分频 (平台相关)
+
+#if !SCOPE_ACQ_SIM
+
+static volatile uint16_t counter_capture = 0;   // DMA 写入的最近一次捕获值
+static volatile uint16_t counter_overflows = 0; // TIM1 溢出次数 (时刻的高16位)
+static volatile uint32_t counter_edges = 0;     // 累计边沿数
+static volatile uint32_t counter_time = 0;      // 最近边沿的时刻
+static volatile uint8_t counter_shift = 0;      // 当前捕获分频
+static volatile uint8_t counter_shift_request = 0; // 主循环请求的捕获分频
+static uint16_t counter_ndtr = 0xFFFF;          // 上一次溢出中断时 DMA 的剩余次数
+
+/**
+ * @brief  初始化频率计 (GPIO PA8、TIM1、DMA1 通道2) 并开始测量
+ * @retval 无
+ * @note   TIM1 挂在 APB2 上，APB2 分频不为 1 时定时器时钟为 PCLK2 的 2 倍。
+ */
+void SCOPE_Counter_Init(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_TIM1_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	// PA8 (TIM1_CH1) 浮空输入
+	GPIO_InitStruct.Pin = GPIO_PIN_8;
+	GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+	uint32_t tim_clk = HAL_RCC_GetPCLK2Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1)
+		tim_clk *= 2;
+	counter_clock = (float)tim_clk;
+
+	// TIM1: 不分频自由计数，CH1 捕获 TI1 上升沿 (滤波 N=2)，捕获时请求 DMA
+	TIM1->CR1 = 0;
+	TIM1->PSC = 0;
+	TIM1->ARR = 0xFFFF;
+	TIM1->CCER = 0;
+	TIM1->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_IC1F_0;
+	TIM1->CCER = TIM_CCER_CC1E;
+	TIM1->EGR = TIM_EGR_UG;
+	TIM1->SR = 0;
+	TIM1->DIER = TIM_DIER_UIE | TIM_DIER_CC1DE;
+
+	// DMA1 通道2: TIM1->CCR1 -> counter_capture，16 位，地址不增加，循环
+	DMA1_Channel2->CCR = 0;
+	DMA1_Channel2->CPAR = (uint32_t)&TIM1->CCR1;
+	DMA1_Channel2->CMAR = (uint32_t)&counter_capture;
+	DMA1_Channel2->CNDTR = 0xFFFF;
+	DMA1_Channel2->CCR = DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0 | DMA_CCR_CIRC | DMA_CCR_EN;
+	counter_ndtr = 0xFFFF;
+
+	// 与采集 DMA 同级，中断只做几次寄存器读取
+	HAL_NVIC_SetPriority(TIM1_UP_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(TIM1_UP_IRQn);
+
+	TIM1->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief  TIM1 更新 (溢出) 中断处理
+ * @retval 无
+ */
+void SCOPE_Counter_TIM_IRQHandler(void)
+{
+	if (!(TIM1->SR & TIM_SR_UIF))
+		return;
+	TIM1->SR = ~TIM_SR_UIF;
+
+	uint16_t high = ++counter_overflows;
+	uint16_t ndtr, capture;
+	do
+	{
+		ndtr = (uint16_t)DMA1_Channel2->CNDTR;
+		capture = counter_capture;
+	} while (ndtr != (uint16_t)DMA1_Channel2->CNDTR); // 读取期间又有边沿时重新读取
+	uint16_t now = (uint16_t)TIM1->CNT;
+
+	// 剩余次数从 0xFFFF 递减到 1 后重新装载
+	int32_t captures = (int32_t)counter_ndtr - ndtr;
+	if (captures < 0)
+		captures += 0xFFFF;
+	if (captures > 0)
+	{
+		counter_ndtr = ndtr;
+		counter_edges += (uint32_t)captures << counter_shift;
+		counter_time = ((uint32_t)(capture > now ? high - 1 : high) << 16) | capture;
+	}
+
+	// 边沿已按旧分频计入，此时修改分频
+	if (counter_shift_request != counter_shift)
+	{
+		counter_shift = counter_shift_request;
+		TIM1->CCMR1 = (TIM1->CCMR1 & ~TIM_CCMR1_IC1PSC) | (counter_shift ? TIM_CCMR1_IC1PSC : 0); // 8 分频
+	}
+}
+
+/**
+ * @brief  读取累计边沿数和最近边沿的时刻
+ */
+static void SCOPE_Counter_Read(uint32_t now_ms, uint32_t *edges, uint32_t *time, uint8_t *shift)
+{
+	(void)now_ms;
+	do
+	{
+		*edges = counter_edges;
+		*time = counter_time;
+		*shift = counter_shift;
+	} while (*edges != counter_edges); // 读取期间进入了溢出中断时重新读取
+}
+
+/**
+ * @brief  请求修改捕获分频，在下一次溢出中断中生效
+ */
+static void SCOPE_Counter_Request_Shift(uint8_t shift)
+{
+	counter_shift_request = shift;
+}
+
+#else // SCOPE_ACQ_SIM
+
+#include <math.h>
+
+/**
+ * @brief  初始化合成信号的频率计
+ * @retval 无
+ */
+void SCOPE_Counter_Init(void)
+{
+	counter_state = SCOPE_COUNTER_IDLE;
+}
+
+/**
+ * @brief  合成信号没有定时器，保留空实现以便中断向量表保持一致
+ * @retval 无
+ */
+void SCOPE_Counter_TIM_IRQHandler(void)
+{
+}
+
+/**
+ * @brief  按当前时刻和 CH1 频率生成累计边沿数和最近边沿的时刻
+ */
+static void SCOPE_Counter_Read(uint32_t now_ms, uint32_t *edges, uint32_t *time, uint8_t *shift)
+{
+	double hz = SCOPE_Acq_Sim_Get_Frequency(0);
+	double n = floor(now_ms / 1000.0 * hz);
+	*edges = (uint32_t)fmod(n, 4294967296.0);
+	*time = (uint32_t)fmod(n / hz * counter_clock, 4294967296.0);
+	*shift = 0;
+}
+
+/**
+ * @brief  合成信号不需要捕获分频
+ */
+static void SCOPE_Counter_Request_Shift(uint8_t shift)
+{
+	(void)shift;
+}
+
+#endif // SCOPE_ACQ_SIM
+
+/**
+ * @brief  设置闸门时间
+ * @param  gate_ms 闸门时间 (ms)
+ * @retval 无
+ */
+void SCOPE_Counter_Set_Gate(uint32_t gate_ms)
+{
+	counter_gate_ms = (gate_ms < 10) ? 10 : (gate_ms > 10000) ? 10000 : gate_ms;
+	counter_state = SCOPE_COUNTER_IDLE;
+}
+
+/**
+ * @brief  获取闸门时间
+ * @retval 闸门时间 (ms)
+ */
+uint32_t SCOPE_Counter_Get_Gate(void)
+{
+	return counter_gate_ms;
+}
+
+/**
+ * @brief  推进闸门
+ * @param  now_ms 当前时刻 (ms)
+ * @retval 1: 有新的测量结果，0: 没有变化
+ * @note   闸门起点必须是打开之后才出现的边沿，否则没有信号一段时间后的第一个闸门
+ *         会从很久以前的边沿算起
+ */
+uint8_t SCOPE_Counter_Update(uint32_t now_ms)
+{
+	uint32_t edges, time;
+	uint8_t shift;
+	SCOPE_Counter_Read(now_ms, &edges, &time, &shift);
+
+	if (counter_state == SCOPE_COUNTER_OPEN && shift != counter_start_shift)
+		counter_state = SCOPE_COUNTER_IDLE; // 捕获分频改变，重新开始
+
+	if (counter_state == SCOPE_COUNTER_IDLE)
+	{
+		counter_state = SCOPE_COUNTER_WAIT;
+		counter_start_ms = now_ms;
+		counter_start_edges = edges;
+		return 0;
+	}
+
+	if (counter_state == SCOPE_COUNTER_WAIT)
+	{
+		if (edges == counter_start_edges)
+		{
+			if (now_ms - counter_start_ms < counter_gate_ms + SCOPE_COUNTER_TIMEOUT_MS || counter_hz == 0.0)
+				return 0;
+			counter_hz = 0.0; // 没有信号
+			return 1;
+		}
+		counter_state = SCOPE_COUNTER_OPEN;
+		counter_start_ms = now_ms;
+		counter_start_edges = edges;
+		counter_start_time = time;
+		counter_start_shift = shift;
+		return 0;
+	}
+
+	if (now_ms - counter_start_ms < counter_gate_ms)
+		return 0;
+	if (edges == counter_start_edges)
+	{
+		if (now_ms - counter_start_ms < counter_gate_ms + SCOPE_COUNTER_TIMEOUT_MS)
+			return 0;
+		counter_hz = 0.0; // 没有信号，等待下一个边沿重新打开闸门
+		counter_state = SCOPE_COUNTER_IDLE;
+		return 1;
+	}
+
+	uint32_t ticks = time - counter_start_time;
+	if (ticks > 0)
+		counter_hz = (double)(edges - counter_start_edges) * counter_clock / ticks;
+
+	// 本闸门的终点作为下一个闸门的起点
+	counter_start_ms = now_ms;
+	counter_start_edges = edges;
+	counter_start_time = time;
+
+	// 高频时减少捕获次数，回到低频时留一倍迟滞
+	if (counter_hz > SCOPE_COUNTER_PSC_HZ)
+		SCOPE_Counter_Request_Shift(SCOPE_COUNTER_SHIFT);
+	else if (counter_hz < SCOPE_COUNTER_PSC_HZ / 2)
+		SCOPE_Counter_Request_Shift(0);
+	return 1;
+}
+
+/**
+ * @brief  获取最近一次测量的频率
+ * @retval 频率 (Hz)，0 表示没有信号
+ */
+double SCOPE_Counter_Get_Frequency(void)
+{
+	return counter_hz;
+}
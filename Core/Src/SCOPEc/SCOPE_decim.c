@@ -0,0 +1,201 @@
+/**
+ * @file    SCOPE_decim.c
+ * @brief   示波器抽取 (采集方式) 实现
+ * @details 只在同步模式下抽取，两个通道同时处理。一列可能跨越多个数据块，
+ *          未完成的一列保存在累积状态中，每个数据块结束时把已完成的列一次交给输出。
+ */
+#include "SCOPEh/SCOPE_decim.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define SCOPE_DECIM_OUT_WORDS (SCOPE_ACQ_DMA_WORDS / 4) // 每个数据块最多输出的列数 (抽取倍数至少为 2)
+
+static SCOPE_Block_Func decim_block_out = NULL;       // 普通/高分辨率输出
+static SCOPE_Envelope_Func decim_envelope_out = NULL; // 峰值检测输出
+static volatile SCOPE_Decim_Type decim_type = SCOPE_DECIM_NORMAL;
+static volatile uint16_t decim_factor = 1; // 抽取倍数
+static float decim_rate = 1000.0f;         // 每列采样率 (Hz)
+static uint8_t decim_out_bits = 0;         // 正在输出的数据块中码值的小数位数
+
+// 以下仅由中断访问
+static uint16_t decim_fill = 0;   // 当前列已累积的采样数
+static uint32_t decim_sum1 = 0;   // 通道1累加和 (高分辨率)
+static uint32_t decim_sum2 = 0;   // 通道2累加和
+static uint32_t decim_min = 0;    // 各通道最小值 (打包)
+static uint32_t decim_max = 0;    // 各通道最大值 (打包)
+static uint32_t decim_out_max[SCOPE_DECIM_OUT_WORDS]; // 输出：普通/高分辨率的列，峰值检测的最大值
+static uint32_t decim_out_min[SCOPE_DECIM_OUT_WORDS]; // 输出：峰值检测的最小值
+
+/**
+ * @brief  指定抽取结果的输出
+ * @param  block    普通/高分辨率方式及不抽取时的输出
+ * @param  envelope 峰值检测方式的输出
+ * @retval 无
+ */
+void SCOPE_Decim_Set_Output(SCOPE_Block_Func block, SCOPE_Envelope_Func envelope)
+{
+	decim_block_out = block;
+	decim_envelope_out = envelope;
+}
+
+/**
+ * @brief  设置采集方式
+ * @param  type 采集方式
+ * @retval 无
+ */
+void SCOPE_Decim_Set_Type(SCOPE_Decim_Type type)
+{
+	if (type == decim_type)
+		return;
+	decim_type = type;
+	decim_fill = 0;
+}
+
+/**
+ * @brief  获取采集方式
+ * @retval 采集方式
+ */
+SCOPE_Decim_Type SCOPE_Decim_Get_Type(void)
+{
+	return decim_type;
+}
+
+/**
+ * @brief  设置每列的采样率，并选择抽取倍数和 ADC 采样率
+ * @param  rate 每列采样率 (Hz)
+ * @retval 实际每列采样率 (Hz)
+ */
+float SCOPE_Decim_Set_Rate(float rate)
+{
+	float factor = (rate > 0) ? SCOPE_DECIM_MAX_RATE / rate : 1.0f;
+	uint16_t n = (factor >= 65535.0f) ? 65535 : (factor < 1.0f) ? 1 : (uint16_t)factor;
+
+	float acq_rate = SCOPE_Acq_Set_Sample_Rate(rate * n);
+	if (SCOPE_Acq_Get_Mode() != SCOPE_ACQ_SIMULTANEOUS)
+		n = 1; // 快速交替模式只在最高采样率下使用，不抽取
+
+	decim_factor = n;
+	decim_fill = 0;
+	decim_rate = acq_rate / n;
+	return decim_rate;
+}
+
+/**
+ * @brief  获取实际每列采样率
+ * @retval 每列采样率 (Hz)
+ */
+float SCOPE_Decim_Get_Rate(void)
+{
+	return decim_rate;
+}
+
+/**
+ * @brief  获取抽取倍数
+ * @retval 每列合并的原始采样数
+ */
+uint16_t SCOPE_Decim_Get_Factor(void)
+{
+	return decim_factor;
+}
+
+/**
+ * @brief  数据块回调
+ * @param  words 打包的数据字
+ * @param  count 字数
+ * @param  mode  采集模式
+ * @retval 无
+ */
+void SCOPE_Decim_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	const uint16_t n = decim_factor;
+	uint16_t out = 0;
+
+	decim_out_bits = 0;
+	if (n <= 1 || mode != SCOPE_ACQ_SIMULTANEOUS)
+	{
+		if (decim_block_out != NULL)
+			decim_block_out(words, count, mode);
+		return;
+	}
+
+	switch (decim_type)
+	{
+	case SCOPE_DECIM_NORMAL:
+		// 每列取第一个采样：直接跳到下一列的起点，其余采样不读取 (n 可达 65535，序号用 32 位才不会回绕)
+		for (uint32_t i = (decim_fill == 0) ? 0 : n - decim_fill; i < count; i += n)
+			decim_out_max[out++] = words[i];
+		decim_fill = (uint16_t)((decim_fill + count) % n);
+		break;
+
+	case SCOPE_DECIM_PEAK:
+		for (uint16_t i = 0; i < count; i++)
+		{
+			uint32_t w = words[i];
+			if (decim_fill == 0)
+			{
+				decim_min = decim_max = w;
+			}
+			else
+			{
+				// 两个通道分别比较 (低16位 CH1，高16位 CH2)
+				if ((w & 0xFFFF) < (decim_min & 0xFFFF))
+					decim_min = (decim_min & 0xFFFF0000) | (w & 0xFFFF);
+				if ((w & 0xFFFF) > (decim_max & 0xFFFF))
+					decim_max = (decim_max & 0xFFFF0000) | (w & 0xFFFF);
+				if ((w >> 16) < (decim_min >> 16))
+					decim_min = (decim_min & 0xFFFF) | (w & 0xFFFF0000);
+				if ((w >> 16) > (decim_max >> 16))
+					decim_max = (decim_max & 0xFFFF) | (w & 0xFFFF0000);
+			}
+			if (++decim_fill == n)
+			{
+				decim_out_min[out] = decim_min;
+				decim_out_max[out++] = decim_max;
+				decim_fill = 0;
+			}
+		}
+		break;
+
+	case SCOPE_DECIM_HIRES:
+		for (uint16_t i = 0; i < count; i++)
+		{
+			uint32_t w = words[i];
+			if (decim_fill == 0)
+				decim_sum1 = decim_sum2 = 0;
+			decim_sum1 += w & 0xFFFF;
+			decim_sum2 += w >> 16;
+			if (++decim_fill == n)
+			{
+				// 平均值保留 4 位小数 (Q4)，测量和频谱分析用得到平均多出的分辨率。
+				// 累加和不超过 4095 x 65535，乘 16 后仍小于 2^32
+				uint32_t avg1 = ((decim_sum1 << SCOPE_DECIM_HIRES_BITS) + n / 2) / n;
+				uint32_t avg2 = ((decim_sum2 << SCOPE_DECIM_HIRES_BITS) + n / 2) / n;
+				decim_out_max[out++] = avg1 | (avg2 << 16);
+				decim_fill = 0;
+			}
+		}
+		break;
+	}
+
+	if (out == 0)
+		return;
+	if (decim_type == SCOPE_DECIM_PEAK)
+	{
+		if (decim_envelope_out != NULL)
+			decim_envelope_out(decim_out_min, decim_out_max, out);
+	}
+	else if (decim_block_out != NULL)
+	{
+		decim_out_bits = (decim_type == SCOPE_DECIM_HIRES) ? SCOPE_DECIM_HIRES_BITS : 0;
+		decim_block_out(decim_out_max, out, SCOPE_ACQ_SIMULTANEOUS);
+	}
+}
+
+/**
+ * @brief  获取正在输出的数据块中码值的小数位数
+ * @retval 小数位数
+ */
+uint8_t SCOPE_Decim_Get_Frac_Bits(void)
+{
+	return decim_out_bits;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file    SCOPE_ets.c
+ * @brief   示波器等效时间采样实现
+ * @details 时间以采样间隔的 Q8 表示。越过点位于 (pre - 1) + frac / 256 处，
+ *          采样 i 落入的列 = 触发列 + (i * 256 - 越过点) * 倍数 (Q8)，四舍五入。
+ *          每通道每列一个 16 位码值 (采样存储的工作区)，另用位图记录已填充的列。
+ */
+#include "SCOPEh/SCOPE_ets.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if 2 * SCOPE_RECORD_LEN * 2 > SCOPE_SMEM_WORK_BYTES
+#error "SCOPE_SMEM_WORK_BYTES 放不下等效时间采样的各列码值"
+#endif
+
+static uint16_t (*ets_bin)[SCOPE_RECORD_LEN] = NULL;  // 每列最近一次落入的码值 (采样存储的工作区)
+static uint8_t ets_filled[(SCOPE_RECORD_LEN + 7) / 8]; // 已填充的列 (位图)
+static uint16_t ets_filled_count = 0;                  // 已填充的列数
+
+static uint16_t ets_ratio_q8 = 256;                     // 等效采样倍数 (Q8)
+static uint16_t ets_column = SCOPE_RECORD_LEN / 2;      // 触发点所在的列
+static SCOPE_Acq_Mode ets_mode = SCOPE_ACQ_SIMULTANEOUS; // 已填充数据的采集模式
+
+/**
+ * @brief  设置等效采样倍数
+ * @param  ratio 等效采样率 / 实际采样率
+ * @retval 实际倍数
+ */
+float SCOPE_Ets_Set_Ratio(float ratio)
+{
+	if (ratio < 1.0f)
+		ratio = 1.0f;
+	if (ratio > SCOPE_ETS_MAX_RATIO)
+		ratio = SCOPE_ETS_MAX_RATIO;
+
+	uint16_t ratio_q8 = (uint16_t)(ratio * 256.0f + 0.5f);
+	if (ratio_q8 != ets_ratio_q8)
+	{
+		ets_ratio_q8 = ratio_q8;
+		SCOPE_Ets_Reset();
+	}
+	return ets_ratio_q8 / 256.0f;
+}
+
+/**
+ * @brief  获取等效采样倍数
+ * @retval 倍数
+ */
+float SCOPE_Ets_Get_Ratio(void)
+{
+	return ets_ratio_q8 / 256.0f;
+}
+
+/**
+ * @brief  设置触发点所在的列
+ * @param  column 列
+ * @retval 无
+ */
+void SCOPE_Ets_Set_Trigger_Column(uint16_t column)
+{
+	if (column >= SCOPE_RECORD_LEN)
+		column = SCOPE_RECORD_LEN - 1;
+	if (column != ets_column)
+	{
+		ets_column = column;
+		SCOPE_Ets_Reset();
+	}
+}
+
+/**
+ * @brief  获取采集记录需要的预触发采样数
+ * @retval 采样数
+ */
+uint16_t SCOPE_Ets_Get_Pretrigger(void)
+{
+	uint32_t pre = ((uint32_t)ets_column * 256 + ets_ratio_q8 - 1) / ets_ratio_q8 + 2;
+	return (pre > SCOPE_RECORD_LEN - 1) ? SCOPE_RECORD_LEN - 1 : (uint16_t)pre;
+}
+
+/**
+ * @brief  丢弃已填充的列
+ * @retval 无
+ */
+void SCOPE_Ets_Reset(void)
+{
+	memset(ets_filled, 0, sizeof(ets_filled));
+	ets_filled_count = 0;
+}
+
+/**
+ * @brief  把冻结的采集窗口中的采样按相位放入各列
+ * @retval 1: 已放入，0: 没有相位信息
+ */
+uint8_t SCOPE_Ets_Add(void)
+{
+	if (SCOPE_Capture_Get_Status() != SCOPE_STATUS_TRIGD)
+		return 0;
+	if (SCOPE_Capture_Is_Envelope())
+		return 0; // 包络最小值与各列码值共用工作区
+
+	if (SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_ETS)
+	{
+		ets_bin = (uint16_t (*)[SCOPE_RECORD_LEN])SCOPE_Smem_Claim(SCOPE_SMEM_ETS);
+		SCOPE_Ets_Reset();
+	}
+
+	SCOPE_Acq_Mode mode = SCOPE_Capture_Get_Mode();
+	if (mode != ets_mode)
+	{
+		ets_mode = mode;
+		SCOPE_Ets_Reset();
+	}
+
+	// 越过点 (Q8 采样)，以及第一个可能落在第 0 列的采样
+	int32_t cross = (int32_t)SCOPE_Capture_Get_Trigger_Index() * 256 - 256 + SCOPE_Capture_Get_Trigger_Fraction();
+	int32_t first = (cross - (int32_t)ets_column * 65536 / ets_ratio_q8) / 256 - 1;
+	if (first < 0)
+		first = 0;
+
+	for (uint16_t i = (uint16_t)first; i < SCOPE_RECORD_LEN; i++)
+	{
+		int32_t column = ets_column + ((((int32_t)i * 256 - cross) * ets_ratio_q8 + 32768) >> 16);
+		if (column < 0)
+			continue;
+		if (column >= SCOPE_RECORD_LEN)
+			break;
+
+		for (uint8_t channel = 0; channel < 2; channel++)
+			if (SCOPE_Acq_Has_Channel(mode, channel))
+				ets_bin[channel][column] = SCOPE_Capture_Sample(channel, i);
+
+		uint8_t bit = 1 << (column & 7);
+		if (!(ets_filled[column >> 3] & bit))
+		{
+			ets_filled[column >> 3] |= bit;
+			ets_filled_count++;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief  获取覆盖率
+ * @retval 百分比
+ */
+uint8_t SCOPE_Ets_Get_Coverage(void)
+{
+	if (SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_ETS)
+		return 0;
+	return (uint8_t)((uint32_t)ets_filled_count * 100 / SCOPE_RECORD_LEN);
+}
+
+/**
+ * @brief  把一个通道的等效时间记录转换为屏幕Y坐标
+ * @param  channel       通道 (0: CH1，1: CH2)
+ * @param  wave_y        输出：每列的屏幕Y坐标
+ * @param  points        点数
+ * @param  volts_per_div 电压刻度 (V/div)
+ * @retval 1: 已输出，0: 没有数据
+ */
+uint8_t SCOPE_Ets_To_Screen(uint8_t channel, uint16_t *wave_y, uint16_t points, float volts_per_div)
+{
+	if (channel > 1 || wave_y == NULL || volts_per_div <= 0)
+		return 0;
+	if (ets_filled_count == 0 || SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_ETS)
+		return 0;
+	if (!SCOPE_Acq_Has_Channel(ets_mode, channel))
+		return 0;
+	if (points > SCOPE_RECORD_LEN)
+		points = SCOPE_RECORD_LEN;
+
+	// 第一遍：输出码值，未填充的列在两侧已填充的列之间插值 (两端保持最近的值)
+	const uint16_t *bin = ets_bin[channel];
+	int32_t prev = -1;
+	for (uint16_t i = 0; i < points; i++)
+	{
+		if (!(ets_filled[i >> 3] & (1 << (i & 7))))
+			continue;
+		if (prev < 0)
+		{
+			for (uint16_t k = 0; k < i; k++)
+				wave_y[k] = bin[i];
+		}
+		else
+		{
+			int32_t span = i - prev;
+			for (int32_t k = prev + 1; k < i; k++)
+				wave_y[k] = (uint16_t)(bin[prev] + ((int32_t)bin[i] - bin[prev]) * (k - prev) / span);
+		}
+		wave_y[i] = bin[i];
+		prev = i;
+	}
+	for (uint16_t k = (uint16_t)(prev + 1); k < points; k++)
+		wave_y[k] = (prev < 0) ? SCOPE_ADC_ZERO_CODE : bin[prev];
+
+	// 第二遍：码值转换为屏幕坐标 (与 SCOPE_Capture_To_Screen 相同的 Q16 比例)
+	float pixels_per_volt = (float)(SCOPE_PLOT_HEIGHT / SCOPE_DIVS_Y) / volts_per_div;
+	int32_t scale_q16 = (int32_t)(pixels_per_volt / SCOPE_CODES_PER_VOLT * 65536.0f);
+	int32_t center = SCOPE_PLOT_HEIGHT / 2;
+	for (uint16_t i = 0; i < points; i++)
+	{
+		int32_t y = center - (((int32_t)wave_y[i] - SCOPE_ADC_ZERO_CODE) * scale_q16 >> 16);
+		if (y < 0)
+			y = 0;
+		if (y >= SCOPE_PLOT_HEIGHT)
+			y = SCOPE_PLOT_HEIGHT - 1;
+		wave_y[i] = (uint16_t)y;
+	}
+	return 1;
+}
@@ -0,0 +1,406 @@
+/**
+ * @file    SCOPE_fft.c
+ * @brief   示波器频谱分析实现
+ * @details 收集由中断完成，收满后置位 fft_ready，之后中断不再写入，缓冲区归主循环所有，
+ *          SCOPE_Fft_Rearm 清除标志后重新交给中断 (与采集记录的冻结窗口相同)。
+ *          缓冲区先按 int16 存放实数采样 (相对零点的 Q4 码值，保留高分辨率方式的小数位)，
+ *          变换后每个复数 (两个 int16) 的位置改存一个 32 位功率。
+ */
+#include "SCOPEh/SCOPE_fft.h"
+#include "SCOPEh/SCOPE_fft_table.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#define SCOPE_FFT_MAX_COMPONENT 46340 // 实部和虚部限幅，使功率不超过 32 位
+#define SCOPE_FFT_BFP_LIMIT 11520     // 块浮点：最大分量低于此值时基 2 蝶形不移位、低于一半时基 4 蝶形不移位也不会溢出 (< 32767 / 2√2)
+
+static int16_t *fft_buf = NULL;                         // 采样/变换缓冲区 (采样存储区)
+static uint16_t fft_size = 1024;                        // 点数
+static uint8_t fft_channel = 0;                         // 通道
+static SCOPE_Fft_Window fft_window = SCOPE_FFT_HANN;    // 窗函数
+static volatile uint16_t fft_count = 0;                 // 已收集的采样数
+static volatile uint8_t fft_ready = 0;                  // 一帧已收集完，缓冲区归主循环所有
+static uint8_t fft_exponent = 0;                        // 块浮点指数：各级少移的位数之和
+
+/**
+ * @brief 各窗函数的表 (矩形窗为 NULL)
+ */
+static const int16_t *const fft_window_table[] = {
+	NULL, SCOPE_Fft_Hann_Table, SCOPE_Fft_Hamming_Table, SCOPE_Fft_BlackmanHarris_Table, SCOPE_Fft_Flattop_Table};
+
+/**
+ * @brief 各窗函数的相干增益 (窗的平均值，即 a0)
+ */
+static const float fft_window_gain[] = {1.0f, 0.5f, 0.54f, 0.35875f, 0.21557895f};
+
+/**
+ * @brief 各窗函数的等效噪声带宽 (频点)
+ */
+static const float fft_window_enbw[] = {1.0f, 1.5f, 1.3628f, 2.0044f, 3.7702f};
+
+/**
+ * @brief 各窗函数主瓣 (含近处旁瓣) 的半宽 (频点)，计算谐波时整体计入一个分量
+ */
+static const uint8_t fft_window_lobe[] = {2, 6, 6, 5, 6};
+
+/**
+ * @brief  查表求正弦
+ * @param  k 角度，单位 2π/1024
+ * @retval sin (Q15)
+ */
+static inline int32_t SCOPE_Fft_Sin(uint16_t k)
+{
+	k &= SCOPE_FFT_MAX_SIZE - 1;
+	if (k <= 256)
+		return SCOPE_Fft_Sin_Table[k];
+	if (k <= 512)
+		return SCOPE_Fft_Sin_Table[512 - k];
+	if (k <= 768)
+		return -SCOPE_Fft_Sin_Table[k - 512];
+	return -SCOPE_Fft_Sin_Table[1024 - k];
+}
+
+/**
+ * @brief  查表求余弦
+ * @param  k 角度，单位 2π/1024
+ * @retval cos (Q15)
+ */
+static inline int32_t SCOPE_Fft_Cos(uint16_t k)
+{
+	return SCOPE_Fft_Sin(k + 256);
+}
+
+/**
+ * @brief  限幅并求功率
+ */
+static inline uint32_t SCOPE_Fft_Power(int32_t re, int32_t im)
+{
+	if (re > SCOPE_FFT_MAX_COMPONENT || re < -SCOPE_FFT_MAX_COMPONENT)
+		re = (re > 0) ? SCOPE_FFT_MAX_COMPONENT : -SCOPE_FFT_MAX_COMPONENT;
+	if (im > SCOPE_FFT_MAX_COMPONENT || im < -SCOPE_FFT_MAX_COMPONENT)
+		im = (im > 0) ? SCOPE_FFT_MAX_COMPONENT : -SCOPE_FFT_MAX_COMPONENT;
+	return (uint32_t)(re * re) + (uint32_t)(im * im);
+}
+
+/**
+ * @brief  取得采样存储区并开始收集
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  size    点数
+ * @param  window  窗函数
+ * @retval 无
+ */
+void SCOPE_Fft_Start(uint8_t channel, uint16_t size, SCOPE_Fft_Window window)
+{
+	fft_ready = 1; // 先停止中断写入
+	fft_buf = (int16_t *)SCOPE_Smem_Claim(SCOPE_SMEM_FFT);
+	fft_size = (size >= 1024) ? 1024 : (size >= 512) ? 512 : 256;
+	fft_channel = channel & 1;
+	fft_window = (window <= SCOPE_FFT_FLATTOP) ? window : SCOPE_FFT_HANN;
+	SCOPE_Fft_Rearm();
+}
+
+/**
+ * @brief  追加一个采样
+ * @param  q4 Q4 码值
+ */
+static inline void SCOPE_Fft_Put(uint16_t q4)
+{
+	uint16_t n = fft_count;
+	fft_buf[n++] = (int16_t)(q4 - (SCOPE_ADC_ZERO_CODE << SCOPE_DECIM_HIRES_BITS));
+	fft_count = n;
+	if (n == fft_size)
+		fft_ready = 1;
+}
+
+/**
+ * @brief  数据块输出 (普通/高分辨率方式)
+ * @param  words 每列一个打包的数据字
+ * @param  count 字数
+ * @param  mode  采集模式
+ * @retval 无
+ */
+void SCOPE_Fft_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	if (fft_ready || fft_buf == NULL || !SCOPE_Acq_Has_Channel(mode, fft_channel) || SCOPE_Smem_Get_Owner() != SCOPE_SMEM_FFT)
+		return;
+
+	const uint8_t frac_bits = SCOPE_Decim_Get_Frac_Bits();
+	uint16_t samples = count * SCOPE_Acq_Samples_Per_Word(mode);
+	for (uint16_t i = 0; i < samples && !fft_ready; i++)
+		SCOPE_Fft_Put(SCOPE_Decim_Sample_Q4(words, mode, fft_channel, i, frac_bits));
+}
+
+/**
+ * @brief  包络输出 (峰值检测方式)
+ * @param  min_words 每列各通道的最小值
+ * @param  max_words 每列各通道的最大值
+ * @param  count     列数
+ * @retval 无
+ */
+void SCOPE_Fft_Envelope_Block(const uint32_t *min_words, const uint32_t *max_words, uint16_t count)
+{
+	if (fft_ready || fft_buf == NULL || SCOPE_Smem_Get_Owner() != SCOPE_SMEM_FFT)
+		return;
+
+	uint8_t shift = fft_channel ? 16 : 0;
+	for (uint16_t i = 0; i < count && !fft_ready; i++)
+		SCOPE_Fft_Put((uint16_t)((((min_words[i] >> shift) & 0xFFFF) + ((max_words[i] >> shift) & 0xFFFF)) << (SCOPE_DECIM_HIRES_BITS - 1)));
+}
+
+/**
+ * @brief  查询一帧是否已收集完
+ * @retval 1: 已收集完，0: 正在收集
+ */
+uint8_t SCOPE_Fft_Ready(void)
+{
+	return fft_ready && fft_buf != NULL && fft_count == fft_size && SCOPE_Smem_Get_Owner() == SCOPE_SMEM_FFT;
+}
+
+/**
+ * @brief  加窗并原地变换
+ * @retval 无
+ */
+void SCOPE_Fft_Compute(void)
+{
+	if (!SCOPE_Fft_Ready())
+		return;
+
+	int16_t *x = fft_buf;
+	uint16_t n = fft_size;
+	uint16_t m = n / 2;
+
+	// 加窗，Q4 码值正好占满 Q15 范围；表为长度 1024 的窗的前半部分
+	const int16_t *table = fft_window_table[fft_window];
+	uint16_t step = SCOPE_FFT_MAX_SIZE / n;
+	uint16_t peak = 0;
+	for (uint16_t i = 0; i < n; i++)
+	{
+		int32_t v = x[i];
+		if (table != NULL)
+			v = (v * table[((i <= m) ? i : n - i) * step] + 0x4000) >> 15;
+		x[i] = (int16_t)v;
+		uint16_t mag = (v < 0) ? -v : v;
+		if (mag > peak)
+			peak = mag;
+	}
+
+	// m 点复数 FFT：位反转重排
+	uint32_t *pairs = (uint32_t *)x;
+	for (uint16_t i = 1, j = 0; i < m; i++)
+	{
+		uint16_t bit = m >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j)
+		{
+			uint32_t t = pairs[i];
+			pairs[i] = pairs[j];
+			pairs[j] = t;
+		}
+	}
+
+	// 块浮点：上一级结果的最大分量超过限值时本级右移，否则不移位并记入指数 (指数按基 2 级计)
+	fft_exponent = 0;
+	uint16_t len = 1;
+
+	// 级数为奇数 (m = 128、512) 时先做一级基 2，旋转因子都为 1
+	if ((m & 0x0AAA) != 0)
+	{
+		uint8_t shift = (peak >= SCOPE_FFT_BFP_LIMIT) ? 1 : 0;
+		fft_exponent += 1 - shift;
+		peak = 0;
+		for (uint16_t i = 0; i < m; i += 2)
+		{
+			int16_t *a = &x[2 * i];
+			int32_t v[4] = {(a[0] + a[2] + shift) >> shift, (a[1] + a[3] + shift) >> shift,
+							(a[0] - a[2] + shift) >> shift, (a[1] - a[3] + shift) >> shift};
+			for (uint8_t c = 0; c < 4; c++)
+			{
+				a[c] = (int16_t)v[c];
+				uint16_t mag = (v[c] < 0) ? -v[c] : v[c];
+				if (mag > peak)
+					peak = mag;
+			}
+		}
+		len = 2;
+	}
+
+	// 基 4 蝶形：位反转顺序下长度 4q 的块依次是 x[4n]、x[4n+2]、x[4n+1]、x[4n+3] 的 q 点变换
+	// a = A0，b = W^2j A1，c = W^j A2，d = W^3j A3 (W = e^(-j2π/4q))
+	// X[j] = a + b + c + d，X[j+q] = a - b - j(c - d)，X[j+2q] = a + b - c - d，X[j+3q] = a - b + j(c - d)
+	for (; len < m; len <<= 2)
+	{
+		uint8_t shift = (peak >= SCOPE_FFT_BFP_LIMIT) ? 2 : (peak >= SCOPE_FFT_BFP_LIMIT / 2) ? 1 : 0;
+		int32_t round = (1 << shift) >> 1;
+		fft_exponent += 2 - shift;
+		peak = 0;
+		uint16_t q = len;
+		uint16_t angle = SCOPE_FFT_MAX_SIZE / (4 * q);
+		for (uint16_t j = 0; j < q; j++)
+		{
+			int32_t w1r = SCOPE_Fft_Cos(j * angle), w1i = -SCOPE_Fft_Sin(j * angle);
+			int32_t w2r = SCOPE_Fft_Cos(2 * j * angle), w2i = -SCOPE_Fft_Sin(2 * j * angle);
+			int32_t w3r = SCOPE_Fft_Cos(3 * j * angle), w3i = -SCOPE_Fft_Sin(3 * j * angle);
+			for (uint16_t i = j; i < m; i += 4 * q)
+			{
+				int16_t *p0 = &x[2 * i];
+				int16_t *p1 = &x[2 * (i + q)];
+				int16_t *p2 = &x[2 * (i + 2 * q)];
+				int16_t *p3 = &x[2 * (i + 3 * q)];
+				int32_t ar = p0[0], ai = p0[1];
+				int32_t br = (p1[0] * w2r - p1[1] * w2i + 0x4000) >> 15;
+				int32_t bi = (p1[0] * w2i + p1[1] * w2r + 0x4000) >> 15;
+				int32_t cr = (p2[0] * w1r - p2[1] * w1i + 0x4000) >> 15;
+				int32_t ci = (p2[0] * w1i + p2[1] * w1r + 0x4000) >> 15;
+				int32_t dr = (p3[0] * w3r - p3[1] * w3i + 0x4000) >> 15;
+				int32_t di = (p3[0] * w3i + p3[1] * w3r + 0x4000) >> 15;
+				int32_t sr = ar + br, si = ai + bi, tr = ar - br, ti = ai - bi;
+				int32_t ur = cr + dr, ui = ci + di, vr = cr - dr, vi = ci - di;
+				int32_t v[8] = {(sr + ur + round) >> shift, (si + ui + round) >> shift,
+								(tr + vi + round) >> shift, (ti - vr + round) >> shift,
+								(sr - ur + round) >> shift, (si - ui + round) >> shift,
+								(tr - vi + round) >> shift, (ti + vr + round) >> shift};
+				p0[0] = (int16_t)v[0];
+				p0[1] = (int16_t)v[1];
+				p1[0] = (int16_t)v[2];
+				p1[1] = (int16_t)v[3];
+				p2[0] = (int16_t)v[4];
+				p2[1] = (int16_t)v[5];
+				p3[0] = (int16_t)v[6];
+				p3[1] = (int16_t)v[7];
+				for (uint8_t c = 0; c < 8; c++)
+				{
+					uint16_t mag = (v[c] < 0) ? -v[c] : v[c];
+					if (mag > peak)
+						peak = mag;
+				}
+			}
+		}
+	}
+
+	// 拆分出实数序列的频点：偶数采样的变换 E 与奇数采样的变换 O 合成
+	// X[k] = E[k] + W^k O[k]，X[m-k] = conj(E[k] - W^k O[k])，W = e^(-j2π/n)
+	uint32_t dc = SCOPE_Fft_Power(x[0] + x[1], 0);
+	for (uint16_t k = 1; k <= m / 2; k++)
+	{
+		int32_t ar = x[2 * k], ai = x[2 * k + 1];
+		int32_t br = x[2 * (m - k)], bi = x[2 * (m - k) + 1];
+		int32_t er = (ar + br) >> 1, ei = (ai - bi) >> 1;
+		int32_t or_ = (ai + bi) >> 1, oi = (br - ar) >> 1;
+		int32_t wr = SCOPE_Fft_Cos(k * step);
+		int32_t wi = -SCOPE_Fft_Sin(k * step);
+		int32_t tr = (or_ * wr - oi * wi) >> 15;
+		int32_t ti = (or_ * wi + oi * wr) >> 15;
+		uint32_t p_k = SCOPE_Fft_Power(er + tr, ei + ti);
+		uint32_t p_mk = SCOPE_Fft_Power(er - tr, ti - ei);
+		pairs[k] = p_k;
+		pairs[m - k] = p_mk;
+	}
+	pairs[0] = dc;
+}
+
+/**
+ * @brief  开始收集下一帧
+ * @retval 无
+ */
+void SCOPE_Fft_Rearm(void)
+{
+	fft_count = 0;
+	fft_ready = 0;
+}
+
+/**
+ * @brief  获取频点数
+ * @retval N / 2
+ */
+uint16_t SCOPE_Fft_Get_Bins(void)
+{
+	return fft_size / 2;
+}
+
+/**
+ * @brief  获取一个频点的功率
+ * @param  bin 频点
+ * @retval 功率
+ */
+uint32_t SCOPE_Fft_Get_Power(uint16_t bin)
+{
+	if (fft_buf == NULL || bin >= fft_size / 2)
+		return 0;
+	return ((const uint32_t *)fft_buf)[bin];
+}
+
+/**
+ * @brief  获取窗函数主瓣的半宽
+ * @retval 频点数
+ */
+uint8_t SCOPE_Fft_Get_Lobe(void)
+{
+	return fft_window_lobe[fft_window];
+}
+
+/**
+ * @brief  获取窗函数的等效噪声带宽
+ * @retval 频点数
+ */
+float SCOPE_Fft_Get_Enbw(void)
+{
+	return fft_window_enbw[fft_window];
+}
+
+/**
+ * @brief  功率换算为 dBV
+ * @param  power 功率
+ * @retval dBV
+ * @note   幅度为 A 码值的正弦：sqrt(功率) = 16 * A * 相干增益 * 2^指数，有效值 = A / 每伏码值 / √2
+ */
+float SCOPE_Fft_Power_To_Dbv(float power)
+{
+	if (power <= 0)
+		return -200.0f;
+	float full = 16.0f * fft_window_gain[fft_window] * SCOPE_CODES_PER_VOLT * 1.41421356f;
+	return 10.0f * log10f(power) - 20.0f * log10f(full) - 6.0206f * fft_exponent;
+}
+
+/**
+ * @brief  把频谱转换为屏幕Y坐标
+ * @param  max_y      输出：每列最大值的屏幕Y坐标
+ * @param  min_y      输出：每列最小值的屏幕Y坐标
+ * @param  points     列数
+ * @param  top_dbv    屏幕顶部对应的电平 (dBV)
+ * @param  db_per_div 每格的分贝数
+ * @retval 无
+ * @note   频点多于列数时一列覆盖多个频点，画出其中的最大值到最小值 (与峰值检测相同)
+ */
+void SCOPE_Fft_To_Screen(uint16_t *max_y, uint16_t *min_y, uint16_t points, float top_dbv, float db_per_div)
+{
+	uint16_t bins = fft_size / 2;
+	float pixels_per_db = (float)(SCOPE_PLOT_HEIGHT / SCOPE_DIVS_Y) / db_per_div;
+
+	for (uint16_t c = 0; c < points; c++)
+	{
+		uint16_t b0 = (uint32_t)c * bins / points;
+		uint16_t b1 = (uint32_t)(c + 1) * bins / points;
+		if (b1 <= b0)
+			b1 = b0 + 1;
+
+		uint32_t hi = 0, lo = 0xFFFFFFFF;
+		for (uint16_t b = b0; b < b1; b++)
+		{
+			uint32_t p = SCOPE_Fft_Get_Power(b);
+			if (p > hi)
+				hi = p;
+			if (p < lo)
+				lo = p;
+		}
+
+		float y_hi = (top_dbv - SCOPE_Fft_Power_To_Dbv(hi)) * pixels_per_db;
+		float y_lo = (top_dbv - SCOPE_Fft_Power_To_Dbv(lo)) * pixels_per_db;
+		max_y[c] = (y_hi < 0) ? 0 : (y_hi > SCOPE_PLOT_HEIGHT - 1) ? SCOPE_PLOT_HEIGHT - 1 : (uint16_t)y_hi;
+		min_y[c] = (y_lo < 0) ? 0 : (y_lo > SCOPE_PLOT_HEIGHT - 1) ? SCOPE_PLOT_HEIGHT - 1 : (uint16_t)y_lo;
+	}
+}
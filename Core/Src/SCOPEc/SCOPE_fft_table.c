@@ -0,0 +1,233 @@
+/**
+ * @file    SCOPE_fft_table.c
+ * @brief   示波器频谱分析常数表 (放在 Flash 中)
+ * @details 正弦表为 1/4 周期，窗函数为长度 1024 的周期窗的前半部分 (对称)，
+ *          较短的变换按步长取值。窗函数为余弦和窗：
+ *          w(n) = a0 - a1 cos(2πn/N) + a2 cos(4πn/N) - a3 cos(6πn/N) + a4 cos(8πn/N)
+ */
+#include "SCOPEh/SCOPE_fft_table.h"
+#include <stdint.h>
+
+/**
+ * @brief sin(2πk/1024)，k = 0 ~ 256 (Q15)
+ */
+const int16_t SCOPE_Fft_Sin_Table[257] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+    2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+    4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+    7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+    9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767,
+};
+
+/**
+ * @brief Hann 窗 (a0 = 0.5, a1 = 0.5)，n = 0 ~ 512 (Q15)
+ */
+const int16_t SCOPE_Fft_Hann_Table[513] = {
+    0, 0, 1, 3, 5, 8, 11, 15, 20, 25, 31, 37,
+    44, 52, 60, 69, 79, 89, 100, 111, 123, 136, 149, 163,
+    177, 192, 208, 224, 241, 259, 277, 295, 315, 335, 355, 376,
+    398, 420, 443, 467, 491, 516, 541, 567, 593, 621, 648, 677,
+    705, 735, 765, 796, 827, 859, 891, 924, 958, 992, 1027, 1062,
+    1098, 1134, 1171, 1209, 1247, 1286, 1325, 1365, 1406, 1447, 1488, 1530,
+    1573, 1616, 1660, 1704, 1749, 1795, 1841, 1887, 1935, 1982, 2030, 2079,
+    2128, 2178, 2229, 2279, 2331, 2383, 2435, 2488, 2542, 2596, 2650, 2706,
+    2761, 2817, 2874, 2931, 2989, 3047, 3105, 3165, 3224, 3284, 3345, 3406,
+    3468, 3530, 3592, 3655, 3719, 3783, 3847, 3912, 3978, 4044, 4110, 4177,
+    4244, 4312, 4380, 4449, 4518, 4587, 4657, 4728, 4799, 4870, 4942, 5014,
+    5086, 5159, 5233, 5307, 5381, 5456, 5531, 5606, 5682, 5759, 5835, 5912,
+    5990, 6068, 6146, 6225, 6304, 6383, 6463, 6543, 6624, 6705, 6786, 6868,
+    6950, 7032, 7115, 7198, 7281, 7365, 7449, 7534, 7618, 7703, 7789, 7875,
+    7961, 8047, 8134, 8221, 8308, 8396, 8484, 8572, 8660, 8749, 8838, 8928,
+    9017, 9107, 9197, 9288, 9379, 9470, 9561, 9652, 9744, 9836, 9929, 10021,
+    10114, 10207, 10300, 10393, 10487, 10581, 10675, 10770, 10864, 10959, 11054, 11149,
+    11244, 11340, 11436, 11532, 11628, 11724, 11820, 11917, 12014, 12111, 12208, 12305,
+    12403, 12500, 12598, 12696, 12794, 12892, 12990, 13089, 13187, 13286, 13385, 13484,
+    13583, 13682, 13781, 13880, 13980, 14079, 14179, 14278, 14378, 14478, 14578, 14678,
+    14778, 14878, 14978, 15078, 15178, 15279, 15379, 15479, 15580, 15680, 15780, 15881,
+    15981, 16082, 16182, 16283, 16383, 16484, 16585, 16685, 16786, 16886, 16987, 17087,
+    17187, 17288, 17388, 17488, 17589, 17689, 17789, 17889, 17989, 18089, 18189, 18289,
+    18389, 18489, 18588, 18688, 18787, 18887, 18986, 19085, 19184, 19283, 19382, 19481,
+    19580, 19678, 19777, 19875, 19973, 20071, 20169, 20267, 20364, 20462, 20559, 20656,
+    20753, 20850, 20947, 21043, 21139, 21235, 21331, 21427, 21523, 21618, 21713, 21808,
+    21903, 21997, 22092, 22186, 22280, 22374, 22467, 22560, 22653, 22746, 22838, 22931,
+    23023, 23115, 23206, 23297, 23388, 23479, 23570, 23660, 23750, 23839, 23929, 24018,
+    24107, 24195, 24283, 24371, 24459, 24546, 24633, 24720, 24806, 24892, 24978, 25064,
+    25149, 25233, 25318, 25402, 25486, 25569, 25652, 25735, 25817, 25899, 25981, 26062,
+    26143, 26224, 26304, 26384, 26463, 26542, 26621, 26699, 26777, 26855, 26932, 27008,
+    27085, 27161, 27236, 27311, 27386, 27460, 27534, 27608, 27681, 27753, 27825, 27897,
+    27968, 28039, 28110, 28180, 28249, 28318, 28387, 28455, 28523, 28590, 28657, 28723,
+    28789, 28855, 28920, 28984, 29048, 29112, 29175, 29237, 29299, 29361, 29422, 29483,
+    29543, 29602, 29662, 29720, 29778, 29836, 29893, 29950, 30006, 30061, 30117, 30171,
+    30225, 30279, 30332, 30384, 30436, 30488, 30538, 30589, 30639, 30688, 30737, 30785,
+    30832, 30880, 30926, 30972, 31018, 31063, 31107, 31151, 31194, 31237, 31279, 31320,
+    31361, 31402, 31442, 31481, 31520, 31558, 31596, 31633, 31669, 31705, 31740, 31775,
+    31809, 31843, 31876, 31908, 31940, 31971, 32002, 32032, 32062, 32090, 32119, 32146,
+    32174, 32200, 32226, 32251, 32276, 32300, 32324, 32347, 32369, 32391, 32412, 32432,
+    32452, 32472, 32490, 32508, 32526, 32543, 32559, 32575, 32590, 32604, 32618, 32631,
+    32644, 32656, 32667, 32678, 32688, 32698, 32707, 32715, 32723, 32730, 32736, 32742,
+    32747, 32752, 32756, 32759, 32762, 32764, 32766, 32767, 32767,
+};
+
+/**
+ * @brief Hamming 窗 (a0 = 0.54, a1 = 0.46)，n = 0 ~ 512 (Q15)
+ */
+const int16_t SCOPE_Fft_Hamming_Table[513] = {
+    2621, 2622, 2622, 2624, 2626, 2628, 2632, 2635, 2640, 2644, 2650, 2656,
+    2662, 2669, 2677, 2685, 2694, 2703, 2713, 2724, 2735, 2746, 2758, 2771,
+    2785, 2798, 2813, 2828, 2843, 2859, 2876, 2893, 2911, 2929, 2948, 2968,
+    2988, 3008, 3029, 3051, 3073, 3096, 3119, 3143, 3167, 3192, 3218, 3244,
+    3270, 3298, 3325, 3353, 3382, 3411, 3441, 3472, 3502, 3534, 3566, 3598,
+    3631, 3665, 3699, 3734, 3769, 3804, 3841, 3877, 3914, 3952, 3990, 4029,
+    4069, 4108, 4149, 4189, 4231, 4273, 4315, 4358, 4401, 4445, 4489, 4534,
+    4580, 4625, 4672, 4718, 4766, 4814, 4862, 4911, 4960, 5010, 5060, 5110,
+    5162, 5213, 5265, 5318, 5371, 5424, 5478, 5533, 5588, 5643, 5699, 5755,
+    5812, 5869, 5926, 5984, 6043, 6102, 6161, 6221, 6281, 6342, 6403, 6464,
+    6526, 6588, 6651, 6714, 6778, 6842, 6906, 6971, 7036, 7102, 7168, 7234,
+    7301, 7368, 7436, 7504, 7572, 7641, 7710, 7779, 7849, 7919, 7990, 8061,
+    8132, 8204, 8276, 8348, 8421, 8494, 8567, 8641, 8715, 8790, 8865, 8940,
+    9015, 9091, 9167, 9243, 9320, 9397, 9475, 9552, 9630, 9709, 9787, 9866,
+    9945, 10025, 10104, 10184, 10265, 10345, 10426, 10507, 10589, 10671, 10753, 10835,
+    10917, 11000, 11083, 11166, 11250, 11333, 11417, 11502, 11586, 11671, 11756, 11841,
+    11926, 12012, 12097, 12183, 12270, 12356, 12443, 12529, 12616, 12703, 12791, 12878,
+    12966, 13054, 13142, 13230, 13319, 13407, 13496, 13585, 13674, 13763, 13853, 13942,
+    14032, 14122, 14211, 14302, 14392, 14482, 14572, 14663, 14754, 14844, 14935, 15026,
+    15117, 15208, 15300, 15391, 15483, 15574, 15666, 15757, 15849, 15941, 16033, 16125,
+    16217, 16309, 16401, 16493, 16585, 16678, 16770, 16862, 16955, 17047, 17139, 17232,
+    17324, 17417, 17509, 17602, 17694, 17787, 17879, 17972, 18064, 18157, 18249, 18341,
+    18434, 18526, 18618, 18711, 18803, 18895, 18987, 19080, 19172, 19264, 19356, 19447,
+    19539, 19631, 19723, 19814, 19906, 19997, 20089, 20180, 20271, 20362, 20453, 20544,
+    20635, 20725, 20816, 20906, 20997, 21087, 21177, 21267, 21357, 21446, 21536, 21625,
+    21714, 21803, 21892, 21981, 22070, 22158, 22246, 22334, 22422, 22510, 22598, 22685,
+    22772, 22859, 22946, 23032, 23119, 23205, 23291, 23377, 23462, 23548, 23633, 23718,
+    23802, 23887, 23971, 24055, 24139, 24222, 24305, 24388, 24471, 24554, 24636, 24718,
+    24799, 24881, 24962, 25043, 25124, 25204, 25284, 25364, 25443, 25522, 25601, 25680,
+    25758, 25836, 25914, 25991, 26068, 26145, 26221, 26297, 26373, 26449, 26524, 26599,
+    26673, 26747, 26821, 26894, 26967, 27040, 27113, 27185, 27256, 27328, 27399, 27469,
+    27539, 27609, 27679, 27748, 27816, 27885, 27953, 28020, 28088, 28154, 28221, 28287,
+    28352, 28417, 28482, 28547, 28611, 28674, 28737, 28800, 28862, 28924, 28986, 29047,
+    29107, 29168, 29227, 29287, 29346, 29404, 29462, 29520, 29577, 29633, 29690, 29745,
+    29801, 29856, 29910, 29964, 30017, 30071, 30123, 30175, 30227, 30278, 30329, 30379,
+    30429, 30478, 30527, 30575, 30623, 30670, 30717, 30763, 30809, 30854, 30899, 30943,
+    30987, 31031, 31073, 31116, 31158, 31199, 31240, 31280, 31320, 31359, 31398, 31436,
+    31474, 31511, 31548, 31584, 31620, 31655, 31689, 31723, 31757, 31790, 31823, 31854,
+    31886, 31917, 31947, 31977, 32006, 32035, 32063, 32091, 32118, 32145, 32171, 32196,
+    32221, 32245, 32269, 32293, 32315, 32337, 32359, 32380, 32401, 32421, 32440, 32459,
+    32477, 32495, 32512, 32529, 32545, 32561, 32576, 32590, 32604, 32617, 32630, 32642,
+    32654, 32665, 32675, 32685, 32694, 32703, 32711, 32719, 32726, 32733, 32739, 32744,
+    32749, 32753, 32757, 32760, 32762, 32764, 32766, 32767, 32767,
+};
+
+/**
+ * @brief 4 项 Blackman-Harris 窗 (a0 = 0.35875, a1 = 0.48829, a2 = 0.14128, a3 = 0.01168)，n = 0 ~ 512 (Q15)
+ */
+const int16_t SCOPE_Fft_BlackmanHarris_Table[513] = {
+    2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4,
+    5, 5, 5, 6, 7, 7, 8, 8, 9, 10, 11, 12,
+    13, 13, 14, 16, 17, 18, 19, 20, 22, 23, 24, 26,
+    27, 29, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48,
+    51, 53, 56, 58, 61, 64, 66, 69, 72, 76, 79, 82,
+    85, 89, 93, 96, 100, 104, 108, 112, 117, 121, 126, 131,
+    135, 140, 145, 151, 156, 162, 167, 173, 179, 185, 191, 198,
+    204, 211, 218, 225, 233, 240, 248, 256, 264, 272, 281, 289,
+    298, 307, 316, 326, 336, 346, 356, 366, 377, 388, 399, 410,
+    422, 434, 446, 458, 471, 484, 497, 510, 524, 538, 552, 567,
+    582, 597, 613, 628, 644, 661, 678, 695, 712, 730, 748, 767,
+    785, 804, 824, 844, 864, 885, 906, 927, 949, 971, 993, 1016,
+    1039, 1063, 1087, 1112, 1137, 1162, 1188, 1214, 1241, 1268, 1295, 1323,
+    1352, 1381, 1410, 1440, 1470, 1501, 1532, 1564, 1596, 1629, 1662, 1695,
+    1730, 1764, 1800, 1835, 1872, 1908, 1946, 1983, 2022, 2061, 2100, 2140,
+    2181, 2222, 2264, 2306, 2349, 2392, 2436, 2481, 2526, 2572, 2618, 2665,
+    2712, 2761, 2809, 2859, 2909, 2959, 3010, 3062, 3115, 3168, 3222, 3276,
+    3331, 3387, 3443, 3500, 3557, 3616, 3675, 3734, 3794, 3855, 3917, 3979,
+    4042, 4105, 4170, 4235, 4300, 4366, 4433, 4501, 4569, 4638, 4708, 4779,
+    4850, 4922, 4994, 5067, 5141, 5216, 5291, 5367, 5444, 5521, 5599, 5678,
+    5758, 5838, 5919, 6000, 6083, 6166, 6250, 6334, 6419, 6505, 6592, 6679,
+    6767, 6856, 6945, 7035, 7126, 7217, 7309, 7402, 7496, 7590, 7685, 7781,
+    7877, 7974, 8072, 8170, 8269, 8369, 8469, 8570, 8672, 8774, 8877, 8981,
+    9085, 9190, 9296, 9402, 9509, 9617, 9725, 9834, 9943, 10053, 10164, 10275,
+    10387, 10499, 10613, 10726, 10840, 10955, 11071, 11187, 11303, 11420, 11538, 11656,
+    11775, 11894, 12014, 12134, 12255, 12376, 12498, 12620, 12743, 12866, 12990, 13114,
+    13239, 13364, 13489, 13615, 13741, 13868, 13995, 14123, 14251, 14379, 14508, 14637,
+    14767, 14896, 15027, 15157, 15288, 15419, 15550, 15682, 15814, 15946, 16079, 16212,
+    16345, 16478, 16611, 16745, 16879, 17013, 17147, 17282, 17416, 17551, 17686, 17821,
+    17956, 18091, 18226, 18362, 18497, 18633, 18768, 18904, 19040, 19175, 19311, 19446,
+    19582, 19718, 19853, 19989, 20124, 20259, 20395, 20530, 20665, 20800, 20934, 21069,
+    21203, 21337, 21471, 21605, 21739, 21872, 22005, 22138, 22271, 22403, 22535, 22667,
+    22798, 22929, 23060, 23190, 23320, 23450, 23579, 23708, 23836, 23964, 24091, 24218,
+    24345, 24471, 24596, 24721, 24846, 24970, 25093, 25216, 25338, 25460, 25581, 25701,
+    25821, 25940, 26059, 26177, 26294, 26410, 26526, 26641, 26755, 26869, 26982, 27094,
+    27205, 27316, 27425, 27534, 27642, 27749, 27856, 27961, 28066, 28169, 28272, 28374,
+    28475, 28575, 28674, 28772, 28870, 28966, 29061, 29155, 29249, 29341, 29432, 29522,
+    29611, 29699, 29786, 29872, 29957, 30041, 30123, 30205, 30285, 30364, 30442, 30519,
+    30595, 30670, 30743, 30815, 30886, 30956, 31024, 31092, 31158, 31223, 31286, 31349,
+    31410, 31470, 31528, 31586, 31642, 31696, 31750, 31802, 31853, 31902, 31950, 31997,
+    32043, 32087, 32130, 32171, 32211, 32250, 32287, 32323, 32358, 32391, 32423, 32453,
+    32482, 32510, 32536, 32561, 32585, 32607, 32627, 32646, 32664, 32681, 32696, 32709,
+    32721, 32732, 32741, 32749, 32756, 32761, 32764, 32766, 32767,
+};
+
+/**
+ * @brief 平顶窗 (a0 = 0.21557895, a1 = 0.41663158, a2 = 0.277263158, a3 = 0.083578947, a4 = 0.006947368)，n = 0 ~ 512 (Q15)
+ */
+const int16_t SCOPE_Fft_Flattop_Table[513] = {
+    -14, -14, -14, -14, -14, -15, -15, -15, -16, -16, -17, -18,
+    -18, -19, -20, -21, -22, -23, -24, -25, -27, -28, -30, -31,
+    -33, -34, -36, -38, -40, -42, -44, -46, -48, -50, -53, -55,
+    -58, -61, -63, -66, -69, -72, -75, -79, -82, -85, -89, -93,
+    -96, -100, -104, -108, -113, -117, -121, -126, -131, -135, -140, -145,
+    -151, -156, -161, -167, -173, -178, -184, -191, -197, -203, -210, -217,
+    -224, -231, -238, -245, -253, -260, -268, -276, -284, -292, -301, -309,
+    -318, -327, -336, -346, -355, -365, -375, -385, -395, -405, -416, -426,
+    -437, -448, -459, -471, -482, -494, -506, -518, -531, -543, -556, -569,
+    -582, -595, -609, -622, -636, -650, -664, -678, -693, -708, -723, -738,
+    -753, -768, -784, -799, -815, -831, -848, -864, -881, -897, -914, -931,
+    -948, -965, -983, -1000, -1018, -1036, -1054, -1072, -1090, -1109, -1127, -1146,
+    -1164, -1183, -1202, -1221, -1240, -1259, -1278, -1297, -1316, -1336, -1355, -1375,
+    -1394, -1414, -1433, -1453, -1472, -1492, -1511, -1531, -1551, -1570, -1590, -1609,
+    -1628, -1648, -1667, -1686, -1705, -1724, -1743, -1762, -1781, -1799, -1818, -1836,
+    -1854, -1872, -1890, -1907, -1924, -1941, -1958, -1975, -1991, -2008, -2023, -2039,
+    -2054, -2069, -2084, -2098, -2112, -2126, -2139, -2152, -2165, -2177, -2188, -2200,
+    -2210, -2221, -2231, -2240, -2249, -2257, -2265, -2272, -2279, -2285, -2291, -2296,
+    -2300, -2304, -2307, -2309, -2311, -2312, -2312, -2312, -2311, -2309, -2306, -2302,
+    -2298, -2293, -2287, -2281, -2273, -2264, -2255, -2245, -2234, -2222, -2208, -2194,
+    -2179, -2163, -2146, -2128, -2109, -2089, -2068, -2046, -2022, -1998, -1972, -1945,
+    -1917, -1888, -1858, -1826, -1794, -1760, -1724, -1688, -1650, -1611, -1571, -1529,
+    -1486, -1442, -1396, -1349, -1301, -1251, -1200, -1147, -1093, -1038, -981, -922,
+    -863, -801, -739, -674, -609, -541, -472, -402, -330, -257, -182, -105,
+    -27, 53, 134, 217, 302, 388, 476, 565, 656, 749, 843, 939,
+    1036, 1135, 1236, 1339, 1443, 1549, 1656, 1765, 1876, 1988, 2102, 2218,
+    2336, 2455, 2575, 2698, 2822, 2947, 3074, 3203, 3334, 3466, 3600, 3735,
+    3872, 4011, 4151, 4293, 4436, 4581, 4728, 4876, 5025, 5177, 5329, 5484,
+    5639, 5797, 5955, 6115, 6277, 6440, 6605, 6770, 6938, 7106, 7277, 7448,
+    7621, 7795, 7970, 8147, 8325, 8504, 8684, 8866, 9049, 9233, 9418, 9604,
+    9791, 9980, 10169, 10359, 10551, 10743, 10937, 11131, 11326, 11523, 11720, 11918,
+    12116, 12316, 12516, 12717, 12918, 13121, 13324, 13527, 13731, 13936, 14141, 14347,
+    14553, 14760, 14967, 15174, 15382, 15590, 15798, 16006, 16215, 16424, 16633, 16842,
+    17051, 17260, 17470, 17679, 17888, 18097, 18306, 18515, 18723, 18931, 19139, 19347,
+    19554, 19761, 19968, 20174, 20380, 20585, 20789, 20993, 21196, 21399, 21601, 21802,
+    22002, 22202, 22401, 22598, 22795, 22991, 23186, 23380, 23573, 23764, 23955, 24144,
+    24332, 24519, 24705, 24889, 25072, 25254, 25434, 25612, 25789, 25965, 26139, 26312,
+    26482, 26652, 26819, 26985, 27149, 27311, 27471, 27630, 27786, 27941, 28093, 28244,
+    28393, 28539, 28684, 28826, 28967, 29105, 29241, 29375, 29506, 29636, 29762, 29887,
+    30009, 30129, 30247, 30362, 30475, 30585, 30692, 30798, 30900, 31000, 31098, 31193,
+    31285, 31375, 31462, 31546, 31627, 31706, 31783, 31856, 31927, 31995, 32060, 32122,
+    32182, 32238, 32292, 32343, 32391, 32437, 32479, 32519, 32555, 32589, 32620, 32648,
+    32673, 32695, 32714, 32730, 32743, 32754, 32761, 32766, 32767,
+};
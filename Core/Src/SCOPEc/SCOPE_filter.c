@@ -0,0 +1,244 @@
+/**
+ * @file    SCOPE_filter.c
+ * @brief   示波器数字耦合与带宽限制实现
+ * @details 每个数据块按通道各扫描一遍，状态在扫描期间放在局部变量中，结束时写回。
+ *          中间结果为 Q2 码值 (0V 为 0)：
+ *          - 交流耦合：直流估计 dc (Q16) 每个采样向输入靠近 1/2^k，输出为输入减去 dc，
+ *            即下限频率为 fs / (2π 2^k) 的一阶高通，k 按采样率取整
+ *          - 带宽限制：直接 I 型二阶节，系数 Q14，32 位累加；舍去的低位加入下一个采样 (一阶误差反馈)，
+ *            极点靠近 1 时舍入噪声不会被放大。分子系数取整后修正 b1，直流增益严格为 1
+ */
+#include "SCOPEh/SCOPE_filter.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include <stdint.h>
+#include <math.h>
+
+#define SCOPE_FILTER_Q 14            // 二阶节系数的小数位数
+#define SCOPE_FILTER_AC_MAX_SHIFT 16 // 直流估计为 Q16，时间常数再长时跟踪误差超过 1 个码值
+
+/**
+ * @brief 二阶节系数 (Q14)
+ */
+typedef struct
+{
+	int32_t b0, b1, b2; // 分子
+	int32_t a1, a2;     // 分母取负 (y = b0 x + b1 x1 + b2 x2 + a1 y1 + a2 y2)
+} SCOPE_Filter_Coef;
+
+/**
+ * @brief 二阶节状态
+ */
+typedef struct
+{
+	int32_t x1, x2; // 前两个输入 (Q2)
+	int32_t y1, y2; // 前两个输出 (Q2)
+	int32_t err;    // 上一次舍去的低位
+} SCOPE_Filter_Section;
+
+/**
+ * @brief 一个通道的滤波器状态
+ */
+typedef struct
+{
+	int32_t dc; // 直流估计 (Q16 码值)
+	SCOPE_Filter_Section sec[SCOPE_FILTER_BWL_STAGES];
+} SCOPE_Filter_State;
+
+static volatile uint8_t filter_ac[2] = {0, 0};     // 交流耦合
+static volatile uint8_t filter_bwl[2] = {0, 0};    // 带宽限制
+static volatile uint8_t filter_primed[2] = {0, 0}; // 状态已用第一个采样预置
+static volatile uint8_t filter_ac_shift = 10;      // 交流耦合的 k
+static volatile uint8_t filter_bwl_usable = 0;     // 截止频率低于 0.45 倍采样率
+static SCOPE_Filter_Coef filter_coef[SCOPE_FILTER_BWL_STAGES];
+static SCOPE_Filter_State filter_state[2]; // 仅由中断访问
+
+/**
+ * @brief  系数换算为 Q14
+ */
+static inline int32_t SCOPE_Filter_Fixed(float v)
+{
+	return (int32_t)floorf(v * (1 << SCOPE_FILTER_Q) + 0.5f);
+}
+
+/**
+ * @brief  设置耦合方式
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  ac      1: 交流耦合，0: 直流耦合
+ * @retval 无
+ */
+void SCOPE_Filter_Set_Coupling(uint8_t channel, uint8_t ac)
+{
+	channel &= 1;
+	filter_ac[channel] = ac ? 1 : 0;
+	filter_primed[channel] = 0; // 带宽限制的输入也随之改变，重新预置
+}
+
+/**
+ * @brief  设置带宽限制
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  on      1: 打开，0: 关闭
+ * @retval 无
+ */
+void SCOPE_Filter_Set_Bwl(uint8_t channel, uint8_t on)
+{
+	channel &= 1;
+	filter_bwl[channel] = on ? 1 : 0;
+	filter_primed[channel] = 0;
+}
+
+/**
+ * @brief  按 ADC 采样率重新计算系数，并复位滤波器状态
+ * @param  sample_rate 每通道的 ADC 采样率 (Hz)
+ * @retval 无
+ */
+void SCOPE_Filter_Set_Rate(float sample_rate)
+{
+	if (sample_rate <= 0)
+		return;
+
+	// 交流耦合：fc = fs / (2π 2^k)
+	int32_t k = (int32_t)floorf(log2f(sample_rate / (2.0f * 3.14159265f * SCOPE_FILTER_AC_HZ)) + 0.5f);
+	filter_ac_shift = (k < 1) ? 1 : (k > SCOPE_FILTER_AC_MAX_SHIFT) ? SCOPE_FILTER_AC_MAX_SHIFT : (uint8_t)k;
+
+	// 带宽限制：巴特沃斯低通按极点拆成二阶节 (双线性变换)，Q 小的在前，中间结果不会过冲
+	filter_bwl_usable = 0;
+	if (SCOPE_FILTER_BWL_HZ < 0.45f * sample_rate)
+	{
+		float w0 = 2.0f * 3.14159265f * SCOPE_FILTER_BWL_HZ / sample_rate;
+		float cs = cosf(w0), sn = sinf(w0);
+		for (uint8_t s = 0; s < SCOPE_FILTER_BWL_STAGES; s++)
+		{
+			float q = 1.0f / (2.0f * cosf((2 * s + 1) * 3.14159265f / (4 * SCOPE_FILTER_BWL_STAGES)));
+			float alpha = sn / (2.0f * q);
+			float a0 = 1.0f + alpha;
+			SCOPE_Filter_Coef *c = &filter_coef[s];
+			c->b0 = c->b2 = SCOPE_Filter_Fixed(0.5f * (1.0f - cs) / a0);
+			c->a1 = SCOPE_Filter_Fixed(2.0f * cs / a0);
+			c->a2 = SCOPE_Filter_Fixed(-(1.0f - alpha) / a0);
+			c->b1 = (1 << SCOPE_FILTER_Q) - c->a1 - c->a2 - 2 * c->b0;
+		}
+		filter_bwl_usable = 1;
+	}
+	filter_primed[0] = 0;
+	filter_primed[1] = 0;
+}
+
+/**
+ * @brief  查询是否有通道在滤波
+ * @retval 1: 至少一个通道打开了交流耦合或带宽限制，0: 数据原样转发
+ */
+uint8_t SCOPE_Filter_Is_Active(void)
+{
+	return filter_ac[0] || filter_ac[1] || filter_bwl[0] || filter_bwl[1];
+}
+
+/**
+ * @brief  用一个采样把状态预置为稳态 (输入一直是这个值)
+ * @param  st   滤波器状态
+ * @param  code 码值
+ * @param  ac   是否交流耦合
+ * @retval 无
+ */
+static void SCOPE_Filter_Prime(SCOPE_Filter_State *st, int32_t code, uint8_t ac)
+{
+	int32_t x = ac ? 0 : (code - SCOPE_ADC_ZERO_CODE) * 4;
+	st->dc = code << 16;
+	for (uint8_t s = 0; s < SCOPE_FILTER_BWL_STAGES; s++)
+	{
+		SCOPE_Filter_Section *sec = &st->sec[s];
+		sec->x1 = sec->x2 = sec->y1 = sec->y2 = x;
+		sec->err = 0;
+	}
+}
+
+/**
+ * @brief  一个二阶节处理一个采样
+ * @param  sec 状态
+ * @param  c   系数
+ * @param  x   输入 (Q2)
+ * @retval 输出 (Q2)
+ */
+static inline int32_t SCOPE_Filter_Section_Run(SCOPE_Filter_Section *sec, const SCOPE_Filter_Coef *c, int32_t x)
+{
+	// |x|、|y| 在 2^15 以内，|a1| < 2^15，|a2| < 2^14，累加不会溢出
+	int32_t acc = c->b0 * x + c->b1 * sec->x1 + c->b2 * sec->x2 + c->a1 * sec->y1 + c->a2 * sec->y2 + sec->err;
+	int32_t y = acc >> SCOPE_FILTER_Q;
+	sec->err = acc & ((1 << SCOPE_FILTER_Q) - 1);
+	sec->x2 = sec->x1;
+	sec->x1 = x;
+	sec->y2 = sec->y1;
+	sec->y1 = y;
+	return y;
+}
+
+/**
+ * @brief  对一个通道扫描一遍数据块
+ * @param  words   打包的数据字，结果原地写回
+ * @param  count   字数
+ * @param  mode    采集模式
+ * @param  channel 通道
+ * @param  ac      是否交流耦合
+ * @param  bwl     是否带宽限制
+ * @retval 无
+ */
+static void SCOPE_Filter_Run(uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode, uint8_t channel, uint8_t ac, uint8_t bwl)
+{
+	const uint8_t interleaved = (mode != SCOPE_ACQ_SIMULTANEOUS);
+	const uint16_t samples = count * SCOPE_Acq_Samples_Per_Word(mode);
+	const uint8_t shift = filter_ac_shift;
+	SCOPE_Filter_State st = filter_state[channel];
+
+	if (!filter_primed[channel])
+	{
+		SCOPE_Filter_Prime(&st, SCOPE_Acq_Sample(words, mode, channel, 0), ac);
+		filter_primed[channel] = 1;
+	}
+
+	for (uint16_t i = 0; i < samples; i++)
+	{
+		// 同步模式取本通道的半字，快速交替模式每字两个采样，高16位在前
+		uint32_t *w = interleaved ? &words[i >> 1] : &words[i];
+		uint8_t pos = interleaved ? ((i & 1) ? 0 : 16) : (channel ? 16 : 0);
+		int32_t code = (int32_t)((*w >> pos) & 0x0FFF);
+
+		int32_t x;
+		if (ac)
+		{
+			st.dc += ((code << 16) - st.dc) >> shift;
+			x = ((code << 16) - st.dc) >> 14;
+		}
+		else
+		{
+			x = (code - SCOPE_ADC_ZERO_CODE) * 4;
+		}
+		if (bwl)
+		{
+			for (uint8_t s = 0; s < SCOPE_FILTER_BWL_STAGES; s++)
+				x = SCOPE_Filter_Section_Run(&st.sec[s], &filter_coef[s], x);
+		}
+
+		int32_t out = ((x + 2) >> 2) + SCOPE_ADC_ZERO_CODE;
+		out = (out < 0) ? 0 : (out > SCOPE_ADC_FULL_SCALE - 1) ? SCOPE_ADC_FULL_SCALE - 1 : out;
+		*w = (*w & ~(0x0FFFu << pos)) | ((uint32_t)out << pos);
+	}
+	filter_state[channel] = st;
+}
+
+/**
+ * @brief  数据块回调
+ * @param  words 打包的数据字
+ * @param  count 字数
+ * @param  mode  采集模式
+ * @retval 无
+ */
+void SCOPE_Filter_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	for (uint8_t c = 0; c < 2; c++)
+	{
+		uint8_t ac = filter_ac[c];
+		uint8_t bwl = filter_bwl[c] && filter_bwl_usable;
+		if ((ac || bwl) && SCOPE_Acq_Has_Channel(mode, c))
+			SCOPE_Filter_Run((uint32_t *)words, count, mode, c, ac, bwl); // 本数据块交给回调期间 DMA 不会写入
+	}
+	SCOPE_Decim_Block(words, count, mode);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file    SCOPE_graticule.c
+ * @brief   示波器网格 (刻度) 图层实现
+ * @details 原先每帧用 11 条水平线、8 条垂直线、2 条中心线和 40 段短线 (触发虚线) 绘制网格，
+ *          每次调用都要单独设置窗口并阻塞刷新。现在网格只是一组参数，由渲染器在合成时查询。
+ */
+#include "SCOPEh/SCOPE_graticule.h"
+#include "TFTh/TFT_io.h"
+#include <stdint.h>
+
+/**
+ * @brief  初始化网格图层
+ * @param  g      网格图层
+ * @param  width  区域宽度
+ * @param  height 区域高度
+ * @param  pitch  网格间距 (像素/格)
+ * @retval 无
+ */
+void SCOPE_Graticule_Init(SCOPE_Graticule *g, uint16_t width, uint16_t height, uint16_t pitch)
+{
+	if (g == NULL || pitch == 0)
+		return;
+
+	g->width = width;
+	g->height = height;
+	g->pitch = pitch;
+	g->minor_pitch = (pitch >= 5) ? pitch / 5 : 1; // 每格 5 个小刻度
+	g->center_x = width / 2;
+	g->center_y = height / 2;
+	g->tick_len = 2;
+	g->trigger_visible = 0;
+	g->trigger_y = 0;
+	g->bg_color = BLACK;
+	g->grid_color = GRAY;
+	g->axis_color = GBLUE;
+	g->trigger_color = MAGENTA;
+}
+
+/**
+ * @brief  设置触发电平虚线
+ * @param  g       网格图层
+ * @param  visible 是否显示
+ * @param  y       触发电平的Y坐标
+ * @retval 无
+ */
+void SCOPE_Graticule_Set_Trigger(SCOPE_Graticule *g, uint8_t visible, uint16_t y)
+{
+	if (g == NULL)
+		return;
+
+	g->trigger_visible = visible && (y < g->height);
+	g->trigger_y = y;
+}
+
+/**
+ * @brief  输出一整行的背景像素
+ * @param  g      网格图层
+ * @param  y      行坐标
+ * @param  row_be 输出缓冲区 (大端序)
+ * @retval 无
+ */
+void SCOPE_Graticule_Fill_Row(const SCOPE_Graticule *g, uint16_t y, uint16_t *row_be)
+{
+	if (g == NULL || row_be == NULL)
+		return;
+
+	uint16_t bg = TFT_COLOR_BE(g->bg_color);
+	uint16_t grid = TFT_COLOR_BE(g->grid_color);
+	uint16_t axis = TFT_COLOR_BE(g->axis_color);
+	uint16_t trigger = TFT_COLOR_BE(g->trigger_color);
+
+	// 本行的属性只计算一次
+	uint8_t trigger_row = g->trigger_visible && (y == g->trigger_y);
+	uint8_t axis_row = (y == g->center_y);
+	uint8_t tick_row = (uint16_t)(y - g->center_y + g->tick_len) <= 2 * g->tick_len; // 水平中心轴的刻度带
+	uint8_t minor_row = (y % g->minor_pitch) == 0;										// 垂直中心轴上的刻度行
+	uint8_t grid_row = (y % g->pitch) == 0;
+
+	// 整行只有三种情况会整体同色：中心轴、网格线，其余像素逐列判断
+	uint16_t row_color = axis_row ? axis : (grid_row ? grid : bg);
+
+	uint16_t gx = 0;   // x % pitch
+	uint16_t mx = 0;   // x % minor_pitch
+	uint16_t dash = 0; // x % (2 * DASH)
+	for (uint16_t x = 0; x < g->width; x++)
+	{
+		uint16_t color = row_color;
+
+		if (!axis_row)
+		{
+			if (x == g->center_x)
+				color = axis;
+			else if (tick_row && mx == 0)
+				color = axis;
+			else if (minor_row && (uint16_t)(x - g->center_x + g->tick_len) <= 2 * g->tick_len)
+				color = axis;
+			else if (gx == 0)
+				color = grid;
+		}
+		if (trigger_row && dash < SCOPE_GRATICULE_DASH)
+			color = trigger;
+
+		row_be[x] = color;
+
+		if (++gx == g->pitch)
+			gx = 0;
+		if (++mx == g->minor_pitch)
+			mx = 0;
+		if (++dash == 2 * SCOPE_GRATICULE_DASH)
+			dash = 0;
+	}
+}
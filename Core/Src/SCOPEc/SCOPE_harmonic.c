@@ -0,0 +1,103 @@
+/**
+ * @file    SCOPE_harmonic.c
+ * @brief   示波器谐波分析实现
+ * @details 频点功率只读一遍：先找基波，再逐个频点分类累加，各类功率用 float 累加 (最多 512 项)。
+ *          频点的功率刻度随帧变化 (块浮点)，但同一帧内的比值不受影响。
+ */
+#include "SCOPEh/SCOPE_harmonic.h"
+#include "SCOPEh/SCOPE_fft.h"
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @brief  第 order 次谐波混叠后的位置
+ * @param  fund  基波位置 (频点)
+ * @param  order 谐波次数
+ * @param  bins  频点数 (N / 2)
+ * @retval 频点位置 (0 ~ bins)
+ */
+static float SCOPE_Harmonic_Position(float fund, uint8_t order, uint16_t bins)
+{
+	float x = fmodf(fund * order, 2.0f * bins);
+	return (x > bins) ? 2.0f * bins - x : x;
+}
+
+/**
+ * @brief  分析当前帧的频谱
+ * @param  sample_rate 频谱的采样率 (Hz)
+ * @param  result      输出：分析结果
+ * @retval 无
+ */
+void SCOPE_Harmonic_Analyze(float sample_rate, SCOPE_Harm_Result *result)
+{
+	uint16_t bins = SCOPE_Fft_Get_Bins();
+	uint8_t lobe = SCOPE_Fft_Get_Lobe();
+	result->valid = 0;
+
+	// 基波：直流主瓣以外功率最大的频点
+	uint16_t peak = 0;
+	uint32_t peak_power = 0;
+	for (uint16_t b = lobe + 1; b < bins - 1; b++)
+	{
+		uint32_t p = SCOPE_Fft_Get_Power(b);
+		if (p > peak_power)
+		{
+			peak_power = p;
+			peak = b;
+		}
+	}
+	if (peak_power == 0)
+		return;
+
+	// 抛物线插值：窗函数主瓣的对数功率近似为抛物线
+	float a = logf(SCOPE_Fft_Get_Power(peak - 1) + 1.0f);
+	float c = logf(SCOPE_Fft_Get_Power(peak + 1) + 1.0f);
+	float den = a - 2.0f * logf(peak_power + 1.0f) + c;
+	float delta = (den < 0) ? 0.5f * (a - c) / den : 0.0f;
+	if (delta > 0.5f || delta < -0.5f)
+		delta = 0.0f;
+	float fund = peak + delta;
+
+	// 逐个频点分类累加
+	float fund_power = 0, harm_power = 0, noise_power = 0;
+	uint16_t noise_bins = 0;
+	for (uint16_t b = lobe + 1; b < bins; b++)
+	{
+		float p = SCOPE_Fft_Get_Power(b);
+		if (fabsf(b - fund) <= lobe)
+		{
+			fund_power += p;
+			continue;
+		}
+		uint8_t order = 2;
+		for (; order <= SCOPE_HARM_MAX_ORDER; order++)
+		{
+			if (fabsf(b - SCOPE_Harmonic_Position(fund, order, bins)) <= lobe)
+				break;
+		}
+		if (order <= SCOPE_HARM_MAX_ORDER)
+		{
+			harm_power += p;
+		}
+		else
+		{
+			noise_power += p;
+			noise_bins++;
+		}
+	}
+	if (noise_bins == 0 || noise_power <= 0)
+		return;
+	noise_power *= (float)(bins - lobe - 1) / noise_bins; // 被占用的频点按噪声的平均值补上
+
+	if (harm_power <= 0)
+		harm_power = 1.0f; // 没有谐波时 THD 取一个极小值，避免 lg(0)
+
+	float sinad = 10.0f * log10f(fund_power / (noise_power + harm_power));
+	result->value[SCOPE_HARM_FUND] = fund * sample_rate / (2.0f * bins);
+	result->value[SCOPE_HARM_LEVEL] = SCOPE_Fft_Power_To_Dbv(fund_power / SCOPE_Fft_Get_Enbw());
+	result->value[SCOPE_HARM_THD] = 10.0f * log10f(harm_power / fund_power);
+	result->value[SCOPE_HARM_SNR] = 10.0f * log10f(fund_power / noise_power);
+	result->value[SCOPE_HARM_SINAD] = sinad;
+	result->value[SCOPE_HARM_ENOB] = (sinad - 1.76f) / 6.02f;
+	result->valid = 1;
+}
@@ -0,0 +1,365 @@
+/**
+ * @file    SCOPE_log.c
+ * @brief   示波器长记录 (差分编码) 实现
+ * @details 新的帧先放入暂存块，满 SCOPE_LOG_BLOCK 帧后编码写入存储区：先只计算编码长度，
+ *          与原样保存的长度比较后选择较短的一种，再实际写入。
+ *          块的位置记录在循环使用的关键帧表中，表中第 0 项为最早的一块。
+ *          写入位置到达存储区末尾放不下新块时回到开头，尾部剩余的块 (此时为最早的) 先被丢弃。
+ */
+#include "SCOPEh/SCOPE_log.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define SCOPE_LOG_RAW_FLAG 0x8000 // 块头：原样保存
+
+/**
+ * @brief 半字节码流的写入/读取位置
+ */
+typedef struct
+{
+    uint8_t *data;  // 码流 (写入时为 NULL 表示只计数)
+    uint16_t count; // 已写入/读取的半字节数
+} SCOPE_Log_Nibbles;
+
+static uint8_t *log_mem = NULL;                  // 采样存储区
+static uint16_t log_key[SCOPE_LOG_MAX_BLOCKS];   // 各块在存储区中的位置 (循环使用)
+static uint16_t log_stage[SCOPE_LOG_BLOCK * 2];  // 暂存块 (帧内按通道顺序)
+static uint16_t log_stage_frames = 0;            // 暂存块中的帧数
+static uint16_t log_oldest = 0;                  // 最早一块在 log_key 中的位置
+static uint16_t log_blocks = 0;                  // 块数
+static uint16_t log_raw_blocks = 0;              // 原样保存的块数
+static uint16_t log_write = 0;                   // 下一块的写入位置
+static uint16_t log_bytes = 0;                   // 各块占用的字节数
+static uint32_t log_total = 0;                   // 开始记录以来追加的帧数
+static uint8_t log_channels = 0;                 // 记录的通道
+static uint8_t log_nch = 0;                      // 每帧采样数
+
+/**
+ * @brief  读取块头
+ */
+static inline uint16_t SCOPE_Log_Header(uint16_t offset)
+{
+	return (uint16_t)(log_mem[offset] | (log_mem[offset + 1] << 8));
+}
+
+/**
+ * @brief  写入一个半字节
+ */
+static inline void SCOPE_Log_Put(SCOPE_Log_Nibbles *w, uint8_t v)
+{
+	if (w->data != NULL)
+	{
+		if (w->count & 1)
+			w->data[w->count >> 1] |= (uint8_t)(v << 4);
+		else
+			w->data[w->count >> 1] = v;
+	}
+	w->count++;
+}
+
+/**
+ * @brief  读取一个半字节
+ */
+static inline uint8_t SCOPE_Log_Get(SCOPE_Log_Nibbles *r)
+{
+	uint8_t v = (r->count & 1) ? (r->data[r->count >> 1] >> 4) : (r->data[r->count >> 1] & 0x0F);
+	r->count++;
+	return v;
+}
+
+/**
+ * @brief  编码一个采样
+ * @param  w    码流
+ * @param  prev 同一通道的上一个采样
+ * @param  x    本采样
+ * @retval 无
+ */
+static void SCOPE_Log_Encode(SCOPE_Log_Nibbles *w, uint16_t prev, uint16_t x)
+{
+	int32_t d = (int32_t)x - prev;
+	uint32_t z = (uint32_t)((d << 1) ^ (d >> 31)); // zig-zag：0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+
+	if (z < 8)
+	{
+		SCOPE_Log_Put(w, (uint8_t)z);
+	}
+	else if (z < 72)
+	{
+		z -= 8;
+		SCOPE_Log_Put(w, (uint8_t)(0x8 | (z >> 4)));
+		SCOPE_Log_Put(w, (uint8_t)(z & 0xF));
+	}
+	else if (z < 584)
+	{
+		z -= 72;
+		SCOPE_Log_Put(w, (uint8_t)(0xC | (z >> 8)));
+		SCOPE_Log_Put(w, (uint8_t)((z >> 4) & 0xF));
+		SCOPE_Log_Put(w, (uint8_t)(z & 0xF));
+	}
+	else
+	{
+		SCOPE_Log_Put(w, 0xE);
+		SCOPE_Log_Put(w, (uint8_t)((x >> 8) & 0xF));
+		SCOPE_Log_Put(w, (uint8_t)((x >> 4) & 0xF));
+		SCOPE_Log_Put(w, (uint8_t)(x & 0xF));
+	}
+}
+
+/**
+ * @brief  解码一个采样
+ * @param  r    码流
+ * @param  prev 同一通道的上一个采样
+ * @retval 本采样
+ */
+static uint16_t SCOPE_Log_Decode(SCOPE_Log_Nibbles *r, uint16_t prev)
+{
+	uint32_t z;
+	uint8_t n = SCOPE_Log_Get(r);
+
+	if (n < 0x8)
+	{
+		z = n;
+	}
+	else if (n < 0xC)
+	{
+		z = (uint32_t)(n & 0x3) << 4;
+		z |= SCOPE_Log_Get(r);
+		z += 8;
+	}
+	else if (n < 0xE)
+	{
+		z = (uint32_t)(n & 0x1) << 8;
+		z |= (uint32_t)SCOPE_Log_Get(r) << 4;
+		z |= SCOPE_Log_Get(r);
+		z += 72;
+	}
+	else
+	{
+		uint16_t x = (uint16_t)SCOPE_Log_Get(r) << 8;
+		x |= (uint16_t)SCOPE_Log_Get(r) << 4;
+		x |= SCOPE_Log_Get(r);
+		return x;
+	}
+
+	int32_t d = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+	return (uint16_t)(prev + d);
+}
+
+/**
+ * @brief  编码暂存块中首帧之后的所有采样
+ * @param  data 码流 (NULL 表示只计算长度)
+ * @retval 半字节数
+ */
+static uint16_t SCOPE_Log_Encode_Stage(uint8_t *data)
+{
+	SCOPE_Log_Nibbles w = {data, 0};
+	for (uint16_t i = log_nch; i < SCOPE_LOG_BLOCK * log_nch; i++)
+		SCOPE_Log_Encode(&w, log_stage[i - log_nch], log_stage[i]);
+	return w.count;
+}
+
+/**
+ * @brief  丢弃最早的一块
+ */
+static void SCOPE_Log_Drop(void)
+{
+	uint16_t header = SCOPE_Log_Header(log_key[log_oldest]);
+	log_bytes -= header & ~SCOPE_LOG_RAW_FLAG;
+	if (header & SCOPE_LOG_RAW_FLAG)
+		log_raw_blocks--;
+	log_oldest = (log_oldest + 1) % SCOPE_LOG_MAX_BLOCKS;
+	log_blocks--;
+}
+
+/**
+ * @brief  把满的暂存块写入存储区
+ */
+static void SCOPE_Log_Commit(void)
+{
+	uint16_t coded = 2 + 2 * log_nch + (SCOPE_Log_Encode_Stage(NULL) + 1) / 2;
+	uint16_t raw = 2 + SCOPE_Smem_Bytes(SCOPE_SMEM_12BIT, SCOPE_LOG_BLOCK * log_nch);
+	uint8_t is_raw = raw < coded; // 编码反而更长时原样保存
+	uint16_t size = is_raw ? raw : coded;
+
+	// 放不下时回到开头，尾部剩余的块是最早的，先丢弃
+	uint16_t w = log_write;
+	if (w + size > SCOPE_SMEM_BYTES)
+	{
+		while (log_blocks && log_key[log_oldest] >= w)
+			SCOPE_Log_Drop();
+		w = 0;
+	}
+	while (log_blocks && (log_blocks == SCOPE_LOG_MAX_BLOCKS ||
+						  (log_key[log_oldest] >= w && log_key[log_oldest] < w + size)))
+		SCOPE_Log_Drop();
+
+	uint8_t *p = log_mem + w;
+	uint16_t header = size | (is_raw ? SCOPE_LOG_RAW_FLAG : 0);
+	p[0] = (uint8_t)header;
+	p[1] = (uint8_t)(header >> 8);
+	if (is_raw)
+	{
+		SCOPE_Smem_Writer writer;
+		SCOPE_Smem_Writer_Init(&writer, p + 2, SCOPE_SMEM_12BIT);
+		for (uint16_t i = 0; i < SCOPE_LOG_BLOCK * log_nch; i++)
+			SCOPE_Smem_Put(&writer, log_stage[i]);
+		SCOPE_Smem_Flush(&writer);
+	}
+	else
+	{
+		for (uint8_t c = 0; c < log_nch; c++)
+		{
+			p[2 + 2 * c] = (uint8_t)log_stage[c];
+			p[3 + 2 * c] = (uint8_t)(log_stage[c] >> 8);
+		}
+		SCOPE_Log_Encode_Stage(p + 2 + 2 * log_nch);
+	}
+
+	log_key[(log_oldest + log_blocks) % SCOPE_LOG_MAX_BLOCKS] = w;
+	log_blocks++;
+	log_bytes += size;
+	if (is_raw)
+		log_raw_blocks++;
+	log_write = w + size;
+	log_stage_frames = 0;
+}
+
+/**
+ * @brief  从一块中读取一个通道的连续几帧
+ * @param  block 块序号 (0 为最早的一块)
+ * @param  c     通道在帧内的序号
+ * @param  skip  从块内第几帧开始
+ * @param  count 帧数 (skip + count 不超过 SCOPE_LOG_BLOCK)
+ * @param  codes 输出：12 位码值
+ */
+static void SCOPE_Log_Read_Block(uint16_t block, uint8_t c, uint16_t skip, uint16_t count, uint16_t *codes)
+{
+	const uint8_t *p = log_mem + log_key[(log_oldest + block) % SCOPE_LOG_MAX_BLOCKS];
+	uint16_t header = (uint16_t)(p[0] | (p[1] << 8));
+
+	if (header & SCOPE_LOG_RAW_FLAG)
+	{
+		for (uint16_t j = 0; j < count; j++)
+			codes[j] = SCOPE_Smem_Get(p + 2, SCOPE_SMEM_12BIT, (skip + j) * log_nch + c);
+		return;
+	}
+
+	// 编码块只能从首帧顺序解码到需要的位置
+	uint16_t prev[2];
+	for (uint8_t k = 0; k < log_nch; k++)
+		prev[k] = (uint16_t)(p[2 + 2 * k] | (p[3 + 2 * k] << 8));
+	SCOPE_Log_Nibbles r = {(uint8_t *)p + 2 + 2 * log_nch, 0};
+
+	if (skip == 0)
+		*codes++ = prev[c];
+	for (uint16_t f = 1; f < skip + count; f++)
+	{
+		for (uint8_t k = 0; k < log_nch; k++)
+			prev[k] = SCOPE_Log_Decode(&r, prev[k]);
+		if (f >= skip)
+			*codes++ = prev[c];
+	}
+}
+
+/**
+ * @brief  取得采样存储区并开始新的记录
+ * @param  channels 记录的通道
+ * @retval 无
+ */
+void SCOPE_Log_Start(uint8_t channels)
+{
+	log_mem = SCOPE_Smem_Claim(SCOPE_SMEM_LOG);
+	log_channels = channels & 3;
+	log_nch = (log_channels & 1) + (log_channels >> 1);
+	log_stage_frames = 0;
+	log_oldest = 0;
+	log_blocks = 0;
+	log_raw_blocks = 0;
+	log_write = 0;
+	log_bytes = 0;
+	log_total = 0;
+}
+
+/**
+ * @brief  追加一帧
+ * @param  ch1 通道1码值
+ * @param  ch2 通道2码值
+ * @retval 无
+ */
+void SCOPE_Log_Append(uint16_t ch1, uint16_t ch2)
+{
+	if (log_nch == 0 || SCOPE_Smem_Get_Owner() != SCOPE_SMEM_LOG)
+		return;
+
+	uint16_t *frame = &log_stage[log_stage_frames * log_nch];
+	if (log_channels & 1)
+		*frame++ = ch1;
+	if (log_channels & 2)
+		*frame = ch2;
+	log_total++;
+
+	if (++log_stage_frames == SCOPE_LOG_BLOCK)
+		SCOPE_Log_Commit();
+}
+
+/**
+ * @brief  读取一个通道的一段记录
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @param  first   第一帧的序号
+ * @param  count   帧数
+ * @param  codes   输出：12 位码值
+ * @retval 实际读取的帧数
+ */
+uint16_t SCOPE_Log_Read(uint8_t channel, uint32_t first, uint16_t count, uint16_t *codes)
+{
+	if (channel > 1 || codes == NULL || !(log_channels & (1 << channel)) || SCOPE_Smem_Get_Owner() != SCOPE_SMEM_LOG)
+		return 0;
+
+	uint8_t c = (channel == 1 && (log_channels & 1)) ? 1 : 0; // 通道在帧内的序号
+	uint32_t oldest = log_total - ((uint32_t)log_blocks * SCOPE_LOG_BLOCK + log_stage_frames);
+	if (first < oldest)
+		first = oldest;
+
+	uint16_t n = 0;
+	while (n < count && first < log_total)
+	{
+		uint32_t rel = first - oldest;
+		uint16_t block = (uint16_t)(rel / SCOPE_LOG_BLOCK);
+		uint16_t skip = (uint16_t)(rel % SCOPE_LOG_BLOCK);
+		uint16_t m = SCOPE_LOG_BLOCK - skip;
+		if (m > count - n)
+			m = count - n;
+
+		if (block < log_blocks)
+		{
+			SCOPE_Log_Read_Block(block, c, skip, m, codes + n);
+		}
+		else
+		{
+			if (m > log_stage_frames - skip)
+				m = log_stage_frames - skip;
+			for (uint16_t j = 0; j < m; j++)
+				codes[n + j] = log_stage[(skip + j) * log_nch + c];
+		}
+		n += m;
+		first += m;
+	}
+	return n;
+}
+
+/**
+ * @brief  获取统计
+ * @param  stats 输出：统计
+ * @retval 无
+ */
+void SCOPE_Log_Get_Stats(SCOPE_Log_Stats *stats)
+{
+	uint8_t valid = SCOPE_Smem_Get_Owner() == SCOPE_SMEM_LOG;
+	stats->frames = valid ? (uint32_t)log_blocks * SCOPE_LOG_BLOCK + log_stage_frames : 0;
+	stats->first = log_total - stats->frames;
+	stats->bytes = valid ? log_bytes : 0;
+	stats->blocks = valid ? log_blocks : 0;
+	stats->raw_blocks = valid ? log_raw_blocks : 0;
+	stats->ratio = (stats->bytes > 0) ? (float)stats->blocks * SCOPE_LOG_BLOCK * log_nch * 2 / stats->bytes : 0.0f;
+}
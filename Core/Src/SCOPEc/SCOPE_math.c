@@ -0,0 +1,286 @@
+/**
+ * @file    SCOPE_math.c
+ * @brief   示波器数学通道实现
+ * @details 每个采样的处理为：取信源码值 -> 依次执行各级运算 -> 乘单位系数换算为屏幕坐标，
+ *          运算只用整数，屏幕换算与采集记录一样用一次浮点乘法。
+ *          单位系数 (每个 LSB 对应的物理量) 和量纲在设置运算序列时确定，采样间隔在计算时乘入。
+ */
+#include "SCOPEh/SCOPE_math.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#define SCOPE_MATH_AUTO_DIVS 3.5f // 自动刻度：结果不超过 ±3.5 格
+
+static uint8_t math_source = 0;                              // 信源通道
+static SCOPE_Math_Kernel math_kernels[SCOPE_MATH_MAX_KERNELS]; // 运算序列
+static uint8_t math_count = 0;                               // 级数
+static int8_t math_volt_exp = 1;                             // 结果量纲中 V 的次数
+static int8_t math_time_exp = 0;                             // 结果量纲中 s 的次数
+static char math_unit[12] = "V";                             // 单位字符串
+static float math_cutoff = 1000.0f;                          // 低通截止频率 (Hz)
+static uint8_t math_auto = 1;                                // 自动刻度
+static float math_scale = 1.0f;                              // 每格的值
+
+/**
+ * @brief  饱和到 int32
+ */
+static inline int32_t SCOPE_Math_Saturate(int64_t v)
+{
+	return (v > INT32_MAX) ? INT32_MAX : (v < INT32_MIN) ? INT32_MIN : (int32_t)v;
+}
+
+/**
+ * @brief  读取冻结窗口中一个采样相对零点的值
+ * @retval Q8 码值 (由 Q4 码值放大，保留高分辨率方式的小数位)
+ */
+static inline int32_t SCOPE_Math_Sample(uint8_t channel, uint16_t index)
+{
+	return ((int32_t)SCOPE_Capture_Sample_Q4(channel, index) - SCOPE_ADC_ZERO_CODE * 16) * 16;
+}
+
+/**
+ * @brief  在单位字符串后追加次数
+ */
+static char *SCOPE_Math_Append_Exp(char *p, int8_t exp)
+{
+	if (exp > 1)
+	{
+		*p++ = '^';
+		*p++ = (char)('0' + exp);
+	}
+	return p;
+}
+
+/**
+ * @brief  设置信源通道
+ * @param  channel 通道 (0: CH1，1: CH2)
+ * @retval 无
+ */
+void SCOPE_Math_Set_Source(uint8_t channel)
+{
+	math_source = channel & 1;
+}
+
+/**
+ * @brief  设置运算序列
+ * @param  kernels 运算
+ * @param  count   级数
+ * @retval 接受的级数
+ */
+uint8_t SCOPE_Math_Set_Kernels(const SCOPE_Math_Kernel *kernels, uint8_t count)
+{
+	int8_t volt = 1, time = 0;
+	uint8_t n = 0;
+	for (; n < count && n < SCOPE_MATH_MAX_KERNELS; n++)
+	{
+		SCOPE_Math_Kernel k = kernels[n];
+		if (k >= SCOPE_MATH_KERNEL_COUNT)
+			break;
+		if (k <= SCOPE_MATH_MUL && (volt != 1 || time != 0))
+			break; // 与另一个通道 (V) 的运算要求量纲相同
+		if (k == SCOPE_MATH_MUL)
+			volt++;
+		else if (k == SCOPE_MATH_INTG)
+			time++;
+		else if (k == SCOPE_MATH_DIFF)
+			time--;
+		math_kernels[n] = k;
+	}
+	math_count = n;
+	math_volt_exp = volt;
+	math_time_exp = time;
+
+	char *p = math_unit;
+	*p++ = 'V';
+	p = SCOPE_Math_Append_Exp(p, volt);
+	if (time > 0)
+	{
+		*p++ = 's';
+		p = SCOPE_Math_Append_Exp(p, time);
+	}
+	else if (time < 0)
+	{
+		*p++ = '/';
+		*p++ = 's';
+		p = SCOPE_Math_Append_Exp(p, -time);
+	}
+	*p = '\0';
+	return n;
+}
+
+/**
+ * @brief  设置低通滤波的截止频率
+ * @param  cutoff_hz 截止频率 (Hz)
+ * @retval 无
+ */
+void SCOPE_Math_Set_Lowpass(float cutoff_hz)
+{
+	if (cutoff_hz > 0)
+		math_cutoff = cutoff_hz;
+}
+
+/**
+ * @brief  获取低通滤波的截止频率
+ * @retval 截止频率 (Hz)
+ */
+float SCOPE_Math_Get_Lowpass(void)
+{
+	return math_cutoff;
+}
+
+/**
+ * @brief  设置刻度
+ * @param  per_div 每格的值，0 表示自动
+ * @retval 无
+ */
+void SCOPE_Math_Set_Scale(float per_div)
+{
+	math_auto = (per_div <= 0);
+	if (!math_auto)
+		math_scale = per_div;
+}
+
+/**
+ * @brief  获取当前刻度
+ * @retval 每格的值
+ */
+float SCOPE_Math_Get_Scale(void)
+{
+	return math_scale;
+}
+
+/**
+ * @brief  获取结果的单位
+ * @retval 单位字符串
+ */
+const char *SCOPE_Math_Get_Unit(void)
+{
+	return math_unit;
+}
+
+/**
+ * @brief  1-2-5 序列中不小于 x 的最小值
+ */
+static float SCOPE_Math_Step_125(float x)
+{
+	float decade = powf(10.0f, floorf(log10f(x)));
+	float m = x / decade;
+	return decade * ((m <= 1.0f) ? 1.0f : (m <= 2.0f) ? 2.0f : (m <= 5.0f) ? 5.0f : 10.0f);
+}
+
+/**
+ * @brief  扫描一遍窗口：运算并按给定刻度换算为屏幕Y坐标
+ * @param  wave_y        输出：每列的屏幕Y坐标
+ * @param  points        点数
+ * @param  pixels_per_lsb 每个 LSB 对应的像素
+ * @param  alpha_q15     低通系数 (Q15)
+ * @retval 结果绝对值的最大值 (LSB)
+ */
+static uint32_t SCOPE_Math_Pass(uint16_t *wave_y, uint16_t points, float pixels_per_lsb, int32_t alpha_q15)
+{
+	int64_t acc[SCOPE_MATH_MAX_KERNELS] = {0}; // 积分的累加器
+	int32_t prev[SCOPE_MATH_MAX_KERNELS];      // 微分的前一个输入，低通的输出
+	uint8_t other = math_source ^ 1;
+	uint32_t peak = 0;
+
+	for (uint16_t i = 0; i < points; i++)
+	{
+		int32_t v = SCOPE_Math_Sample(math_source, i);
+		for (uint8_t k = 0; k < math_count; k++)
+		{
+			switch (math_kernels[k])
+			{
+			case SCOPE_MATH_ADD:
+				v += SCOPE_Math_Sample(other, i);
+				break;
+			case SCOPE_MATH_SUB:
+				v -= SCOPE_Math_Sample(other, i);
+				break;
+			case SCOPE_MATH_MUL:
+				v = SCOPE_Math_Saturate(((int64_t)v * SCOPE_Math_Sample(other, i)) >> 8);
+				break;
+			case SCOPE_MATH_INTG:
+				acc[k] += v;
+				v = SCOPE_Math_Saturate(acc[k]);
+				break;
+			case SCOPE_MATH_DIFF:
+			{
+				int32_t last = (i == 0) ? v : prev[k];
+				prev[k] = v;
+				v = SCOPE_Math_Saturate((int64_t)v - last);
+				break;
+			}
+			case SCOPE_MATH_LPF:
+				if (i == 0)
+					prev[k] = v;
+				else
+					prev[k] += (int32_t)(((int64_t)v - prev[k]) * alpha_q15 >> 15);
+				v = prev[k];
+				break;
+			default:
+				break;
+			}
+		}
+
+		uint32_t mag = (v < 0) ? -(int64_t)v : v;
+		if (mag > peak)
+			peak = mag;
+		float y = SCOPE_PLOT_HEIGHT / 2 - v * pixels_per_lsb;
+		wave_y[i] = (y < 0) ? 0 : (y > SCOPE_PLOT_HEIGHT - 1) ? SCOPE_PLOT_HEIGHT - 1 : (uint16_t)y;
+	}
+	return peak;
+}
+
+/**
+ * @brief  计算冻结窗口的数学通道并转换为屏幕Y坐标
+ * @param  wave_y      输出：每列的屏幕Y坐标
+ * @param  points      点数
+ * @param  sample_rate 窗口的采样率 (Hz)
+ * @retval 1: 已输出，0: 窗口不含需要的通道
+ */
+uint8_t SCOPE_Math_To_Screen(uint16_t *wave_y, uint16_t points, float sample_rate)
+{
+	if (wave_y == NULL || sample_rate <= 0)
+		return 0;
+
+	// 用到另一个通道时窗口必须是双通道同步采集
+	SCOPE_Acq_Mode mode = SCOPE_Capture_Get_Mode();
+	uint8_t binary = 0;
+	for (uint8_t k = 0; k < math_count; k++)
+		binary |= (math_kernels[k] <= SCOPE_MATH_MUL);
+	if (!SCOPE_Acq_Has_Channel(mode, math_source) || (binary && mode != SCOPE_ACQ_SIMULTANEOUS))
+		return 0;
+
+	// 每个 LSB 对应的物理量：Q8 码值，每次乘法多一个码值的倍数，积分/微分乘/除采样间隔
+	float dt = 1.0f / sample_rate;
+	float unit = 1.0f / (256.0f * SCOPE_CODES_PER_VOLT);
+	for (int8_t i = 1; i < math_volt_exp; i++)
+		unit /= SCOPE_CODES_PER_VOLT;
+	for (int8_t i = 0; i < math_time_exp; i++)
+		unit *= dt;
+	for (int8_t i = 0; i > math_time_exp; i--)
+		unit /= dt;
+
+	// 一阶低通：alpha = 1 - e^(-2π fc dt)
+	int32_t alpha_q15 = (int32_t)((1.0f - expf(-2.0f * 3.14159265f * math_cutoff * dt)) * 32768.0f);
+	if (alpha_q15 < 1)
+		alpha_q15 = 1;
+	if (alpha_q15 > 32768)
+		alpha_q15 = 32768;
+
+	float pixels_per_div = SCOPE_PLOT_HEIGHT / SCOPE_DIVS_Y;
+	for (uint8_t pass = 0; pass < 2; pass++)
+	{
+		uint32_t peak = SCOPE_Math_Pass(wave_y, points, unit * pixels_per_div / math_scale, alpha_q15);
+		if (!math_auto || peak == 0)
+			break;
+		float scale = SCOPE_Math_Step_125(peak * unit / SCOPE_MATH_AUTO_DIVS);
+		if (scale == math_scale)
+			break;
+		math_scale = scale; // 按新刻度再扫描一遍
+	}
+	return 1;
+}
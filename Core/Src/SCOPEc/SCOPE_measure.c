@@ -0,0 +1,227 @@
+/**
+ * @file    SCOPE_measure.c
+ * @brief   示波器自动测量实现
+ * @details 两遍扫描都只用整数运算，边沿时刻为 Q8 采样序号，最后才换算为电压和时间。
+ *          冻结窗口和码值数组通过同一个读取函数访问，测量代码只有一份。
+ *          读取函数返回 Q4 码值，高分辨率方式平均得到的小数位参与幅度和边沿插值。
+ */
+#include "SCOPEh/SCOPE_measure.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#define SCOPE_MEAS_AMPLITUDE (SCOPE_MEAS_BIT(SCOPE_MEAS_VMAX) | SCOPE_MEAS_BIT(SCOPE_MEAS_VMIN) | SCOPE_MEAS_BIT(SCOPE_MEAS_VPP) | \
+							  SCOPE_MEAS_BIT(SCOPE_MEAS_VAVG) | SCOPE_MEAS_BIT(SCOPE_MEAS_VRMS))
+#define SCOPE_MEAS_MIN_SWING (16 * 16) // 峰峰值小于此值 (Q4 码值) 时不做时间测量，噪声会被当作边沿
+#define SCOPE_MEAS_Q4_PER_VOLT (SCOPE_CODES_PER_VOLT * 16)
+
+static uint8_t meas_channel = 0;           // SCOPE_Measure_Capture 的通道
+static const uint16_t *meas_codes = NULL; // SCOPE_Measure_Codes 的码值
+
+/**
+ * @brief  读取冻结窗口的一个采样 (Q4 码值)
+ */
+static uint16_t SCOPE_Measure_Read_Capture(uint16_t index)
+{
+	return SCOPE_Capture_Sample_Q4(meas_channel, index);
+}
+
+/**
+ * @brief  读取码值数组的一个采样 (Q4 码值)
+ */
+static uint16_t SCOPE_Measure_Read_Codes(uint16_t index)
+{
+	return meas_codes[index] << 4;
+}
+
+/**
+ * @brief  相邻两个采样之间越过电平的位置
+ * @param  index 后一个采样的序号
+ * @param  prev  前一个采样
+ * @param  x     后一个采样
+ * @param  level 电平
+ * @retval 位置 (Q8 采样序号)
+ */
+static inline int32_t SCOPE_Measure_Cross(uint16_t index, int32_t prev, int32_t x, int32_t level)
+{
+	return ((int32_t)(index - 1) << 8) + ((level - prev) << 8) / (x - prev);
+}
+
+/**
+ * @brief  测量
+ * @param  sample      读取函数 (Q4 码值)
+ * @param  count       采样数
+ * @param  mask        需要的测量项
+ * @param  sample_rate 采样率 (Hz)
+ * @param  result      输出：测量结果
+ * @retval 无
+ */
+static void SCOPE_Measure_Run(uint16_t (*sample)(uint16_t), uint16_t count, uint16_t mask, float sample_rate, SCOPE_Meas_Result *result)
+{
+	result->valid = 0;
+	if (count < 2 || mask == 0)
+		return;
+
+	// 第一遍：幅度 (时间测量也需要最大值和最小值)
+	uint16_t max = 0, min = 0xFFFF;
+	int32_t sum = 0;
+	uint64_t sum_sq = 0;
+	for (uint16_t i = 0; i < count; i++)
+	{
+		uint16_t x = sample(i);
+		int32_t d = (int32_t)x - SCOPE_ADC_ZERO_CODE * 16; // |d| <= 32768，平方不超过 int32
+		if (x > max)
+			max = x;
+		if (x < min)
+			min = x;
+		sum += d;
+		sum_sq += (uint32_t)(d * d);
+	}
+
+	result->value[SCOPE_MEAS_VMAX] = ((int32_t)max - SCOPE_ADC_ZERO_CODE * 16) / SCOPE_MEAS_Q4_PER_VOLT;
+	result->value[SCOPE_MEAS_VMIN] = ((int32_t)min - SCOPE_ADC_ZERO_CODE * 16) / SCOPE_MEAS_Q4_PER_VOLT;
+	result->value[SCOPE_MEAS_VPP] = (max - min) / SCOPE_MEAS_Q4_PER_VOLT;
+	result->value[SCOPE_MEAS_VAVG] = (float)sum / count / SCOPE_MEAS_Q4_PER_VOLT;
+	result->value[SCOPE_MEAS_VRMS] = sqrtf((float)sum_sq / count) / SCOPE_MEAS_Q4_PER_VOLT;
+	result->valid = mask & SCOPE_MEAS_AMPLITUDE;
+
+	uint16_t swing = max - min;
+	if (!(mask & ~SCOPE_MEAS_AMPLITUDE) || swing < SCOPE_MEAS_MIN_SWING)
+		return;
+
+	// 第二遍：边沿。state 只在越过高电平/低电平时翻转，相当于以 10%~90% 为迟滞
+	int32_t lo = min + swing / 10, mid = min + swing / 2, hi = max - swing / 10;
+	uint8_t high = sample(0) >= mid;
+	int32_t start = -1;              // 本次翻转中越过起始参考电平 (上升为低电平) 的位置，-1 表示不完整
+	int32_t cross = -1;              // 本次翻转中越过中电平的位置
+	int32_t first_rise = -1, last_rise = -1, first_fall = -1, last_fall = -1;
+	uint16_t rises = 0, falls = 0;
+	uint32_t rise_sum = 0, fall_sum = 0, width_sum = 0;
+	uint16_t rise_n = 0, fall_n = 0, width_n = 0;
+	int32_t prev = sample(0);
+
+	for (uint16_t i = 1; i < count; i++)
+	{
+		int32_t x = sample(i);
+		if (!high)
+		{
+			if (prev < lo && x >= lo)
+				start = SCOPE_Measure_Cross(i, prev, x, lo);
+			if (prev < mid && x >= mid)
+				cross = SCOPE_Measure_Cross(i, prev, x, mid);
+			if (x >= hi)
+			{
+				// 上升沿完成
+				high = 1;
+				if (start >= 0)
+				{
+					rise_sum += SCOPE_Measure_Cross(i, prev, x, hi) - start;
+					rise_n++;
+				}
+				if (cross >= 0)
+				{
+					if (rises++ == 0)
+						first_rise = cross;
+					last_rise = cross;
+				}
+				start = cross = -1;
+			}
+		}
+		else
+		{
+			if (prev > hi && x <= hi)
+				start = SCOPE_Measure_Cross(i, prev, x, hi);
+			if (prev > mid && x <= mid)
+				cross = SCOPE_Measure_Cross(i, prev, x, mid);
+			if (x <= lo)
+			{
+				// 下降沿完成
+				high = 0;
+				if (start >= 0)
+				{
+					fall_sum += SCOPE_Measure_Cross(i, prev, x, lo) - start;
+					fall_n++;
+				}
+				if (cross >= 0)
+				{
+					if (falls++ == 0)
+						first_fall = cross;
+					last_fall = cross;
+					if (rises > 0)
+					{
+						width_sum += cross - last_rise;
+						width_n++;
+					}
+				}
+				start = cross = -1;
+			}
+		}
+		prev = x;
+	}
+
+	// Q8 采样数换算为秒
+	float q8_seconds = 1.0f / (256.0f * sample_rate);
+	uint16_t valid = 0;
+	float period = 0;
+	if (rises >= 2)
+		period = (float)(last_rise - first_rise) / (rises - 1) * q8_seconds;
+	else if (falls >= 2)
+		period = (float)(last_fall - first_fall) / (falls - 1) * q8_seconds;
+	if (period > 0)
+	{
+		result->value[SCOPE_MEAS_PERIOD] = period;
+		result->value[SCOPE_MEAS_FREQ] = 1.0f / period;
+		valid |= SCOPE_MEAS_BIT(SCOPE_MEAS_PERIOD) | SCOPE_MEAS_BIT(SCOPE_MEAS_FREQ);
+	}
+	if (rise_n)
+	{
+		result->value[SCOPE_MEAS_RISE] = (float)rise_sum / rise_n * q8_seconds;
+		valid |= SCOPE_MEAS_BIT(SCOPE_MEAS_RISE);
+	}
+	if (fall_n)
+	{
+		result->value[SCOPE_MEAS_FALL] = (float)fall_sum / fall_n * q8_seconds;
+		valid |= SCOPE_MEAS_BIT(SCOPE_MEAS_FALL);
+	}
+	if (width_n)
+	{
+		result->value[SCOPE_MEAS_PWIDTH] = (float)width_sum / width_n * q8_seconds;
+		valid |= SCOPE_MEAS_BIT(SCOPE_MEAS_PWIDTH);
+		if (period > 0)
+		{
+			result->value[SCOPE_MEAS_DUTY] = result->value[SCOPE_MEAS_PWIDTH] / period * 100.0f;
+			valid |= SCOPE_MEAS_BIT(SCOPE_MEAS_DUTY);
+		}
+	}
+	result->valid |= valid & mask;
+}
+
+/**
+ * @brief  测量冻结窗口中一个通道的采样
+ * @param  channel     通道 (0: CH1，1: CH2)
+ * @param  mask        需要的测量项
+ * @param  sample_rate 窗口的采样率 (Hz)
+ * @param  result      输出：测量结果
+ * @retval 无
+ */
+void SCOPE_Measure_Capture(uint8_t channel, uint16_t mask, float sample_rate, SCOPE_Meas_Result *result)
+{
+	meas_channel = channel;
+	SCOPE_Measure_Run(SCOPE_Measure_Read_Capture, SCOPE_RECORD_LEN, mask, sample_rate, result);
+}
+
+/**
+ * @brief  测量一段码值
+ * @param  codes       12 位码值
+ * @param  count       采样数
+ * @param  mask        需要的测量项
+ * @param  sample_rate 采样率 (Hz)
+ * @param  result      输出：测量结果
+ * @retval 无
+ */
+void SCOPE_Measure_Codes(const uint16_t *codes, uint16_t count, uint16_t mask, float sample_rate, SCOPE_Meas_Result *result)
+{
+	meas_codes = codes;
+	SCOPE_Measure_Run(SCOPE_Measure_Read_Codes, count, mask, sample_rate, result);
+}
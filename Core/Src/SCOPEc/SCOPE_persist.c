@@ -0,0 +1,174 @@
+/**
+ * @file    SCOPE_persist.c
+ * @brief   示波器余辉 (荧光) 显示实现
+ * @details 强度图为抽取后的 4 位/单元图，默认 4x4 像素一个单元，仅占 2400 字节。
+ *          衰减以"级"为单位：余辉时间内 15 级全部衰减完，因此每级间隔为 余辉时间/15。
+ */
+#include "SCOPEh/SCOPE_persist.h"
+#include <stdint.h>
+#include <string.h>
+
+uint8_t scope_persist_map[SCOPE_PERSIST_ROWS][SCOPE_PERSIST_COLS / 2]; // 强度图
+
+static SCOPE_Persist_Mode persist_mode = SCOPE_PERSIST_OFF; // 当前余辉模式
+static uint32_t persist_decay_tick = 0;                      // 上一次衰减的时刻 (ms)
+
+/**
+ * @brief 强度颜色表：由暗蓝经青、绿、黄到白，低强度接近背景以免遮挡网格
+ */
+const uint16_t SCOPE_Persist_LUT[16] = {
+	0x0000, // 0: 无余辉
+	0x0008, 0x0010, 0x0016, 0x011A, // 暗蓝 -> 蓝
+	0x023C, 0x04BC, 0x05F8, 0x07EF, // 蓝 -> 青 -> 青绿
+	0x07E6, 0x3FE0, 0x7FE0, 0xBFE0, // 绿 -> 黄绿
+	0xFFE0, 0xFFEF, 0xFFFF			// 黄 -> 白
+};
+
+/**
+ * @brief  设置余辉模式
+ * @param  mode 余辉模式
+ * @retval 无
+ */
+void SCOPE_Persist_Set_Mode(SCOPE_Persist_Mode mode)
+{
+	persist_mode = mode;
+	SCOPE_Persist_Clear();
+}
+
+/**
+ * @brief  获取当前余辉模式
+ * @retval 当前余辉模式
+ */
+SCOPE_Persist_Mode SCOPE_Persist_Get_Mode(void)
+{
+	return persist_mode;
+}
+
+/**
+ * @brief  清空强度图
+ * @retval 无
+ */
+void SCOPE_Persist_Clear(void)
+{
+	memset(scope_persist_map, 0, sizeof(scope_persist_map));
+}
+
+/**
+ * @brief  按经过的时间衰减强度图
+ * @param  now_ms 当前时刻 (ms)
+ * @retval 1: 有单元变暗，0: 强度图未改变
+ */
+uint8_t SCOPE_Persist_Decay(uint32_t now_ms)
+{
+	uint32_t step_ms; // 每衰减一级所需时间
+
+	switch (persist_mode)
+	{
+	case SCOPE_PERSIST_100MS:
+		step_ms = 100 / 15;
+		break;
+	case SCOPE_PERSIST_1S:
+		step_ms = 1000 / 15;
+		break;
+	default: // 关闭或无限余辉
+		persist_decay_tick = now_ms;
+		return 0;
+	}
+
+	uint32_t levels = (now_ms - persist_decay_tick) / step_ms;
+	if (levels == 0)
+		return 0;
+	persist_decay_tick += levels * step_ms; // 保留不足一级的时间
+	if (levels > 15)
+		levels = 15;
+
+	// 两个 4 位单元分别做饱和减法
+	uint8_t changed = 0;
+	uint8_t *cell = &scope_persist_map[0][0];
+	for (uint16_t i = 0; i < sizeof(scope_persist_map); i++)
+	{
+		if (cell[i] == 0)
+			continue;
+		uint8_t lo = cell[i] & 0x0F;
+		uint8_t hi = cell[i] >> 4;
+		lo = (lo > levels) ? lo - levels : 0;
+		hi = (hi > levels) ? hi - levels : 0;
+		cell[i] = (uint8_t)((hi << 4) | lo);
+		changed = 1;
+	}
+	return changed;
+}
+
+/**
+ * @brief  把一次采集的波形累积到强度图
+ * @param  wave_y 每列的屏幕Y坐标
+ * @param  points 点数 (列数)
+ * @retval 无
+ */
+void SCOPE_Persist_Accumulate(const uint16_t *wave_y, uint16_t points)
+{
+	if (wave_y == NULL || persist_mode == SCOPE_PERSIST_OFF)
+		return;
+
+	if (points > SCOPE_PLOT_WIDTH)
+		points = SCOPE_PLOT_WIDTH;
+
+	for (uint16_t cx = 0; cx < SCOPE_PERSIST_COLS; cx++)
+	{
+		// 先求出该单元列覆盖的所有像素列 (含与下一点的连线) 的Y范围，每个单元只累加一次
+		uint16_t x0 = cx * SCOPE_PERSIST_DECIM_X;
+		if (x0 >= points)
+			break;
+
+		uint16_t lo = wave_y[x0];
+		uint16_t hi = wave_y[x0];
+		for (uint16_t x = x0; x < x0 + SCOPE_PERSIST_DECIM_X && x < points; x++)
+		{
+			uint16_t y = (x + 1 < points) ? wave_y[x + 1] : wave_y[x];
+			if (wave_y[x] < lo)
+				lo = wave_y[x];
+			if (wave_y[x] > hi)
+				hi = wave_y[x];
+			if (y < lo)
+				lo = y;
+			if (y > hi)
+				hi = y;
+		}
+		if (hi >= SCOPE_PLOT_HEIGHT)
+			hi = SCOPE_PLOT_HEIGHT - 1;
+
+		uint8_t shift = (cx & 1) ? 4 : 0;
+		for (uint16_t cy = lo / SCOPE_PERSIST_DECIM_Y; cy <= hi / SCOPE_PERSIST_DECIM_Y; cy++)
+		{
+			uint8_t *cell = &scope_persist_map[cy][cx >> 1];
+			uint8_t v = (*cell >> shift) & 0x0F;
+			v = (v + SCOPE_PERSIST_HIT > 15) ? 15 : v + SCOPE_PERSIST_HIT;
+			*cell = (uint8_t)((*cell & ~(0x0F << shift)) | (v << shift));
+		}
+	}
+}
+
+/**
+ * @brief  把一次采集的散点累积到强度图
+ * @param  xs     每个点的屏幕X坐标
+ * @param  ys     每个点的屏幕Y坐标
+ * @param  points 点数
+ * @retval 无
+ */
+void SCOPE_Persist_Accumulate_Points(const uint16_t *xs, const uint16_t *ys, uint16_t points)
+{
+	if (xs == NULL || ys == NULL || persist_mode == SCOPE_PERSIST_OFF)
+		return;
+
+	for (uint16_t i = 0; i < points; i++)
+	{
+		if (xs[i] >= SCOPE_PLOT_WIDTH || ys[i] >= SCOPE_PLOT_HEIGHT)
+			continue;
+		uint16_t cx = xs[i] / SCOPE_PERSIST_DECIM_X;
+		uint8_t shift = (cx & 1) ? 4 : 0;
+		uint8_t *cell = &scope_persist_map[ys[i] / SCOPE_PERSIST_DECIM_Y][cx >> 1];
+		uint8_t v = (*cell >> shift) & 0x0F;
+		v = (v + SCOPE_PERSIST_POINT_HIT > 15) ? 15 : v + SCOPE_PERSIST_POINT_HIT;
+		*cell = (uint8_t)((*cell & ~(0x0F << shift)) | (v << shift));
+	}
+}
@@ -0,0 +1,123 @@
+/**
+ * @file    SCOPE_render.c
+ * @brief   示波器波形区域条带渲染器实现
+ * @details 借助 TFT_Render_Bands 逐行合成像素：先由网格图层输出整行背景，再叠加余辉和波形，
+ *          结果直接写入发送缓冲区的一半，与另一半的 DMA 传输并行。
+ *          波形按列存储Y坐标，第 x 列覆盖 [min(y[x], y[x+1]), max(y[x], y[x+1])]，
+ *          与逐段画线的效果一致，但判断只需两次比较。
+ *          峰值检测的包络每列本身是一段 [最大值, 最小值]，再向下一列的包络延伸到相接。
+ *          XY 显示的点已按纵坐标排序，每行二分查找到本行的第一个点，只访问本行的点。
+ */
+#include "SCOPEh/SCOPE_render.h"
+#include "SCOPEh/SCOPE_persist.h"
+#include "SCOPEh/SCOPE_graticule.h"
+#include "SCOPEh/SCOPE_xy.h"
+#include "TFTh/TFT_io.h"
+#include <stdint.h>
+
+/**
+ * @brief  计算第 x 列的波形竖直范围
+ * @param  wave   波形Y坐标数组 (包络时为最大值)
+ * @param  env    包络最小值的Y坐标数组，NULL 表示不是包络
+ * @param  points 点数
+ * @param  x      列坐标
+ * @param  lo     输出：范围下限
+ * @param  hi     输出：范围上限
+ */
+static inline void SCOPE_Column_Span(const uint16_t *wave, const uint16_t *env, uint16_t points, uint16_t x, uint16_t *lo, uint16_t *hi)
+{
+	uint16_t n = (x + 1 < points) ? x + 1 : x;
+	uint16_t a_lo = wave[x], a_hi = wave[x];
+	uint16_t b_lo = wave[n], b_hi = wave[n];
+	if (env != NULL)
+	{
+		// 最大值在上 (Y 较小)，最小值在下
+		a_hi = env[x];
+		b_hi = env[n];
+	}
+	// 本列的范围，延伸到与下一列相接
+	*lo = (a_lo < b_hi) ? a_lo : b_hi;
+	*hi = (a_hi > b_lo) ? a_hi : b_lo;
+}
+
+/**
+ * @brief  逐行渲染回调
+ * @param  ctx    SCOPE_Plot 指针
+ * @param  y      行坐标
+ * @param  row_be 行像素输出 (大端序)
+ */
+static void SCOPE_Render_Row(void *ctx, uint16_t y, uint16_t *row_be)
+{
+	const SCOPE_Plot *plot = (const SCOPE_Plot *)ctx;
+	uint16_t lo, hi;
+
+	// 背景：网格图层整行输出，之后只覆盖有内容的像素
+	SCOPE_Graticule_Fill_Row(plot->graticule, y, row_be);
+
+	// 余辉
+	if (plot->persist_enabled)
+	{
+		uint16_t persist_row = y / SCOPE_PERSIST_DECIM_Y;
+		for (uint16_t cx = 0; cx < SCOPE_PERSIST_COLS; cx++)
+		{
+			uint8_t level = SCOPE_Persist_Get(cx, persist_row);
+			if (level == 0)
+				continue;
+			uint16_t color = TFT_COLOR_BE(SCOPE_Persist_LUT[level]);
+			for (uint16_t x = cx * SCOPE_PERSIST_DECIM_X; x < (cx + 1) * SCOPE_PERSIST_DECIM_X; x++)
+				row_be[x] = color;
+		}
+	}
+
+	// XY：每个点为 2x2 像素，本行包括纵坐标为 y-1 和 y 的点
+	if (plot->xy)
+	{
+		uint16_t color = TFT_COLOR_BE(WHITE);
+		uint16_t i = SCOPE_Xy_Lower_Bound(plot->wave2, plot->points, y ? y - 1 : 0);
+		for (; i < plot->points && plot->wave2[i] <= y; i++)
+		{
+			uint16_t x = plot->wave1[i];
+			row_be[x] = color;
+			if (x + 1 < SCOPE_PLOT_WIDTH)
+				row_be[x + 1] = color;
+		}
+		return;
+	}
+
+	// 波形 (通道1在最上层)
+	for (uint16_t x = 0; x < plot->points; x++)
+	{
+		if (plot->math != NULL)
+		{
+			SCOPE_Column_Span(plot->math, NULL, plot->points, x, &lo, &hi);
+			if (y >= lo && y <= hi)
+				row_be[x] = TFT_COLOR_BE(GREEN);
+		}
+		if (plot->ch2_enabled)
+		{
+			SCOPE_Column_Span(plot->wave2, plot->env2, plot->points, x, &lo, &hi);
+			if (y >= lo && y <= hi)
+				row_be[x] = TFT_COLOR_BE(CYAN);
+		}
+		if (plot->ch1_enabled)
+		{
+			SCOPE_Column_Span(plot->wave1, plot->env1, plot->points, x, &lo, &hi);
+			if (y >= lo && y <= hi)
+				row_be[x] = TFT_COLOR_BE(YELLOW);
+		}
+	}
+}
+
+/**
+ * @brief  渲染整个波形区域
+ * @param  htft TFT句柄指针
+ * @param  plot 绘制参数
+ * @retval 无
+ */
+void SCOPE_Render_Plot(TFT_HandleTypeDef *htft, const SCOPE_Plot *plot)
+{
+	if (htft == NULL || plot == NULL || plot->graticule == NULL)
+		return;
+
+	TFT_Render_Bands(htft, 0, 0, SCOPE_PLOT_WIDTH, SCOPE_PLOT_HEIGHT, SCOPE_Render_Row, (void *)plot);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file    SCOPE_roll.c
+ * @brief   示波器滚动模式数据流实现
+ * @details 单生产者 (DMA 中断) 单消费者 (主循环) 队列：中断只写 roll_head，
+ *          主循环只写 roll_tail，不需要临界区。
+ *          队列在采样存储的工作区中，不是其使用者时放入的列被丢弃，读出为空。
+ */
+#include "SCOPEh/SCOPE_roll.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define SCOPE_ROLL_MASK (SCOPE_ROLL_FIFO_LEN - 1)
+
+#if SCOPE_ROLL_FIFO_LEN * 8 > SCOPE_SMEM_WORK_BYTES
+#error "SCOPE_SMEM_WORK_BYTES 放不下滚动模式的列队列"
+#endif
+
+static SCOPE_Roll_Column *roll_fifo = NULL; // 列队列 (采样存储的工作区)
+static volatile uint16_t roll_head = 0;     // 下一个写入位置 (中断写)
+static volatile uint16_t roll_tail = 0;     // 下一个读取位置 (主循环写)
+
+/**
+ * @brief  放入一列
+ * @param  max1 通道1最大值
+ * @param  min1 通道1最小值
+ * @param  max2 通道2最大值
+ * @param  min2 通道2最小值
+ * @retval 无
+ */
+static void SCOPE_Roll_Push(uint16_t max1, uint16_t min1, uint16_t max2, uint16_t min2)
+{
+	if (SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_ROLL)
+		return;
+
+	uint16_t head = roll_head;
+	if ((uint16_t)(head - roll_tail) >= SCOPE_ROLL_FIFO_LEN)
+		return; // 队列满，丢弃
+
+	SCOPE_Roll_Column *column = &roll_fifo[head & SCOPE_ROLL_MASK];
+	column->max[0] = max1;
+	column->min[0] = min1;
+	column->max[1] = max2;
+	column->min[1] = min2;
+	roll_head = head + 1;
+}
+
+/**
+ * @brief  数据块输出 (普通/高分辨率方式)
+ * @param  words 每列一个打包的数据字
+ * @param  count 字数
+ * @param  mode  采集模式
+ * @retval 无
+ */
+void SCOPE_Roll_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	// 高分辨率方式的 Q4 平均值四舍五入为 12 位码值，一行像素远分辨不出小数位
+	const uint8_t bits = SCOPE_Decim_Get_Frac_Bits();
+	const uint16_t half = bits ? (1 << (bits - 1)) : 0;
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		uint16_t lo = (uint16_t)(((words[i] & 0xFFFF) + half) >> bits);
+		uint16_t hi = (uint16_t)(((words[i] >> 16) + half) >> bits);
+		if (mode == SCOPE_ACQ_SIMULTANEOUS)
+		{
+			SCOPE_Roll_Push(lo, lo, hi, hi);
+		}
+		else if (mode == SCOPE_ACQ_INTERLEAVED_CH1)
+		{
+			SCOPE_Roll_Push(hi, hi, SCOPE_ADC_ZERO_CODE, SCOPE_ADC_ZERO_CODE); // 较早的采样在高16位
+			SCOPE_Roll_Push(lo, lo, SCOPE_ADC_ZERO_CODE, SCOPE_ADC_ZERO_CODE);
+		}
+		else
+		{
+			SCOPE_Roll_Push(SCOPE_ADC_ZERO_CODE, SCOPE_ADC_ZERO_CODE, hi, hi);
+			SCOPE_Roll_Push(SCOPE_ADC_ZERO_CODE, SCOPE_ADC_ZERO_CODE, lo, lo);
+		}
+	}
+}
+
+/**
+ * @brief  包络输出 (峰值检测方式)
+ * @param  min_words 每列各通道的最小值
+ * @param  max_words 每列各通道的最大值
+ * @param  count     列数
+ * @retval 无
+ */
+void SCOPE_Roll_Envelope_Block(const uint32_t *min_words, const uint32_t *max_words, uint16_t count)
+{
+	for (uint16_t i = 0; i < count; i++)
+	{
+		SCOPE_Roll_Push((uint16_t)(max_words[i] & 0xFFFF), (uint16_t)(min_words[i] & 0xFFFF),
+						(uint16_t)(max_words[i] >> 16), (uint16_t)(min_words[i] >> 16));
+	}
+}
+
+/**
+ * @brief  取出最早的一列
+ * @param  column 输出：列数据
+ * @retval 1: 已取出，0: 队列为空
+ */
+uint8_t SCOPE_Roll_Read(SCOPE_Roll_Column *column)
+{
+	uint16_t tail = roll_tail;
+	if (tail == roll_head || SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_ROLL)
+		return 0;
+	*column = roll_fifo[tail & SCOPE_ROLL_MASK];
+	roll_tail = tail + 1;
+	return 1;
+}
+
+/**
+ * @brief  丢弃队列中尚未取出的列
+ * @retval 无
+ */
+void SCOPE_Roll_Reset(void)
+{
+	if (SCOPE_Smem_Get_Work_Owner() != SCOPE_SMEM_ROLL)
+		roll_fifo = (SCOPE_Roll_Column *)SCOPE_Smem_Claim(SCOPE_SMEM_ROLL);
+	roll_tail = roll_head;
+}
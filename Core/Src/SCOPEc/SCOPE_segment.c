@@ -0,0 +1,139 @@
+/**
+ * @file    SCOPE_segment.c
+ * @brief   示波器分段存储实现
+ * @details 段按序号依次存放在采样存储区中，每段大小在设置分段数时按通道和存储格式确定。
+ *          存储区由主循环在设置分段数和开始新的序列时取得，中断只检查使用者，
+ *          被其它使用者占用时不再保存，已采集的段随之作废。
+ *          窗口冻结回调只记录时间戳并用 SCOPE_Capture_Save_Later 安排保存，打包分摊到之后的数据块中，
+ *          保存完成时才计入已采集的段数。最后一段保存期间窗口已冻结，由主循环完成。
+ *          序列完成后再次启动采集 (主循环调用 SCOPE_Capture_Rearm) 时自动从第 1 段重新开始。
+ */
+#include "SCOPEh/SCOPE_segment.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+#include <stddef.h>
+
+static SCOPE_Capture_Info segm_info[SCOPE_SEGM_MAX]; // 每段的窗口描述
+static uint32_t segm_time[SCOPE_SEGM_MAX];           // 每段的时间戳 (us)
+
+static uint16_t segm_count = 1;                          // 分段数 (1 表示关闭)
+static uint16_t segm_bytes = SCOPE_RECORD_LEN;           // 每段字节数
+static uint8_t segm_channels = 3;                        // 保存的通道
+static SCOPE_Smem_Format segm_format = SCOPE_SMEM_12BIT; // 存储格式
+static volatile uint16_t segm_done = 0;                  // 已保存完的段数 (中断写，主循环读)
+static uint8_t *segm_memory = NULL;                      // 记录区 (主循环取得)
+
+/**
+ * @brief  保存完成回调：计入一段
+ * @retval 无
+ */
+static void SCOPE_Segment_Saved(void)
+{
+	segm_done++;
+}
+
+/**
+ * @brief  窗口冻结回调：安排保存一段
+ * @retval 1: 还有未采集的段，继续等待触发；0: 序列完成或存储区已被占用，保持冻结
+ * @note   上一段的保存完成之前不会再冻结窗口，此时 segm_done 就是本段的序号
+ */
+static uint8_t SCOPE_Segment_Store(void)
+{
+	if (SCOPE_Smem_Get_Owner() != SCOPE_SMEM_SEGMENT)
+		return 0;
+	if (segm_done >= segm_count)
+		segm_done = 0; // 上一个序列已完成，采集重新启动后开始新的序列
+
+	uint16_t index = segm_done;
+	segm_time[index] = SCOPE_Acq_Timestamp();
+	SCOPE_Capture_Save_Later(&segm_memory[index * segm_bytes], segm_channels, segm_format, &segm_info[index],
+							 SCOPE_Segment_Saved);
+	return index + 1 < segm_count;
+}
+
+/**
+ * @brief  设置分段数并开始新的分段序列
+ * @param  count    分段数
+ * @param  channels 采集的通道 (bit0: CH1，bit1: CH2)
+ * @param  format   存储格式
+ * @retval 实际分段数
+ */
+uint16_t SCOPE_Segment_Set_Count(uint16_t count, uint8_t channels, SCOPE_Smem_Format format)
+{
+	segm_channels = channels;
+	segm_format = format;
+	segm_bytes = SCOPE_Smem_Bytes(format, SCOPE_RECORD_LEN);
+	if ((channels & 3) == 3)
+		segm_bytes *= 2;
+
+	uint16_t max = SCOPE_SMEM_BYTES / segm_bytes;
+	if (max > SCOPE_SEGM_MAX)
+		max = SCOPE_SEGM_MAX;
+	if (count > max)
+		count = max;
+	if (count < 1)
+		count = 1;
+
+	segm_count = count;
+	segm_done = 0;
+	if (count > 1 && SCOPE_Smem_Get_Owner() <= SCOPE_SMEM_SEGMENT) // 长记录或频谱分析正在使用时，回到触发模式后再取得
+		segm_memory = SCOPE_Smem_Claim(SCOPE_SMEM_SEGMENT);
+	SCOPE_Capture_Set_Window_Handler(count > 1 ? SCOPE_Segment_Store : NULL);
+	return count;
+}
+
+/**
+ * @brief  获取分段数
+ * @retval 分段数
+ */
+uint16_t SCOPE_Segment_Get_Count(void)
+{
+	return segm_count;
+}
+
+/**
+ * @brief  丢弃已采集的段
+ * @retval 无
+ */
+void SCOPE_Segment_Reset(void)
+{
+	segm_done = 0;
+	if (segm_count > 1)
+		segm_memory = SCOPE_Smem_Claim(SCOPE_SMEM_SEGMENT);
+}
+
+/**
+ * @brief  获取已采集的段数
+ * @retval 段数
+ */
+uint16_t SCOPE_Segment_Get_Done(void)
+{
+	SCOPE_Capture_Save_Finish(); // 序列完成时最后一段尚未保存完
+	return (SCOPE_Smem_Get_Owner() == SCOPE_SMEM_SEGMENT) ? segm_done : 0;
+}
+
+/**
+ * @brief  把一段装入采集记录的冻结窗口
+ * @param  index 段序号 (0 起)
+ * @retval 1: 成功，0: 失败
+ */
+uint8_t SCOPE_Segment_Select(uint16_t index)
+{
+	if (index >= SCOPE_Segment_Get_Done() || !SCOPE_Capture_Ready())
+		return 0;
+	SCOPE_Capture_Load(&segm_memory[index * segm_bytes], segm_format, &segm_info[index]);
+	return 1;
+}
+
+/**
+ * @brief  获取一段相对第 1 段的触发时刻
+ * @param  index 段序号 (0 起)
+ * @retval 时间差 (us)
+ */
+uint32_t SCOPE_Segment_Get_Time(uint16_t index)
+{
+	if (index >= SCOPE_Segment_Get_Done())
+		return 0;
+	return segm_time[index] - segm_time[0];
+}
@@ -0,0 +1,88 @@
+/**
+ * @file    SCOPE_smem.c
+ * @brief   示波器紧凑采样存储实现
+ * @details 12 位格式的块解包先对齐到一对采样的开头，之后每次读三个字节解出两个采样，
+ *          不再为每个采样计算字节位置。
+ *          采样存储区只记录使用者，不保存内容的描述，由使用者自己管理。
+ *          记录区和工作区在同一个数组中，工作区紧接在记录区之后。
+ */
+#include "SCOPEh/SCOPE_smem.h"
+#include <stdint.h>
+
+static uint32_t smem_pool[(SCOPE_SMEM_BYTES + SCOPE_SMEM_WORK_BYTES) / 4]; // 采样存储区 (按字对齐，频谱分析按 16/32 位访问)
+static volatile SCOPE_Smem_Owner smem_owner = SCOPE_SMEM_FREE;            // 记录区的使用者
+static volatile SCOPE_Smem_Owner smem_work_owner = SCOPE_SMEM_FREE;       // 工作区的使用者
+
+/**
+ * @brief  按块连续解包
+ * @param  src    打包数据
+ * @param  format 存储格式
+ * @param  first  第一个采样的序号
+ * @param  count  采样数
+ * @param  codes  输出：12 位码值
+ * @retval 无
+ */
+void SCOPE_Smem_Unpack(const uint8_t *src, SCOPE_Smem_Format format, uint16_t first, uint16_t count, uint16_t *codes)
+{
+	if (format == SCOPE_SMEM_8BIT)
+	{
+		const uint8_t *p = src + first;
+		while (count--)
+			*codes++ = (uint16_t)((*p++ << 4) | 0x08);
+		return;
+	}
+
+	// 从一对采样的后一个开始
+	if ((first & 1) && count)
+	{
+		*codes++ = SCOPE_Smem_Get(src, format, first++);
+		count--;
+	}
+
+	const uint8_t *p = src + (uint32_t)(first >> 1) * 3;
+	while (count >= 2)
+	{
+		uint8_t b1 = p[1];
+		codes[0] = (uint16_t)(p[0] | ((b1 & 0x0F) << 8));
+		codes[1] = (uint16_t)((b1 >> 4) | (p[2] << 4));
+		codes += 2;
+		p += 3;
+		count -= 2;
+	}
+	if (count)
+		*codes = (uint16_t)(p[0] | ((p[1] & 0x0F) << 8));
+}
+
+/**
+ * @brief  取得采样存储区
+ * @param  owner 新的使用者
+ * @retval 使用者所在的区域
+ */
+uint8_t *SCOPE_Smem_Claim(SCOPE_Smem_Owner owner)
+{
+	if (owner >= SCOPE_SMEM_ENVELOPE)
+	{
+		smem_work_owner = owner;
+		return (uint8_t *)smem_pool + SCOPE_SMEM_BYTES;
+	}
+	smem_owner = owner;
+	return (uint8_t *)smem_pool;
+}
+
+/**
+ * @brief  获取记录区当前的使用者
+ * @retval 使用者
+ */
+SCOPE_Smem_Owner SCOPE_Smem_Get_Owner(void)
+{
+	return smem_owner;
+}
+
+/**
+ * @brief  获取工作区当前的使用者
+ * @retval 使用者
+ */
+SCOPE_Smem_Owner SCOPE_Smem_Get_Work_Owner(void)
+{
+	return smem_work_owner;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file    SCOPE_xy.c
+ * @brief   示波器 XY (李萨如) 显示实现
+ * @details 坐标换算与采集记录相同，用 Q16 定点系数避免逐点浮点运算。
+ *          排序用插入排序：点数只有一屏 (240)，周期信号相邻的点纵坐标接近，移动次数远小于最坏情况。
+ */
+#include "SCOPEh/SCOPE_xy.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_acq.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief  码值换算为坐标并限制在正方形内
+ * @param  code      12 位码值
+ * @param  scale_q16 每个码值对应的像素 (Q16)，向下为正时取负
+ * @param  center    原点坐标
+ * @param  low       正方形的起点
+ * @retval 屏幕坐标
+ */
+static inline uint16_t SCOPE_Xy_Position(uint16_t code, int32_t scale_q16, int32_t center, int32_t low)
+{
+	int32_t p = center + (int32_t)(((int64_t)((int32_t)code - SCOPE_ADC_ZERO_CODE) * scale_q16) >> 16);
+	if (p < low)
+		p = low;
+	if (p > low + SCOPE_XY_SIZE - 1)
+		p = low + SCOPE_XY_SIZE - 1;
+	return (uint16_t)p;
+}
+
+/**
+ * @brief  把冻结窗口转换为按纵坐标排序的点
+ * @param  xs              输出：每个点的屏幕X坐标
+ * @param  ys              输出：每个点的屏幕Y坐标
+ * @param  points          点数
+ * @param  x_volts_per_div CH1 电压刻度 (V/div)
+ * @param  y_volts_per_div CH2 电压刻度 (V/div)
+ * @retval 1: 已输出，0: 窗口不是双通道同步采集
+ */
+uint8_t SCOPE_Xy_To_Screen(uint16_t *xs, uint16_t *ys, uint16_t points, float x_volts_per_div, float y_volts_per_div)
+{
+	if (xs == NULL || ys == NULL || x_volts_per_div <= 0 || y_volts_per_div <= 0)
+		return 0;
+	if (SCOPE_Capture_Get_Mode() != SCOPE_ACQ_SIMULTANEOUS)
+		return 0;
+	if (points > SCOPE_RECORD_LEN)
+		points = SCOPE_RECORD_LEN;
+
+	int32_t x_scale = (int32_t)(SCOPE_GRID_SIZE / (x_volts_per_div * SCOPE_CODES_PER_VOLT) * 65536.0f);
+	int32_t y_scale = -(int32_t)(SCOPE_GRID_SIZE / (y_volts_per_div * SCOPE_CODES_PER_VOLT) * 65536.0f); // 正电压向上
+
+	for (uint16_t i = 0; i < points; i++)
+	{
+		uint16_t x = SCOPE_Xy_Position(SCOPE_Capture_Sample(0, i), x_scale, SCOPE_PLOT_WIDTH / 2, (SCOPE_PLOT_WIDTH - SCOPE_XY_SIZE) / 2);
+		uint16_t y = SCOPE_Xy_Position(SCOPE_Capture_Sample(1, i), y_scale, SCOPE_PLOT_HEIGHT / 2, SCOPE_XY_TOP);
+
+		// 插入排序：按纵坐标插入已排好的前 i 个点
+		uint16_t j = i;
+		for (; j > 0 && ys[j - 1] > y; j--)
+		{
+			ys[j] = ys[j - 1];
+			xs[j] = xs[j - 1];
+		}
+		ys[j] = y;
+		xs[j] = x;
+	}
+	return 1;
+}
@@ -147,7 +147,7 @@ void TFT_Button_Draw(TFT_HandleTypeDef* htft, TFT_Button* btn)
                              (btn->text_color & 0x7BEF) : btn->text_color;
         
         // 使用TFT_Show_String函数显示文本
-        TFT_Show_String(htft, text_x, text_y, (uint8_t*)btn->text, text_color, bg_color, btn->text_size, 0);
+        TFT_Show_String(htft, text_x, text_y, btn->text, text_color, bg_color, btn->text_size, 0);
     }
 }
 
@@ -314,7 +314,7 @@ void TFT_ProgressBar_Draw(TFT_HandleTypeDef* htft, TFT_ProgressBar* bar)
             text_bg_color = bar->bg_color;
         }
         
-        TFT_Show_String(htft, text_x, text_y, (uint8_t*)percent_text, text_color, text_bg_color, 16, 0);
+        TFT_Show_String(htft, text_x, text_y, percent_text, text_color, text_bg_color, 16, 0);
     }
 }
 
@@ -528,7 +528,7 @@ void TFT_Label_Draw(TFT_HandleTypeDef* htft, TFT_Label* label)
     
     // 显示文本
     uint8_t mode = label->transparent_bg ? 1 : 0;
-    TFT_Show_String(htft, text_x, text_y, (uint8_t*)label->text, 
+    TFT_Show_String(htft, text_x, text_y, label->text, 
                    label->text_color, label->bg_color, label->text_size, mode);
 }
 
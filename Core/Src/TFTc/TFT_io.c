@@ -23,6 +23,8 @@ static TFT_HandleTypeDef *g_tft_handles[MAX_TFT_DEVICES] = {NULL}; // TFT设备
 // --- 内部辅助函数声明 ---
 static void TFT_Wait_DMA_Transfer_Complete(TFT_HandleTypeDef *htft); // 等待 DMA 传输完成
 static void TFT_Register_Device(TFT_HandleTypeDef *htft);			 // 注册TFT设备
+static void TFT_Precompute_Pin_Masks(TFT_HandleTypeDef *htft);		 // 预计算引脚写入值
+static void TFT_Claim_Buffer(TFT_HandleTypeDef *htft);				 // 取得共用的发送缓冲区
 
 //----------------- TFT 初始化与配置函数实现 -----------------
 
@@ -41,6 +43,7 @@ void TFT_Init_Instance(TFT_HandleTypeDef *htft, SPI_HandleTypeDef *hspi,
 	htft->spi_handle = hspi;
 	htft->cs_port = cs_port;
 	htft->cs_pin = cs_pin;
+	TFT_Precompute_Pin_Masks(htft);
 
 	// 设置默认缓冲区大小
 	htft->buffer_size = TFT_BUFFER_SIZE;
@@ -75,6 +78,22 @@ void TFT_Config_Pins(TFT_HandleTypeDef *htft,
 	htft->res_pin = res_pin;
 	htft->bl_port = bl_port;
 	htft->bl_pin = bl_pin;
+	TFT_Precompute_Pin_Masks(htft);
+}
+
+/**
+ * @brief  预先计算 CS/DC 引脚的 BSRR 写入值
+ * @param  htft TFT句柄指针
+ * @retval 无
+ * @note   BSRR 低16位写1置位、高16位写1复位，一次写入即可完成引脚切换，
+ *         无需 HAL_GPIO_WritePin 的参数检查和分支，也不存在读-改-写竞争，可在中断中安全调用。
+ */
+static void TFT_Precompute_Pin_Masks(TFT_HandleTypeDef *htft)
+{
+	htft->cs_bsrr[0] = (uint32_t)htft->cs_pin << 16;
+	htft->cs_bsrr[1] = htft->cs_pin;
+	htft->dc_bsrr[0] = (uint32_t)htft->dc_pin << 16;
+	htft->dc_bsrr[1] = htft->dc_pin;
 }
 
 /**
@@ -114,6 +133,8 @@ static void TFT_Register_Device(TFT_HandleTypeDef *htft)
 
 //----------------- TFT 控制引脚函数实现 (依赖于具体硬件平台 HAL) -----------------
 // 这些函数通过调用 HAL 库函数来控制 TFT 的 GPIO 引脚。
+// CS/DC 在每次命令和数据传输时都会切换 (包括 DMA 完成中断中)，因此直接写 BSRR 寄存器；
+// RES/BL 只在初始化时使用，仍通过 HAL_GPIO_WritePin。
 // 如果更换硬件平台，需要修改这些函数的实现以适配新的 GPIO 控制方式。
 
 /**
@@ -141,7 +162,7 @@ void TFT_Pin_RES_Set(TFT_HandleTypeDef *htft, uint8_t level)
 void TFT_Pin_DC_Set(TFT_HandleTypeDef *htft, uint8_t level)
 {
 #ifdef STM32HAL
-	HAL_GPIO_WritePin(htft->dc_port, htft->dc_pin, (GPIO_PinState)level);
+	htft->dc_port->BSRR = htft->dc_bsrr[level != 0]; // 单次寄存器写入 (见 TFT_Precompute_Pin_Masks)
 #elif defined(SOME_OTHER_PLATFORM)
 	// 在此添加其他平台的 GPIO 控制代码
 	// 例如: OtherPlatform_GPIOWrite(htft->dc_pin, level);
@@ -158,7 +179,7 @@ void TFT_Pin_DC_Set(TFT_HandleTypeDef *htft, uint8_t level)
 void TFT_Pin_CS_Set(TFT_HandleTypeDef *htft, uint8_t level)
 {
 #ifdef STM32HAL
-	HAL_GPIO_WritePin(htft->cs_port, htft->cs_pin, (GPIO_PinState)level);
+	htft->cs_port->BSRR = htft->cs_bsrr[level != 0]; // 单次寄存器写入 (见 TFT_Precompute_Pin_Masks)
 #elif defined(SOME_OTHER_PLATFORM)
 	// 在此添加其他平台的 GPIO 控制代码
 	// 例如: OtherPlatform_GPIOWrite(htft->cs_pin, level);
@@ -287,6 +308,9 @@ void TFT_Buffer_Write16(TFT_HandleTypeDef *htft, uint16_t data)
 	if (htft == NULL || htft->tx_buffer == NULL)
 		return;
 
+	if (htft->buffer_write_index == 0)
+		TFT_Claim_Buffer(htft); // 开始填充前确认共用缓冲区的其它设备已不再使用
+
 	// 检查缓冲区剩余空间是否足够存放 16 位数据 (2字节)
 	if (htft->buffer_write_index >= htft->buffer_size - 1)
 	{
@@ -341,6 +365,16 @@ void TFT_IO_Init(TFT_HandleTypeDef *htft)
 		return;
 	}
 
+#if TFT_SHARE_BUFFER
+	// 复用其它设备的发送缓冲区
+	for (int i = 0; i < MAX_TFT_DEVICES && htft->tx_buffer == NULL; i++)
+	{
+		TFT_HandleTypeDef *other = g_tft_handles[i];
+		if (other != NULL && other != htft && other->tx_buffer != NULL && other->buffer_size >= htft->buffer_size)
+			htft->tx_buffer = other->tx_buffer;
+	}
+#endif
+
 	// 分配发送缓冲区内存
 	if (htft->tx_buffer == NULL)
 	{
@@ -402,6 +436,32 @@ static void TFT_Wait_DMA_Transfer_Complete(TFT_HandleTypeDef *htft)
 	// 如果 DMA 未启用或没有活动的传输，此函数立即返回。
 }
 
+/**
+ * @brief  取得共用的发送缓冲区 (内部辅助函数)
+ * @param  htft TFT句柄指针
+ * @retval 无
+ * @note   共用同一缓冲区的其它设备如有未发送的数据，先阻塞发送；如有正在进行的 DMA，等待其完成。
+ *         在本设备开始向缓冲区写入之前调用。
+ */
+static void TFT_Claim_Buffer(TFT_HandleTypeDef *htft)
+{
+#if TFT_SHARE_BUFFER
+	for (int i = 0; i < MAX_TFT_DEVICES; i++)
+	{
+		TFT_HandleTypeDef *other = g_tft_handles[i];
+		if (other == NULL || other == htft || other->tx_buffer != htft->tx_buffer)
+			continue;
+
+		if (other->buffer_write_index > 0)
+			TFT_Flush_Buffer(other, 1);
+		else
+			TFT_Wait_DMA_Transfer_Complete(other);
+	}
+#else
+	(void)htft;
+#endif
+}
+
 /**
  * @brief  向 TFT 写入 8 位数据 (主要用于初始化序列中的参数)
  * @param  htft TFT句柄指针
@@ -532,6 +592,57 @@ void TFT_Set_Address(TFT_HandleTypeDef *htft, uint16_t x_start, uint16_t y_start
 	TFT_Write_Command(htft, 0x2C);
 }
 
+/**
+ * @brief  分条带渲染一个矩形区域 (双缓冲)
+ * @param  htft   TFT句柄指针
+ * @param  x      区域左上角列坐标
+ * @param  y      区域左上角行坐标
+ * @param  width  区域宽度
+ * @param  height 区域高度
+ * @param  render 逐行渲染回调
+ * @param  ctx    传给回调的上下文指针
+ * @retval 无
+ * @note   TFT_Buffer_Write16 在缓冲区满时以非阻塞方式发送，随后立即覆盖同一缓冲区，
+ *         对单色填充无影响，但逐像素变化的内容会被破坏。这里把缓冲区一分为二交替使用，
+ *         TFT_SPI_Send 在启动下一次传输前会等待上一次完成，因此正在发送的一半不会被改写。
+ */
+void TFT_Render_Bands(TFT_HandleTypeDef *htft, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+					  TFT_Row_Render_Func render, void *ctx)
+{
+	if (htft == NULL || htft->tx_buffer == NULL || render == NULL || width == 0 || height == 0)
+		return;
+
+	uint16_t half_size = (htft->buffer_size / 2) & ~0x3U; // 每半区字节数 (保持4字节对齐)
+	uint16_t row_bytes = width * 2;
+	uint16_t rows_per_band = half_size / row_bytes;
+	if (rows_per_band == 0)
+		return; // 一行都放不下半个缓冲区
+
+	TFT_Set_Address(htft, x, y, x + width - 1, y + height - 1); // 整个区域只设置一次窗口
+	TFT_Reset_Buffer(htft);
+	TFT_Claim_Buffer(htft);
+
+	uint8_t half = 0;
+	uint16_t row = 0;
+	while (row < height)
+	{
+		uint8_t *band = htft->tx_buffer + (half ? half_size : 0);
+		uint16_t rows = height - row;
+		if (rows > rows_per_band)
+			rows = rows_per_band;
+
+		for (uint16_t r = 0; r < rows; r++)
+		{
+			render(ctx, y + row + r, (uint16_t *)(band + r * row_bytes));
+		}
+
+		row += rows;
+		// 最后一条带等待传输完成，保证返回后可以安全地发送命令
+		TFT_SPI_Send(htft, band, rows * row_bytes, row >= height);
+		half ^= 1;
+	}
+}
+
 /**
  * @brief  将RGB颜色值转换为RGB565格式
  * @param  r  红色分量，范围0-255
@@ -0,0 +1,156 @@
+/**
+ * @file    TFT_scroll.c
+ * @brief   TFT硬件垂直滚动实现
+ * @details 利用控制器的 VSCRDEF/VSCSAD 寄存器实现整屏平移。滚动显示时每次只需写入一行像素，
+ *          而不是重绘整屏：240x320 屏幕一行仅 480 字节，约为整帧的 1/320。
+ */
+#include "TFTh/TFT_scroll.h"
+#include "TFTh/TFT_io.h"
+#include <stdint.h>
+
+/**
+ * @brief  设置垂直滚动区域 (VSCRDEF, 0x33)
+ * @param  htft TFT句柄指针
+ * @param  top_fixed    顶部固定区域行数
+ * @param  scroll_lines 滚动区域行数
+ * @param  bottom_fixed 底部固定区域行数
+ * @retval 无
+ */
+void TFT_Set_Scroll_Area(TFT_HandleTypeDef *htft, uint16_t top_fixed, uint16_t scroll_lines, uint16_t bottom_fixed)
+{
+	if (htft == NULL)
+		return;
+
+	TFT_Write_Command(htft, 0x33); // VSCRDEF - Vertical Scrolling Definition
+	TFT_Write_Data16(htft, top_fixed);
+	TFT_Write_Data16(htft, scroll_lines);
+	TFT_Write_Data16(htft, bottom_fixed);
+}
+
+/**
+ * @brief  设置垂直滚动起始地址 (VSCSAD, 0x37)
+ * @param  htft TFT句柄指针
+ * @param  line 显示在滚动区域第一行的帧存储器行号
+ * @retval 无
+ */
+void TFT_Set_Scroll_Start(TFT_HandleTypeDef *htft, uint16_t line)
+{
+	if (htft == NULL)
+		return;
+
+	TFT_Write_Command(htft, 0x37); // VSCSAD - Vertical Scroll Start Address of RAM
+	TFT_Write_Data16(htft, line);
+}
+
+/**
+ * @brief  初始化滚动条带
+ * @param  roll  滚动条带句柄
+ * @param  htft  TFT句柄指针
+ * @param  lines 滚动轴方向的行数
+ * @param  depth 每行像素数
+ * @retval 无
+ */
+void TFT_Roll_Init(TFT_Roll *roll, TFT_HandleTypeDef *htft, uint16_t lines, uint16_t depth)
+{
+	if (roll == NULL || htft == NULL || lines == 0)
+		return;
+
+	roll->htft = htft;
+	roll->lines = lines;
+	roll->depth = depth;
+	roll->head = 0;
+
+	// 与 TFT_init.c 中 TFT_Set_Direction 的 MADCTL 表保持一致:
+	// 方向0: 0x00, 方向1: 0xA0 (MY|MV), 方向2: 0xC0 (MY|MX), 方向3: 0x60 (MX|MV)
+	switch (htft->display_direction)
+	{
+	case 1:
+		roll->along_x = 1;
+		roll->reversed = 1;
+		break;
+	case 2:
+		roll->along_x = 0;
+		roll->reversed = 1;
+		break;
+	case 3:
+		roll->along_x = 1;
+		roll->reversed = 0;
+		break;
+	default:
+		roll->along_x = 0;
+		roll->reversed = 0;
+		break;
+	}
+
+	TFT_Set_Scroll_Area(htft, 0, lines, 0); // 整个帧存储器参与滚动
+	TFT_Set_Scroll_Start(htft, 0);
+}
+
+/**
+ * @brief  开始写入新的一行
+ * @param  roll 滚动条带句柄
+ * @retval 该行在滚动轴上的逻辑坐标
+ */
+uint16_t TFT_Roll_Begin_Line(TFT_Roll *roll)
+{
+	uint16_t mem_line; // 本次写入的帧存储器行
+	uint16_t logical;  // 对应的逻辑坐标
+
+	if (roll == NULL || roll->htft == NULL)
+		return 0;
+
+	// MY=1 时逻辑坐标递增对应帧存储器行递减，此时 head 反向移动，
+	// 保证新行总是出现在逻辑坐标的末端 (屏幕右侧或底部)
+	if (roll->reversed)
+	{
+		roll->head = (roll->head + roll->lines - 1) % roll->lines;
+		mem_line = roll->head;
+		logical = roll->lines - 1 - mem_line;
+	}
+	else
+	{
+		mem_line = roll->head;
+		logical = mem_line;
+	}
+
+	if (roll->along_x)
+		TFT_Set_Address(roll->htft, logical, 0, logical, roll->depth - 1);
+	else
+		TFT_Set_Address(roll->htft, 0, logical, roll->depth - 1, logical);
+
+	TFT_Reset_Buffer(roll->htft);
+	return logical;
+}
+
+/**
+ * @brief  结束当前行并移动滚动起始行
+ * @param  roll 滚动条带句柄
+ * @retval 无
+ */
+void TFT_Roll_End_Line(TFT_Roll *roll)
+{
+	if (roll == NULL || roll->htft == NULL)
+		return;
+
+	TFT_Flush_Buffer(roll->htft, 1); // 行数据必须在改变滚动起始行之前写完
+
+	if (!roll->reversed)
+		roll->head = (roll->head + 1) % roll->lines; // 最旧的一行成为新的第一行，新行位于扫描末尾
+	// reversed 时 head 已在 Begin 中前移，新行即为扫描的第一行
+
+	TFT_Set_Scroll_Start(roll->htft, roll->head);
+}
+
+/**
+ * @brief  退出滚动显示
+ * @param  roll 滚动条带句柄
+ * @retval 无
+ */
+void TFT_Roll_Reset(TFT_Roll *roll)
+{
+	if (roll == NULL || roll->htft == NULL)
+		return;
+
+	roll->head = 0;
+	TFT_Set_Scroll_Start(roll->htft, 0);
+}
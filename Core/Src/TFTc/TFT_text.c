@@ -74,7 +74,7 @@ static void _TFT_Draw_Glyph(TFT_HandleTypeDef *htft, uint16_t x, uint16_t y, con
  * @param  size       字体大小 (支持 8, 12, 16)
  * @param  mode       模式 (0: 背景不透明, 1: 背景透明)
  */
-void TFT_Show_String(TFT_HandleTypeDef *htft, uint16_t x, uint16_t y, const uint8_t *str, uint16_t color, uint16_t back_color, uint8_t size, uint8_t mode)
+void TFT_Show_String(TFT_HandleTypeDef *htft, uint16_t x, uint16_t y, const char *str, uint16_t color, uint16_t back_color, uint8_t size, uint8_t mode)
 {
     uint16_t current_x = x;
     uint8_t char_width = 0;
@@ -29,7 +29,25 @@
 #include "TFTh/TFT_init.h" // 包含初始化函数
 #include "TFTh/TFT_text.h" // 包含文本显示函数
 #include "TFTh/TFT_io.h"   // 包含IO函数
-#include <math.h>          // 用于sin函数生成波形
+#include "TFTh/TFT_scroll.h" // 包含硬件滚动函数
+#include "SCOPEh/SCOPE_render.h"  // 波形区域条带渲染
+#include "SCOPEh/SCOPE_persist.h" // 余辉显示
+#include "SCOPEh/SCOPE_graticule.h" // 网格图层
+#include "SCOPEh/SCOPE_acq.h"       // ADC 采集引擎
+#include "SCOPEh/SCOPE_capture.h"   // 采集记录
+#include "SCOPEh/SCOPE_decim.h"     // 抽取 (采集方式)
+#include "SCOPEh/SCOPE_average.h"   // 多次采集平均
+#include "SCOPEh/SCOPE_segment.h"   // 分段存储
+#include "SCOPEh/SCOPE_ets.h"       // 等效时间采样
+#include "SCOPEh/SCOPE_roll.h"      // 滚动模式数据流
+#include "SCOPEh/SCOPE_log.h"       // 长记录 (差分编码)
+#include "SCOPEh/SCOPE_measure.h"   // 自动测量
+#include "SCOPEh/SCOPE_counter.h"   // 硬件频率计
+#include "SCOPEh/SCOPE_fft.h"       // 频谱分析
+#include "SCOPEh/SCOPE_harmonic.h"  // 谐波分析
+#include "SCOPEh/SCOPE_math.h"      // 数学通道
+#include "SCOPEh/SCOPE_xy.h"        // XY 显示
+#include "SCOPEh/SCOPE_filter.h"    // 数字耦合与带宽限制
 #include <stdio.h>         // 用于sprintf格式化字符串
 #include <string.h>        // 用于字符串处理函数
 #include <stdbool.h>       // 用于布尔类型定义
@@ -42,7 +60,9 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#if TFT_BUFFER_SIZE + 512 > SCOPE_RAM_HEAP_BYTES
+#error "TFT_BUFFER_SIZE 超出 SCOPE_config.h 中的堆预算 SCOPE_RAM_HEAP_BYTES"
+#endif
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -64,30 +84,57 @@ TFT_HandleTypeDef htft2;       // 第二个TFT屏幕句柄
 #define WAVEFORM_POINTS TFT1_SCREEN_WIDTH // 波形点数等于屏幕宽度
 uint16_t waveform_data1[WAVEFORM_POINTS]; // 存储通道1波形Y坐标
 uint16_t waveform_data2[WAVEFORM_POINTS]; // 存储通道2波形Y坐标
-float time_base = 0.01f;                  // 时间基准 (默认10ms/div)
+uint16_t envelope_data1[WAVEFORM_POINTS]; // 通道1包络最小值的Y坐标 (峰值检测)
+uint16_t envelope_data2[WAVEFORM_POINTS]; // 通道2包络最小值的Y坐标
+uint8_t envelope_shown = 0;               // 当前显示的波形为包络
+uint16_t math_data[WAVEFORM_POINTS];      // 数学通道波形Y坐标
+uint8_t math_enabled = 0;                 // 显示数学通道 (:MATH:DISP)
+uint8_t math_shown = 0;                   // math_data 为当前窗口的结果
+uint8_t xy_mode = 0;                      // XY 显示 (:TIM:MODE XY)，波形数组改存各点的坐标
+uint8_t acq_average = 0;                  // 平均采集 (:ACQ:TYPE AVER)
+uint16_t segment_count = 1;               // 分段数 (:ACQ:SEGM:COUN，1 表示关闭)
+uint16_t segment_index = 0;               // 显示的段 (0 起)
+uint8_t segment_select = 0;               // 请求显示 segment_index 指定的段
+SCOPE_Smem_Format segment_format = SCOPE_SMEM_12BIT; // 分段的存储格式 (:ACQ:SEGM:BITS)
+uint16_t shown_segment = 0xFFFF;          // 屏幕上显示的分段导航 (0xFFFF: 需要重绘)
+uint8_t shown_counter = 0;                // 屏幕上的频率计读数是否为最新
+uint8_t acq_ets = 0;                      // 允许等效时间采样 (:ACQ:MODE ETIM)
+uint8_t ets_active = 0;                   // 当前时基需要等效时间采样
+uint8_t shown_coverage = 0xFF;            // 屏幕上显示的等效时间覆盖率 (0xFF: 需要重绘)
+uint16_t shown_log = 0xFFFF;              // 屏幕上显示的长记录压缩比 x10，bit15 为有原样块 (0xFFFF: 需要重绘)
+float time_base = 10.0f;                  // 时间基准 (默认10ms/div)
 float voltage_scale1 = 1.0f;              // 通道1电压刻度 (V/div)
 float voltage_scale2 = 1.0f;              // 通道2电压刻度 (V/div)
 float trigger_level = 1.5f;               // 触发电平 (V)
+float trigger_position = 0.0f;            // 触发位置 (s)，相对屏幕中心，正值使触发点左移
 char text_buffer[50];                     // 用于显示文本的缓冲区
 uint8_t run_state = 1;                    // 运行状态 1:运行 0:停止
 uint8_t channel1_enabled = 1;             // 通道1使能状态
 uint8_t channel2_enabled = 0;             // 通道2使能状态
 char coupling_mode[4] = "DC";             // 通道1耦合方式 (DC/AC)
+char coupling_mode2[4] = "DC";            // 通道2耦合方式 (DC/AC)
+uint8_t bandwidth_limit[2] = {0, 0};      // 各通道带宽限制 (:CHANn:BWL)
 char trigger_source[6] = "CHAN1";         // 触发源 (CHAN1/CHAN2)
 char trigger_slope[4] = "POS";            // 触发斜率 (POS/NEG)
 char trigger_mode[5] = "EDGE";            // 触发模式
-char trigger_sweep[7] = "AUTO";           // 触发扫描模式 (AUTO/SINGLE)
+char trigger_sweep[7] = "AUTO";           // 触发扫描模式 (AUTO/NORMAL/SINGLE)
+float trigger_hysteresis = 0.05f;         // 触发迟滞 (V)
+uint8_t trigger_noise_reject = 0;         // 噪声抑制：迟滞至少为触发源的 SCOPE_TRIG_NREJ_DIVS 格
 
 // 波形测量数据
-float signal_frequency = 50.0f; // 信号频率 (Hz)
-float signal_amplitude = 3.3f;  // 信号幅值 (V峰峰值)
-float signal_offset = 0.0f;     // 信号偏移 (V)
-uint8_t show_measurement = 1;   // 是否显示测量值
+uint16_t measure_mask = SCOPE_MEAS_BIT(SCOPE_MEAS_VPP) | SCOPE_MEAS_BIT(SCOPE_MEAS_VAVG) | SCOPE_MEAS_BIT(SCOPE_MEAS_FREQ); // 测量项 (:MEAS:ITEM)
+SCOPE_Meas_Result measure_result[2]; // 各通道最近一次采集的测量结果
+uint8_t show_measurement = 1;        // 是否显示测量值
+
+// 采集
+float acq_time_base = 0.0f; // 采集引擎当前采样率对应的时基，与 time_base 不同时重新设置
+uint8_t acq_channels = 0;   // 采集引擎当前的通道使能 (bit0: CH1，bit1: CH2)，决定同步/交替模式
+uint16_t trigger_column = WAVEFORM_POINTS / 2; // 触发点所在的列 (预触发采样数)
 
-// 波形参数
-float sine_frequency = 1.0f;   // 正弦波频率系数
-float square_frequency = 2.0f; // 方波频率系数
-float phase = 0.0f;            // 波形相位
+// 显示刷新：只在取得新窗口或参数改变后重绘，等待触发期间不占用 CPU 和 SPI
+uint8_t plot_dirty = 1;      // TFT1 波形区需要重绘
+uint8_t panel_dirty = 1;     // TFT2 参数区需要重绘
+uint8_t shown_status = 0xFF; // 屏幕上显示的触发状态 (0xFF: 需要重绘)
 
 // UART接收相关
 #define UART_RX_BUFFER_SIZE 128 // 增大缓冲区以容纳多行指令
@@ -97,14 +144,42 @@ volatile uint16_t uart_rx_index = 0;
 volatile uint8_t uart_rx_complete = 0; // 接收完成标志
 
 // 示波器网格设置
-#define GRID_SIZE 30 // 网格大小（像素）
+#define GRID_SIZE 30        // 网格大小（像素）
+SCOPE_Graticule graticule1; // TFT1 波形区域的网格图层
+
+// 滚动模式 (慢时基下使用 ST7789 硬件滚动，抽取得到的每一列只绘制一行)
+#define ROLL_MODE_TIME_BASE 100.0f // 时基 >= 100ms/div 时进入滚动模式
+TFT_Roll roll1;                    // TFT1 滚动条带
+uint8_t roll_active = 0;           // 滚动模式是否激活
+uint32_t roll_count = 0;           // 已推入的行数 (用于时间网格)
+uint16_t roll_last1 = 0;           // 通道1上一行的位置
+uint16_t roll_last2 = 0;           // 通道2上一行的位置
+SCOPE_Graticule roll_graticule;    // 滚动模式的网格图层 (时间轴沿滚动方向)
+
+// 频谱模式 (:FFT:DISP ON，横轴为 0 ~ 采样率的一半，纵轴为 dBV)
+#define FFT_TOP_DBV 20.0f                      // 屏幕顶部对应的电平 (dBV)
+#define FFT_DB_PER_DIV 10.0f                   // 纵轴每格的分贝数
+uint8_t fft_display = 0;                       // 显示频谱 (:FFT:DISP)
+uint8_t fft_active = 0;                        // 抽取输出当前送往频谱分析 (滚动模式下不显示频谱)
+uint8_t fft_restart = 0;                       // 设置已改变，重新开始收集
+uint8_t fft_source = 0;                        // 信源 (0: CH1，1: CH2)
+uint16_t fft_size = 1024;                      // 点数 (:FFT:SIZE)
+SCOPE_Fft_Window fft_window = SCOPE_FFT_HANN;  // 窗函数 (:FFT:WIND)
+SCOPE_Harm_Result harmonic_result;             // 最近一帧频谱的谐波分析结果
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
 void parse_uart_command(char *command);
-void analyze_waveform(uint16_t *wave_data, uint16_t points);
+void measure_update(void);
+void math_update(void);
+void filter_update(void);
+float si_scale(float value, const char **prefix);
+void roll_update(void);
+uint16_t roll_position(uint16_t code, float volts_per_div);
+void roll_push_line(const SCOPE_Roll_Column *column);
+void capture_to_screen(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -166,6 +241,19 @@ int main(void)
   TFT_Init_ST7735S(&htft2);                                                  // ST7735S 屏幕初始化
   TFT_Fill_Area(&htft2, 0, 0, TFT2_SCREEN_WIDTH, TFT2_SCREEN_HEIGHT, BLACK); // 清屏为深灰色
 
+  // 网格图层只需初始化一次，之后由渲染器在合成波形时查询
+  SCOPE_Graticule_Init(&graticule1, TFT1_SCREEN_WIDTH, TFT1_SCREEN_HEIGHT, GRID_SIZE);
+
+  // 启动采集：DMA 数据块经数字滤波和抽取后交给采集记录，采样率在主循环中按时基设置
+  SCOPE_Acq_Init();
+  SCOPE_Acq_Set_Block_Handler(SCOPE_Filter_Block);
+  SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+#if SCOPE_TRIG_USE_AWD
+  SCOPE_Acq_Set_Watchdog_Handler(SCOPE_Capture_Watchdog); // 硬件粗检触发边沿
+#endif
+  SCOPE_Acq_Start();
+  SCOPE_Counter_Init(); // PA8 输入的频率计在后台持续测量
+
   // 启动UART1接收中断，每次接收一个字节
   HAL_UART_Receive_IT(&huart1, &uart_rx_data, 1);
 
@@ -179,104 +267,251 @@ int main(void)
 
     /* USER CODE BEGIN 3 */
 
-    // --- 1. 模拟数据生成 ---
-    if (run_state) // 只有在运行状态下才更新波形
+    // --- 0. 滚动模式切换 ---
+    // 慢时基下整屏重绘会让画面停顿数秒，改为硬件滚动：每个新采样只写入一行
+    if (time_base >= ROLL_MODE_TIME_BASE)
     {
-      phase += 0.1f * sine_frequency; // 调整正弦波相位
-      if (phase > 2 * 3.14159f)
+      if (!roll_active)
       {
-        phase -= 2 * 3.14159f;
+        TFT_Fill_Area(&htft1, 0, 0, TFT1_SCREEN_WIDTH, TFT1_SCREEN_HEIGHT, BLACK);
+        TFT_Roll_Init(&roll1, &htft1, TFT1_SCREEN_HEIGHT, TFT1_SCREEN_WIDTH);
+        SCOPE_Graticule_Init(&roll_graticule, TFT1_SCREEN_HEIGHT, TFT1_SCREEN_WIDTH, GRID_SIZE);
+        roll_last1 = roll_last2 = TFT1_SCREEN_WIDTH / 2;
+        roll_count = 0;
+        SCOPE_Roll_Reset();
+        SCOPE_Decim_Set_Output(SCOPE_Roll_Block, SCOPE_Roll_Envelope_Block); // 抽取的列直接送入滚动队列
+        roll_active = 1;
+        fft_active = 0;
       }
+      if (run_state)
+        roll_update();
+      else
+        SCOPE_Roll_Reset(); // 停止期间丢弃新的列
+    }
+    else if (roll_active)
+    {
+      TFT_Roll_Reset(&roll1); // 恢复滚动起始行，下面的整屏重绘会覆盖错位的内容
+      SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+      SCOPE_Capture_Rearm();
+      SCOPE_Segment_Reset(); // 记录区交还分段存储
+      roll_active = 0;
+      plot_dirty = 1;
+    }
 
-      // 通道1 - 正弦波
-      if (channel1_enabled)
+    // --- 1. 采集数据 ---
+#if SCOPE_ACQ_SIM
+    SCOPE_Acq_Sim_Pump(HAL_GetTick()); // 合成信号代替 ADC，按经过的时间生成数据块
+#endif
+
+    // 时基或通道改变后重新设置采样率和采集模式，丢弃按旧设置装填的记录
+    uint8_t channels = (channel1_enabled ? 1 : 0) | (channel2_enabled ? 2 : 0);
+    if (time_base != acq_time_base || channels != acq_channels)
+    {
+      SCOPE_Acq_Set_Channels(channel1_enabled, channel2_enabled);
+      float wanted_rate = SCOPE_Acq_Rate_For_Time_Base(time_base);
+      SCOPE_Decim_Set_Rate(wanted_rate); // 慢时基下 ADC 以更高采样率运行并抽取
+      SCOPE_Filter_Set_Rate(SCOPE_Acq_Get_Sample_Rate()); // 滤波在抽取之前，按 ADC 采样率计算系数
+      ets_active = acq_ets && wanted_rate > SCOPE_Decim_Get_Rate(); // 快时基下实际采样率不够时用等效时间采样
+      SCOPE_Ets_Set_Ratio(ets_active ? wanted_rate / SCOPE_Decim_Get_Rate() : 1.0f);
+      SCOPE_Ets_Reset();
+      SCOPE_Capture_Rearm();
+      SCOPE_Average_Reset();
+      SCOPE_Segment_Set_Count(segment_count, channels, segment_format); // 每段大小取决于通道
+      if (time_base >= ROLL_MODE_TIME_BASE)
+        SCOPE_Log_Start(channels); // 滚动模式下采样存储区用于长记录
+      acq_time_base = time_base;
+      acq_channels = channels;
+      fft_restart = 1; // 频谱按新的采样率重新收集
+    }
+
+    // 频谱模式：抽取输出改为收集 FFT 帧，不需要触发，采集记录不再装填
+    if (fft_display && !roll_active)
+    {
+      if (!fft_active || fft_restart)
       {
-        for (int i = 0; i < WAVEFORM_POINTS; i++)
-        {
-          // 生成正弦波数据，振幅根据电压刻度设置调整
-          float value = sinf(phase + (float)i * 2 * 3.14159f / (WAVEFORM_POINTS / sine_frequency));
-
-          // 映射到屏幕Y坐标，考虑电压刻度和触发电平
-          float voltage_value = value * voltage_scale1 * 2; // 假设满屏高度为±4个电压刻度
-          float screen_height_per_volt = (TFT1_SCREEN_HEIGHT / 8) / voltage_scale1;
-          waveform_data1[i] = (uint16_t)(TFT1_SCREEN_HEIGHT / 2 - voltage_value * screen_height_per_volt);
-
-          // 确保坐标在屏幕范围内
-          if (waveform_data1[i] >= TFT1_SCREEN_HEIGHT)
-            waveform_data1[i] = TFT1_SCREEN_HEIGHT - 1;
-          if (waveform_data1[i] < 0)
-            waveform_data1[i] = 0;
-        }
+        SCOPE_Fft_Start(fft_source, fft_size, fft_window);
+        fft_restart = 0;
+        SCOPE_Decim_Set_Output(SCOPE_Fft_Block, SCOPE_Fft_Envelope_Block);
+        fft_active = 1;
+        plot_dirty = 1;
       }
-
-      // 通道2 - 方波
-      if (channel2_enabled)
+      if (run_state && SCOPE_Fft_Ready())
       {
-        // 计算一个完整方波周期的点数
-        int points_per_cycle = (int)(WAVEFORM_POINTS / square_frequency);
-        if (points_per_cycle < 10)
-          points_per_cycle = 10;
+        SCOPE_Fft_Compute();
+        SCOPE_Harmonic_Analyze(SCOPE_Decim_Get_Rate(), &harmonic_result);
+        if (fft_source)
+          SCOPE_Fft_To_Screen(waveform_data2, envelope_data2, WAVEFORM_POINTS, FFT_TOP_DBV, FFT_DB_PER_DIV);
+        else
+          SCOPE_Fft_To_Screen(waveform_data1, envelope_data1, WAVEFORM_POINTS, FFT_TOP_DBV, FFT_DB_PER_DIV);
+        envelope_shown = 1; // 一列包含多个频点，画出最大值到最小值
+        SCOPE_Fft_Rearm();
+        plot_dirty = panel_dirty = 1;
+      }
+    }
+    else if (fft_active)
+    {
+      SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+      SCOPE_Capture_Rearm();
+      SCOPE_Segment_Reset(); // 记录区交还分段存储
+      fft_active = 0;
+      harmonic_result.valid = 0;
+      plot_dirty = panel_dirty = 1;
+    }
 
-        for (int i = 0; i < WAVEFORM_POINTS; i++)
-        {
-          // 方波：高电平或低电平
-          bool is_high = ((i % points_per_cycle) < (points_per_cycle / 2));
+    // 触发条件和水平位置同步到采集记录，下一次触发时生效
+    float column_rate = SCOPE_Decim_Get_Rate() * (ets_active ? SCOPE_Ets_Get_Ratio() : 1.0f); // 每列对应的采样率
+    int32_t pre_samples = WAVEFORM_POINTS / 2 - (int32_t)(trigger_position * column_rate);
+    trigger_column = (pre_samples < 0) ? 0 : (pre_samples > WAVEFORM_POINTS - 1) ? WAVEFORM_POINTS - 1 : (uint16_t)pre_samples;
+    if (ets_active)
+    {
+      SCOPE_Ets_Set_Trigger_Column(trigger_column);
+      SCOPE_Capture_Set_Pretrigger(SCOPE_Ets_Get_Pretrigger()); // 一列不到一个采样，只需覆盖触发点左侧的时间
+    }
+    else
+    {
+      SCOPE_Capture_Set_Pretrigger(trigger_column);
+    }
+    float hysteresis = trigger_hysteresis;
+    if (trigger_noise_reject)
+    {
+      float nrej = SCOPE_TRIG_NREJ_DIVS * (strcmp(trigger_source, "CHAN2") == 0 ? voltage_scale2 : voltage_scale1);
+      if (hysteresis < nrej)
+        hysteresis = nrej;
+    }
+    SCOPE_Capture_Set_Hysteresis((uint16_t)(hysteresis * SCOPE_CODES_PER_VOLT + 0.5f));
+    SCOPE_Capture_Set_Trigger(strcmp(trigger_source, "CHAN2") == 0 ? 1 : 0,
+                              SCOPE_Volts_To_Code(trigger_level),
+                              strcmp(trigger_slope, "NEG") == 0 ? SCOPE_SLOPE_FALLING : SCOPE_SLOPE_RISING);
 
-          // 计算方波在Y轴上的位置
-          float voltage_high = 2.0f * voltage_scale2; // 高电平为2个刻度
-          float voltage_low = -2.0f * voltage_scale2; // 低电平为-2个刻度
-          float screen_height_per_volt = (TFT1_SCREEN_HEIGHT / 8) / voltage_scale2;
+    // 扫描方式：自动扫描的超时和单次触发的停止都由采集记录在数据块回调中处理
+    SCOPE_Capture_Set_Sweep(strcmp(trigger_sweep, "NORMAL") == 0   ? SCOPE_SWEEP_NORMAL
+                            : strcmp(trigger_sweep, "SINGLE") == 0 ? SCOPE_SWEEP_SINGLE
+                                                                   : SCOPE_SWEEP_AUTO);
 
-          if (is_high)
-            waveform_data2[i] = (uint16_t)(TFT1_SCREEN_HEIGHT / 2 - voltage_high * screen_height_per_volt);
-          else
-            waveform_data2[i] = (uint16_t)(TFT1_SCREEN_HEIGHT / 2 - voltage_low * screen_height_per_volt);
+    // 余辉按时间衰减：没有新的触发 (或已停止) 时也要逐渐变暗，每一轮都检查
+    if (SCOPE_Persist_Get_Mode() != SCOPE_PERSIST_OFF && SCOPE_Persist_Decay(HAL_GetTick()))
+      plot_dirty = 1;
 
-          // 确保坐标在屏幕范围内
-          if (waveform_data2[i] >= TFT1_SCREEN_HEIGHT)
-            waveform_data2[i] = TFT1_SCREEN_HEIGHT - 1;
-          if (waveform_data2[i] < 0)
-            waveform_data2[i] = 0;
-        }
+    if (run_state && !roll_active && !fft_active && SCOPE_Capture_Ready()) // 只有在运行状态下且窗口已冻结时才更新波形
+    {
+      // 平均采集：只累积满足触发条件的窗口；还没有平均结果时直接显示未触发的窗口
+      uint8_t update = 1;
+      if (ets_active)
+      {
+        update = SCOPE_Ets_Add(); // 强制触发的窗口没有相位信息，不更新
+      }
+      else if (acq_average)
+      {
+        if (SCOPE_Capture_Get_Status() == SCOPE_STATUS_TRIGD)
+          update = SCOPE_Average_Add(); // 线性平均只在一批完成时更新显示
+        else
+          update = (SCOPE_Average_Get_Done() == 0);
       }
 
-      // 分析波形数据并更新测量值
-      if (channel1_enabled)
-        analyze_waveform(waveform_data1, WAVEFORM_POINTS);
-    }
+      // 分段存储：全部段采集完才冻结，先显示最后一段
+      uint8_t segmented = SCOPE_Segment_Get_Count() > 1;
+      if (segmented)
+      {
+        segment_index = SCOPE_Segment_Get_Done() - 1;
+        SCOPE_Segment_Select(segment_index);
+      }
 
-    // --- 2. 绘制TFT1 (示波器波形) ---
-    // a. 清除旧波形区域
-    TFT_Fill_Area(&htft1, 0, 0, TFT1_SCREEN_WIDTH, TFT1_SCREEN_HEIGHT, BLACK);
+      // 在原始采样上测量和计算数学通道，必须在重新装填之前
+      measure_update();
+      math_update();
 
-    // b. 绘制网格
-    // 绘制水平线
-    for (int y = 0; y < TFT1_SCREEN_HEIGHT; y += GRID_SIZE) // 每GRID_SIZE像素画一条线
-    {
-      TFT_Draw_Fast_HLine(&htft1, 0, y, TFT1_SCREEN_WIDTH, GRAY); // 用灰色绘制水平线
+      if (update && ets_active && !xy_mode)
+      {
+        envelope_shown = 0;
+        if (channel1_enabled)
+          SCOPE_Ets_To_Screen(0, waveform_data1, WAVEFORM_POINTS, voltage_scale1);
+        if (channel2_enabled)
+          SCOPE_Ets_To_Screen(1, waveform_data2, WAVEFORM_POINTS, voltage_scale2);
+      }
+      else if (update && acq_average && !xy_mode && SCOPE_Average_Get_Done() > 0)
+      {
+        envelope_shown = 0;
+        if (channel1_enabled)
+          SCOPE_Average_To_Screen(0, waveform_data1, WAVEFORM_POINTS, voltage_scale1);
+        if (channel2_enabled)
+          SCOPE_Average_To_Screen(1, waveform_data2, WAVEFORM_POINTS, voltage_scale2);
+      }
+      else if (update)
+      {
+        capture_to_screen();
+      }
+      if (segmented || SCOPE_Capture_Get_Sweep() == SCOPE_SWEEP_SINGLE)
+        run_state = 0; // 单次触发/分段序列完成：保留这一帧并停止，不再重新装填
+      else
+        SCOPE_Capture_Rearm(); // 窗口已转换为屏幕坐标，立即开始下一次装填
+      if (update)
+        plot_dirty = panel_dirty = 1;
+
+      // 余辉：累积本次采集 (衰减在上面每一轮进行)
+      if (update && SCOPE_Persist_Get_Mode() != SCOPE_PERSIST_OFF)
+      {
+        if (xy_mode)
+          SCOPE_Persist_Accumulate_Points(waveform_data1, waveform_data2, WAVEFORM_POINTS);
+        if (channel1_enabled && !xy_mode)
+          SCOPE_Persist_Accumulate(waveform_data1, WAVEFORM_POINTS);
+        if (channel2_enabled && !xy_mode)
+          SCOPE_Persist_Accumulate(waveform_data2, WAVEFORM_POINTS);
+      }
     }
-    // 绘制垂直线
-    for (int x = 0; x < TFT1_SCREEN_WIDTH; x += GRID_SIZE) // 每GRID_SIZE像素画一条线
+
+    // 浏览分段：把选中的段装入冻结窗口后重新转换
+    if (segment_select)
     {
-      TFT_Draw_Fast_VLine(&htft1, x, 0, TFT1_SCREEN_HEIGHT, GRAY); // 用灰色绘制垂直线
+      segment_select = 0;
+      if (SCOPE_Segment_Select(segment_index))
+      {
+        capture_to_screen();
+        measure_update();
+        math_update();
+        plot_dirty = panel_dirty = 1;
+      }
     }
-    // 绘制中心线
-    TFT_Draw_Fast_HLine(&htft1, 0, TFT1_SCREEN_HEIGHT / 2, TFT1_SCREEN_WIDTH, GBLUE);
-    TFT_Draw_Fast_VLine(&htft1, TFT1_SCREEN_WIDTH / 2, 0, TFT1_SCREEN_HEIGHT, GBLUE);
 
-    // 在示波器屏幕上绘制触发电平线
-    if (channel1_enabled || channel2_enabled)
+    // --- 2. 绘制TFT1 (示波器波形) ---
+    if (!roll_active && plot_dirty) // 滚动模式下TFT1由 roll_update() 逐行绘制
     {
+      plot_dirty = 0;
+
       // 将触发电平映射到屏幕Y坐标
       uint16_t trigger_y = (uint16_t)(TFT1_SCREEN_HEIGHT / 2 - (trigger_level / voltage_scale1) * (TFT1_SCREEN_HEIGHT / 8));
-      if (trigger_y >= 0 && trigger_y < TFT1_SCREEN_HEIGHT)
+      bool trigger_visible = !fft_active && !xy_mode && (channel1_enabled || channel2_enabled) && trigger_y < TFT1_SCREEN_HEIGHT;
+      SCOPE_Graticule_Set_Trigger(&graticule1, trigger_visible, trigger_y);
+
+      // a. 条带渲染网格图层、余辉和波形 (一次地址窗口，无需先清屏)
+      SCOPE_Plot plot = {
+          .wave1 = waveform_data1,
+          .wave2 = waveform_data2,
+          .env1 = envelope_shown ? envelope_data1 : NULL,
+          .env2 = envelope_shown ? envelope_data2 : NULL,
+          .math = (math_shown && !fft_active && !xy_mode) ? math_data : NULL,
+          .points = WAVEFORM_POINTS,
+          .ch1_enabled = fft_active ? fft_source == 0 : channel1_enabled, // 频谱模式只显示信源
+          .ch2_enabled = fft_active ? fft_source == 1 : channel2_enabled,
+          .graticule = &graticule1,
+          .persist_enabled = !fft_active && SCOPE_Persist_Get_Mode() != SCOPE_PERSIST_OFF,
+          .xy = xy_mode && !fft_active,
+      };
+      SCOPE_Render_Plot(&htft1, &plot);
+
+      // b. 叠加元素：触发指示标志和通道标签
+      // 在屏幕顶部绘制触发位置标志 (靠近边缘时整体内移，避免坐标越界)
+      uint16_t marker_x = (trigger_column < 4) ? 4 : (trigger_column > TFT1_SCREEN_WIDTH - 5) ? TFT1_SCREEN_WIDTH - 5 : trigger_column;
+      if (!fft_active && !xy_mode)
       {
-        // 用虚线绘制触发电平
-        for (int x = 0; x < TFT1_SCREEN_WIDTH; x += 6)
-        {
-          TFT_Draw_Fast_HLine(&htft1, x, trigger_y, 3, MAGENTA);
-        }
+        TFT_Draw_Triangle(&htft1,
+                          marker_x - 4, 0,
+                          marker_x + 4, 0,
+                          marker_x, 6,
+                          MAGENTA);
+      }
 
+      if (trigger_visible)
+      {
         // 在屏幕右侧绘制触发指示标志
         TFT_Draw_Triangle(&htft1,
                           TFT1_SCREEN_WIDTH - 10, trigger_y,
@@ -284,108 +519,232 @@ int main(void)
                           TFT1_SCREEN_WIDTH - 2, trigger_y + 4,
                           MAGENTA);
       }
-    }
 
-    // c. 绘制波形
-    if (channel1_enabled)
-    {
-      // 绘制通道1信息
-      sprintf(text_buffer, "CH1");
-      TFT_Show_String(&htft1, 5, 45, text_buffer, YELLOW, BLACK, 16, 0);
+      if (channel1_enabled)
+      {
+        // 绘制通道1信息
+        sprintf(text_buffer, "CH1");
+        TFT_Show_String(&htft1, 5, 45, text_buffer, YELLOW, BLACK, 16, 0);
+      }
 
-      // 绘制通道1波形
-      for (int i = 0; i < WAVEFORM_POINTS - 1; i++)
+      if (channel2_enabled)
       {
-        TFT_Draw_Line(&htft1, i, waveform_data1[i], i + 1, waveform_data1[i + 1], YELLOW); // 用黄色绘制波形
+        // 绘制通道2信息
+        sprintf(text_buffer, "CH2");
+        TFT_Show_String(&htft1, 35, 45, text_buffer, CYAN, BLACK, 16, 0);
       }
-    }
 
-    if (channel2_enabled)
-    {
-      // 绘制通道2信息
-      sprintf(text_buffer, "CH2");
-      TFT_Show_String(&htft1, 35, 45, text_buffer, CYAN, BLACK, 16, 0);
+      if (math_shown && !fft_active && !xy_mode)
+      {
+        // 绘制数学通道的刻度 (单位随运算变化)
+        const char *prefix;
+        float scale = si_scale(SCOPE_Math_Get_Scale(), &prefix);
+        sprintf(text_buffer, "M %g%s%s/div", scale, prefix, SCOPE_Math_Get_Unit());
+        TFT_Show_String(&htft1, 65, 45, text_buffer, GREEN, BLACK, 16, 0);
+      }
 
-      // 绘制通道2波形
-      for (int i = 0; i < WAVEFORM_POINTS - 1; i++)
+      if (xy_mode && !fft_active)
       {
-        TFT_Draw_Line(&htft1, i, waveform_data2[i], i + 1, waveform_data2[i + 1], CYAN); // 用青色绘制波形
+        // 左下角的坐标轴说明 (两轴都按各自通道的电压刻度)
+        TFT_Show_String(&htft1, 5, TFT1_SCREEN_HEIGHT - 20, "XY  X:CH1  Y:CH2", WHITE, BLACK, 16, 0);
       }
+
+      if (fft_active)
+      {
+        // 左下角的频谱刻度：每格频率和每格分贝数
+        float hz_per_div = SCOPE_Decim_Get_Rate() / 2.0f / (TFT1_SCREEN_WIDTH / GRID_SIZE);
+        if (hz_per_div >= 1e6f)
+          sprintf(text_buffer, "FFT %.2fMHz/div %.0fdB", hz_per_div / 1e6f, FFT_DB_PER_DIV);
+        else if (hz_per_div >= 1e3f)
+          sprintf(text_buffer, "FFT %.2fkHz/div %.0fdB", hz_per_div / 1e3f, FFT_DB_PER_DIV);
+        else
+          sprintf(text_buffer, "FFT %.2fHz/div %.0fdB", hz_per_div, FFT_DB_PER_DIV);
+        TFT_Show_String(&htft1, 5, TFT1_SCREEN_HEIGHT - 20, text_buffer, fft_source ? CYAN : YELLOW, BLACK, 16, 0);
+      }
+
+      shown_status = 0xFF; // 状态文字已被波形覆盖，下面重新绘制
+      shown_segment = 0xFFFF;
+      shown_coverage = 0xFF;
+      shown_counter = 0;
     }
 
-    // 在停止状态下显示提示
-    if (!run_state)
+    // 右上角的触发状态，状态改变时只重绘这几个字符
+    SCOPE_Capture_Status status = SCOPE_Capture_Get_Status();
+    if (!roll_active && !fft_active && status != shown_status)
     {
-      sprintf(text_buffer, "STOP");
-      TFT_Show_String(&htft1, TFT1_SCREEN_WIDTH - 40, 5, text_buffer, RED, BLACK, 16, 0);
+      shown_status = status;
+      if (!run_state)
+      {
+        // 在停止状态下显示提示
+        TFT_Show_String(&htft1, TFT1_SCREEN_WIDTH - 53, 5, "  STOP", RED, BLACK, 16, 0);
+      }
+      else
+      {
+        static const char *const status_text[] = {"  WAIT", " ARMED", "TRIG'D", "  AUTO"};
+        TFT_Show_String(&htft1, TFT1_SCREEN_WIDTH - 53, 5, status_text[status],
+                        status == SCOPE_STATUS_TRIGD ? GREEN : ORANGE, BLACK, 16, 0);
+      }
     }
 
-    // --- 3. 绘制TFT2 (参数显示) ---
-    // a. 清屏
-    TFT_Fill_Area(&htft2, 0, 0, TFT2_SCREEN_WIDTH, TFT2_SCREEN_HEIGHT, BLACK);
+    // 左下角的分段导航：采集中显示进度，完成后显示当前段及其相对第 1 段的触发时刻
+    if (!roll_active && !fft_active && SCOPE_Segment_Get_Count() > 1)
+    {
+      uint16_t done = SCOPE_Segment_Get_Done();
+      uint16_t key = run_state ? done : (0x8000 | segment_index);
+      if (key != shown_segment)
+      {
+        shown_segment = key;
+        int n;
+        if (run_state)
+          n = sprintf(text_buffer, "SEG %u/%u", done, SCOPE_Segment_Get_Count());
+        else
+          n = sprintf(text_buffer, "SEG %u/%u +%.3fms", segment_index + 1, done,
+                      SCOPE_Segment_Get_Time(segment_index) / 1000.0f);
+        while (n < 22)
+          text_buffer[n++] = ' '; // 覆盖上一次较长的文字
+        text_buffer[n] = '\0';
+        TFT_Show_String(&htft1, 5, TFT1_SCREEN_HEIGHT - 20, text_buffer, WHITE, BLACK, 16, 0);
+      }
+    }
 
-    // b. 显示参数
-    // 显示标题和运行状态
-    TFT_Show_String(&htft2, 5, 5, "Oscilloscope", WHITE, BLACK, 16, 0);
-    if (run_state)
+    // 左上角的等效时间采样覆盖率：已填充的列所占的比例
+    if (!roll_active && !fft_active && ets_active && SCOPE_Ets_Get_Coverage() != shown_coverage)
     {
-      TFT_Show_String(&htft2, 90, 5, "RUN", GREEN, BLACK, 16, 0);
+      shown_coverage = SCOPE_Ets_Get_Coverage();
+      sprintf(text_buffer, "ETS %3u%%", shown_coverage);
+      TFT_Show_String(&htft1, 5, 5, text_buffer, shown_coverage < 100 ? ORANGE : GREEN, BLACK, 16, 0);
     }
-    else
+
+    // 顶部中间的频率计读数 (倒数计数，7 位有效数字，与时基无关)
+    if (SCOPE_Counter_Update(HAL_GetTick()))
+      shown_counter = 0;
+    if (!roll_active && !shown_counter)
     {
-      TFT_Show_String(&htft2, 90, 5, "STOP", RED, BLACK, 16, 0);
+      shown_counter = 1;
+      double hz = SCOPE_Counter_Get_Frequency();
+      double value = (hz >= 1e6) ? hz / 1e6 : (hz >= 1e3) ? hz / 1e3 : hz;
+      const char *unit = (hz >= 1e6) ? "MHz" : (hz >= 1e3) ? "kHz" : "Hz ";
+      if (hz <= 0)
+        strcpy(text_buffer, "  ---   Hz ");
+      else
+        sprintf(text_buffer, (value >= 100) ? "%8.4f%s" : (value >= 10) ? "%8.5f%s" : "%8.6f%s", value, unit);
+      TFT_Show_String(&htft1, 72, 5, text_buffer, WHITE, BLACK, 16, 0);
     }
 
-    // 分隔线
-    TFT_Draw_Fast_HLine(&htft2, 0, 25, TFT2_SCREEN_WIDTH, BROWN);
+    // --- 3. 绘制TFT2 (参数显示) ---
+    if (panel_dirty)
+    {
+      panel_dirty = 0;
+
+      // a. 清屏
+      TFT_Fill_Area(&htft2, 0, 0, TFT2_SCREEN_WIDTH, TFT2_SCREEN_HEIGHT, BLACK);
+
+      // b. 显示参数
+      // 显示标题和运行状态
+      if (roll_active)
+        shown_log = 0xFFFF; // 滚动模式下标题位置显示长记录统计，见下方
+      else
+        TFT_Show_String(&htft2, 5, 5, "Oscilloscope", WHITE, BLACK, 16, 0);
+      if (run_state)
+      {
+        TFT_Show_String(&htft2, 90, 5, "RUN", GREEN, BLACK, 16, 0);
+      }
+      else
+      {
+        TFT_Show_String(&htft2, 90, 5, "STOP", RED, BLACK, 16, 0);
+      }
+
+      // 分隔线
+      TFT_Draw_Fast_HLine(&htft2, 0, 25, TFT2_SCREEN_WIDTH, BROWN);
 
-    // 通道状态
-    sprintf(text_buffer, "CH1:%s", channel1_enabled ? "ON" : "OFF");
-    TFT_Show_String(&htft2, 5, 30, text_buffer, YELLOW, BLACK, 16, 0);
+      // 通道状态
+      sprintf(text_buffer, "CH1:%s", channel1_enabled ? "ON" : "OFF");
+      TFT_Show_String(&htft2, 5, 30, text_buffer, YELLOW, BLACK, 16, 0);
 
-    sprintf(text_buffer, "CH2:%s", channel2_enabled ? "ON" : "OFF");
-    TFT_Show_String(&htft2, 70, 30, text_buffer, CYAN, BLACK, 16, 0);
+      sprintf(text_buffer, "CH2:%s", channel2_enabled ? "ON" : "OFF");
+      TFT_Show_String(&htft2, 70, 30, text_buffer, CYAN, BLACK, 16, 0);
 
-    // 显示时间基准 (更新为秒/格)
-    if (time_base >= 1000.0f)
-      sprintf(text_buffer, "Time: %.1fs/div", time_base / 1000.0f);
-    else
-      sprintf(text_buffer, "Time: %.1fms/div", time_base);
-    TFT_Show_String(&htft2, 5, 50, text_buffer, BRRED, BLACK, 16, 0);
+      // 显示时间基准 (更新为秒/格)
+      if (time_base >= 1000.0f)
+        sprintf(text_buffer, "Time: %.1fs/div", time_base / 1000.0f);
+      else if (time_base >= 1.0f)
+        sprintf(text_buffer, "Time: %.1fms/div", time_base);
+      else
+        sprintf(text_buffer, "Time: %.2fus/div", time_base * 1000.0f);
+      TFT_Show_String(&htft2, 5, 50, text_buffer, BRRED, BLACK, 16, 0);
 
-    // 显示电压刻度 - 分别显示两个通道的电压刻度
-    sprintf(text_buffer, "V1: %.1fV/div", voltage_scale1);
-    TFT_Show_String(&htft2, 5, 70, text_buffer, YELLOW, BLACK, 16, 0);
+      // 显示电压刻度 - 分别显示两个通道的电压刻度
+      sprintf(text_buffer, "V1: %.1fV/div", voltage_scale1);
+      TFT_Show_String(&htft2, 5, 70, text_buffer, YELLOW, BLACK, 16, 0);
 
-    if (channel2_enabled)
-    {
-      sprintf(text_buffer, "V2: %.1fV/div", voltage_scale2);
-      TFT_Show_String(&htft2, 5, 90, text_buffer, CYAN, BLACK, 16, 0);
-    }
+      if (channel2_enabled)
+      {
+        sprintf(text_buffer, "V2: %.1fV/div", voltage_scale2);
+        TFT_Show_String(&htft2, 5, 90, text_buffer, CYAN, BLACK, 16, 0);
+      }
 
-    // 显示触发信息
-    uint16_t trig_y = 90;
-    if (channel2_enabled)
-      trig_y = 110;
+      // 显示触发信息
+      uint16_t trig_y = 90;
+      if (channel2_enabled)
+        trig_y = 110;
+
+      // 频谱模式不需要触发，这一区域改为显示谐波分析结果 (小字体)
+      if (fft_active)
+      {
+        if (harmonic_result.valid)
+        {
+          float f0 = harmonic_result.value[SCOPE_HARM_FUND];
+          if (f0 >= 1e3f)
+            sprintf(text_buffer, "F0 %.2fkHz %.0fdBV", f0 / 1e3f, harmonic_result.value[SCOPE_HARM_LEVEL]);
+          else
+            sprintf(text_buffer, "F0 %.2fHz %.0fdBV", f0, harmonic_result.value[SCOPE_HARM_LEVEL]);
+          TFT_Show_String(&htft2, 5, trig_y, text_buffer, GREEN, BLACK, 12, 0);
+          sprintf(text_buffer, "THD %.1f ENOB %.2f", harmonic_result.value[SCOPE_HARM_THD], harmonic_result.value[SCOPE_HARM_ENOB]);
+          TFT_Show_String(&htft2, 5, trig_y + 14, text_buffer, GREEN, BLACK, 12, 0);
+          sprintf(text_buffer, "SNR %.1f SINAD %.1f", harmonic_result.value[SCOPE_HARM_SNR], harmonic_result.value[SCOPE_HARM_SINAD]);
+          TFT_Show_String(&htft2, 5, trig_y + 28, text_buffer, GREEN, BLACK, 12, 0);
+        }
+        else
+        {
+          TFT_Show_String(&htft2, 5, trig_y, "No fundamental", ORANGE, BLACK, 12, 0);
+        }
+      }
+      else
+      {
+        sprintf(text_buffer, "Trig: %s", trigger_source);
+        TFT_Show_String(&htft2, 5, trig_y, text_buffer, MAGENTA, BLACK, 16, 0);
 
-    sprintf(text_buffer, "Trig: %s", trigger_source);
-    TFT_Show_String(&htft2, 5, trig_y, text_buffer, MAGENTA, BLACK, 16, 0);
+        // 显示触发斜率
+        trig_y += 20;
+        sprintf(text_buffer, "Slope: %s", strcmp(trigger_slope, "POS") == 0 ? "Rise" : "Fall");
+        TFT_Show_String(&htft2, 5, trig_y, text_buffer, MAGENTA, BLACK, 16, 0);
 
-    // 显示触发斜率
-    trig_y += 20;
-    sprintf(text_buffer, "Slope: %s", strcmp(trigger_slope, "POS") == 0 ? "Rise" : "Fall");
-    TFT_Show_String(&htft2, 5, trig_y, text_buffer, MAGENTA, BLACK, 16, 0);
+        // 耦合方式
+        trig_y += 20;
+        sprintf(text_buffer, "Coupl: %s%s", coupling_mode, bandwidth_limit[0] ? " BW" : "");
+        TFT_Show_String(&htft2, 5, trig_y, text_buffer, LIGHTBLUE, BLACK, 16, 0);
 
-    // 耦合方式
-    trig_y += 20;
-    sprintf(text_buffer, "Coupl: %s", coupling_mode);
-    TFT_Show_String(&htft2, 5, trig_y, text_buffer, LIGHTBLUE, BLACK, 16, 0);
+        // 如果有足够空间，显示测量信息
+        if (channel1_enabled && (measure_result[0].valid & SCOPE_MEAS_BIT(SCOPE_MEAS_FREQ)) && trig_y + 20 < TFT2_SCREEN_HEIGHT - 20)
+        {
+          sprintf(text_buffer, "Freq: %.1f Hz", measure_result[0].value[SCOPE_MEAS_FREQ]);
+          TFT_Show_String(&htft2, 5, trig_y + 20, text_buffer, GREEN, BLACK, 16, 0);
+        }
+      }
+    }
 
-    // 如果有足够空间，显示测量信息
-    if (channel1_enabled && trig_y + 20 < TFT2_SCREEN_HEIGHT - 20)
+    // 滚动模式的长记录压缩比，有原样保存的块 (信号噪声大) 时显示为橙色
+    if (roll_active)
     {
-      sprintf(text_buffer, "Freq: %.1f Hz", signal_frequency);
-      TFT_Show_String(&htft2, 5, trig_y + 20, text_buffer, GREEN, BLACK, 16, 0);
+      SCOPE_Log_Stats log_stats;
+      SCOPE_Log_Get_Stats(&log_stats);
+      uint16_t shown = (uint16_t)(log_stats.ratio * 10.0f + 0.5f) | (log_stats.raw_blocks ? 0x8000 : 0);
+      if (shown != shown_log)
+      {
+        shown_log = shown;
+        sprintf(text_buffer, "Log %4.1fx", log_stats.ratio);
+        TFT_Show_String(&htft2, 5, 5, text_buffer, log_stats.raw_blocks ? ORANGE : GREEN, BLACK, 16, 0);
+      }
     }
 
     // --- 4. 串口指令处理 (占位符) ---
@@ -393,10 +752,13 @@ int main(void)
     {
       parse_uart_command((char *)uart_rx_buffer);
       uart_rx_complete = 0;
+      plot_dirty = panel_dirty = 1; // 指令可能修改了任何显示参数
+      shown_status = 0xFF;
     }
 
     // --- 5. 延时 ---
-    HAL_Delay(20); // 控制刷新率，避免闪烁太快
+    if (!roll_active)
+      HAL_Delay(20); // 控制刷新率，避免闪烁太快；滚动模式每一轮都要取空列队列，不延时
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -446,74 +808,183 @@ void SystemClock_Config(void)
 /* USER CODE BEGIN 4 */
 
 /**
- * @brief  分析波形数据并更新测量值
- * @param  wave_data 波形数据数组
- * @param  points 波形点数
+ * @brief  把采集记录的冻结窗口转换为屏幕坐标
  * @retval None
+ * @note   峰值检测的窗口为包络，每列画出最小值到最大值；XY 显示时转换为按纵坐标排序的点
  */
-void analyze_waveform(uint16_t *wave_data, uint16_t points)
+void capture_to_screen(void)
 {
-  if (points < 10 || !channel1_enabled || !run_state)
+  if (xy_mode)
+  {
+    // XY：CH1 为横坐标、CH2 为纵坐标的点，两个波形数组存放按纵坐标排序的坐标
+    envelope_shown = 0;
+    SCOPE_Xy_To_Screen(waveform_data1, waveform_data2, WAVEFORM_POINTS, voltage_scale1, voltage_scale2);
     return;
+  }
 
-  // 查找最大值和最小值
-  uint16_t max_value = 0;
-  uint16_t min_value = TFT1_SCREEN_HEIGHT;
-
-  for (uint16_t i = 0; i < points; i++)
+  envelope_shown = SCOPE_Capture_Is_Envelope();
+  if (envelope_shown)
+  {
+    if (channel1_enabled)
+      SCOPE_Capture_Envelope_To_Screen(0, waveform_data1, envelope_data1, WAVEFORM_POINTS, voltage_scale1);
+    if (channel2_enabled)
+      SCOPE_Capture_Envelope_To_Screen(1, waveform_data2, envelope_data2, WAVEFORM_POINTS, voltage_scale2);
+  }
+  else
   {
-    if (wave_data[i] > max_value)
-      max_value = wave_data[i];
-    if (wave_data[i] < min_value)
-      min_value = wave_data[i];
+    if (channel1_enabled)
+      SCOPE_Capture_To_Screen(0, waveform_data1, WAVEFORM_POINTS, voltage_scale1);
+    if (channel2_enabled)
+      SCOPE_Capture_To_Screen(1, waveform_data2, WAVEFORM_POINTS, voltage_scale2);
   }
+}
 
-  // 计算幅值 (转换为电压值)
-  uint16_t peak_to_peak = (min_value > max_value) ? 0 : (max_value - min_value);
-  float pixels_per_volt = (TFT1_SCREEN_HEIGHT / 8) / voltage_scale1; // 每伏特对应的像素数
-  signal_amplitude = (float)peak_to_peak / pixels_per_volt;
+/**
+ * @brief  测量冻结窗口中打开的通道
+ * @retval None
+ * @note   在原始码值上测量，与电压刻度无关；关闭的通道结果清空
+ */
+void measure_update(void)
+{
+  float rate = SCOPE_Decim_Get_Rate(); // 窗口内相邻采样的间隔 (等效时间采样时也是实际采样率)
+  if (channel1_enabled)
+    SCOPE_Measure_Capture(0, measure_mask, rate, &measure_result[0]);
+  else
+    measure_result[0].valid = 0;
+  if (channel2_enabled)
+    SCOPE_Measure_Capture(1, measure_mask, rate, &measure_result[1]);
+  else
+    measure_result[1].valid = 0;
+}
 
-  // 计算直流偏移
-  uint16_t mid_point = (max_value + min_value) / 2;
-  signal_offset = ((float)TFT1_SCREEN_HEIGHT / 2 - mid_point) / pixels_per_volt;
+/**
+ * @brief  计算冻结窗口的数学通道
+ * @retval None
+ * @note   窗口不含需要的通道时不显示
+ */
+void math_update(void)
+{
+  math_shown = math_enabled && SCOPE_Math_To_Screen(math_data, WAVEFORM_POINTS, SCOPE_Decim_Get_Rate());
+}
 
-  // 计算频率 (零点交叉法)
-  // 假设一个完整周期内有两个零点交叉
-  // 为简化计算，我们搜索上升沿
-  uint16_t crossings = 0;
-  uint16_t first_crossing = 0;
-  uint16_t last_crossing = 0;
-  uint16_t mid_level = TFT1_SCREEN_HEIGHT / 2;
+/**
+ * @brief  把耦合方式和带宽限制交给数字滤波
+ * @retval None
+ * @note   记录中已有的采样按旧设置滤波，重新装填
+ */
+void filter_update(void)
+{
+  SCOPE_Filter_Set_Coupling(0, strcmp(coupling_mode, "AC") == 0);
+  SCOPE_Filter_Set_Coupling(1, strcmp(coupling_mode2, "AC") == 0);
+  SCOPE_Filter_Set_Bwl(0, bandwidth_limit[0]);
+  SCOPE_Filter_Set_Bwl(1, bandwidth_limit[1]);
+#if SCOPE_TRIG_USE_AWD
+  SCOPE_Capture_Use_Watchdog(!SCOPE_Filter_Is_Active()); // 看门狗只能看到滤波前的码值
+#endif
+  SCOPE_Capture_Rearm();
+  SCOPE_Average_Reset();
+  panel_dirty = 1;
+}
 
-  for (uint16_t i = 1; i < points; i++)
+/**
+ * @brief  选择显示用的单位词头
+ * @param  value  数值
+ * @param  prefix 输出：词头 ("n"、"u"、"m"、""、"k"、"M")
+ * @retval 除以词头后的数值
+ */
+float si_scale(float value, const char **prefix)
+{
+  static const char *const prefixes[] = {"n", "u", "m", "", "k", "M"};
+  float magnitude = (value < 0) ? -value : value;
+  uint8_t i = 3;
+  while (i > 0 && magnitude > 0 && magnitude < 1.0f)
   {
-    // 检测上升沿穿越中点
-    if (wave_data[i - 1] > mid_level && wave_data[i] <= mid_level)
-    {
-      if (crossings == 0)
-        first_crossing = i;
-      else
-        last_crossing = i;
-
-      crossings++;
-    }
+    magnitude *= 1e3f;
+    value *= 1e3f;
+    i--;
   }
+  while (i < 5 && magnitude >= 1e3f)
+  {
+    magnitude /= 1e3f;
+    value /= 1e3f;
+    i++;
+  }
+  *prefix = prefixes[i];
+  return value;
+}
+
+/**
+ * @brief  滚动模式：把采集引擎送来的新列逐个绘制为一行
+ * @retval None
+ * @note   时基单位为 ms/div，抽取后每列对应 time_base / GRID_SIZE 毫秒，与每行的时间相同。
+ *         列在抽取完成时已放入队列，滚动模式下主循环不延时，每一轮都取空队列。
+ *         从采样到显示的延迟不超过一列的时间加一个数据块，再加主循环一轮的耗时：
+ *         通常不到 1ms，处理串口指令或重绘 TFT2 面板的那一轮为数毫秒到数十毫秒，期间积压的列在下一轮一起绘制。
+ *         每列同时追加到长记录 (峰值检测时取最小值和最大值的中点)。
+ */
+void roll_update(void)
+{
+  SCOPE_Roll_Column column;
 
-  // 如果找到至少两个交叉点，计算频率
-  if (crossings >= 2 && last_crossing > first_crossing)
+  // 落后太多时 (例如串口处理耗时) 最多绘制一整屏，其余留到下一次
+  for (uint16_t n = 0; n < TFT1_SCREEN_HEIGHT && SCOPE_Roll_Read(&column); n++)
   {
-    // 计算周期数
-    float num_cycles = (float)(crossings - 1) / 2.0f;
+    roll_push_line(&column);
+    SCOPE_Log_Append((column.min[0] + column.max[0]) / 2, (column.min[1] + column.max[1]) / 2);
+  }
+}
 
-    // 计算周期时间 (ms)
-    float period_time = (float)(last_crossing - first_crossing) * time_base / GRID_SIZE;
+/**
+ * @brief  滚动模式：码值转换为滚动行内的位置
+ * @param  code          12 位码值
+ * @param  volts_per_div 电压刻度 (V/div)
+ * @retval 位置 (0 ~ depth - 1)，正电压向右
+ */
+uint16_t roll_position(uint16_t code, float volts_per_div)
+{
+  uint16_t depth = roll1.depth;
+  float pixels_per_div = depth / 8; // 与正常模式一样，满幅为 ±4 格
+  float x = depth / 2 + ((int32_t)code - SCOPE_ADC_ZERO_CODE) * pixels_per_div / (SCOPE_CODES_PER_VOLT * volts_per_div);
+  return (x < 0) ? 0 : (x >= depth) ? depth - 1 : (uint16_t)x;
+}
 
-    // 计算频率 (Hz)
-    if (period_time > 0)
-      signal_frequency = (1000.0f * num_cycles) / period_time;
-    else
-      signal_frequency = 0;
+/**
+ * @brief  滚动模式：把一列绘制为一行像素
+ * @param  column 列数据 (峰值检测时为最小值和最大值)
+ * @retval None
+ * @note   竖屏时滚动轴为屏幕Y，时间向下推进，电压沿X轴显示 (正电压向右)。
+ */
+void roll_push_line(const SCOPE_Roll_Column *column)
+{
+  uint16_t depth = roll1.depth;
+  uint16_t min1 = roll_position(column->min[0], voltage_scale1);
+  uint16_t max1 = roll_position(column->max[0], voltage_scale1);
+  uint16_t min2 = roll_position(column->min[1], voltage_scale2);
+  uint16_t max2 = roll_position(column->max[1], voltage_scale2);
+
+  // 本行的范围再延伸到上一行的中点，保证陡峭边沿连续
+  uint16_t lo1 = (min1 < roll_last1) ? min1 : roll_last1;
+  uint16_t hi1 = (max1 > roll_last1) ? max1 : roll_last1;
+  uint16_t lo2 = (min2 < roll_last2) ? min2 : roll_last2;
+  uint16_t hi2 = (max2 > roll_last2) ? max2 : roll_last2;
+  // 网格图层的时间轴沿滚动方向，用已推入的行数作为时间坐标，网格线随内容一起滚动
+  uint16_t time_x = roll_count % roll_graticule.width;
+
+  TFT_Roll_Begin_Line(&roll1);
+  for (uint16_t x = 0; x < depth; x++)
+  {
+    uint16_t color = SCOPE_Graticule_Pixel(&roll_graticule, time_x, depth - 1 - x); // 正电压向右
+    if (channel2_enabled && x >= lo2 && x <= hi2)
+      color = CYAN;
+    if (channel1_enabled && x >= lo1 && x <= hi1)
+      color = YELLOW;
+    TFT_Buffer_Write16(&htft1, color);
   }
+  TFT_Roll_End_Line(&roll1);
+
+  roll_last1 = (min1 + max1) / 2;
+  roll_last2 = (min2 + max2) / 2;
+  roll_count++;
 }
 
 /**
@@ -573,16 +1044,19 @@ void parse_uart_command(char *command)
   // 自动设置
   if (strstr(command, ":AUTOSCALE"))
   {
-    time_base = 0.01f;               // 默认时基设置为10ms/div
+    time_base = 10.0f;               // 默认时基设置为10ms/div
     voltage_scale1 = 1.0f;           // 默认通道1电压刻度
     voltage_scale2 = 1.0f;           // 默认通道2电压刻度
     trigger_level = 0.0f;            // 默认触发电平
+    trigger_position = 0.0f;         // 触发点位于屏幕中心
     run_state = 1;                   // 运行状态
     channel1_enabled = 1;            // 启用通道1
     channel2_enabled = 1;            // 启用通道2
-    sine_frequency = 1.0f;           // 重置正弦波频率
-    square_frequency = 1.0f;         // 重置方波频率
     strcpy(coupling_mode, "DC");     // 默认耦合方式
+    strcpy(coupling_mode2, "DC");
+    bandwidth_limit[0] = 0;          // 关闭带宽限制
+    bandwidth_limit[1] = 0;
+    filter_update();
     strcpy(trigger_slope, "POS");    // 默认上升沿触发
     strcpy(trigger_source, "CHAN1"); // 默认通道1触发
 
@@ -656,38 +1130,159 @@ void parse_uart_command(char *command)
     if (strstr(command, "DC"))
     {
       strcpy(coupling_mode, "DC");
+      filter_update();
       HAL_UART_Transmit(&huart1, (uint8_t *)"Coupling: DC\r\n", 14, 100);
     }
     else if (strstr(command, "AC"))
     {
       strcpy(coupling_mode, "AC");
+      filter_update();
       HAL_UART_Transmit(&huart1, (uint8_t *)"Coupling: AC\r\n", 14, 100);
     }
   }
+  else if (strstr(command, ":CHAN2:COUP"))
+  {
+    if (strstr(command, "DC"))
+    {
+      strcpy(coupling_mode2, "DC");
+      filter_update();
+      HAL_UART_Transmit(&huart1, (uint8_t *)"CH2 coupling: DC\r\n", 18, 100);
+    }
+    else if (strstr(command, "AC"))
+    {
+      strcpy(coupling_mode2, "AC");
+      filter_update();
+      HAL_UART_Transmit(&huart1, (uint8_t *)"CH2 coupling: AC\r\n", 18, 100);
+    }
+  }
 
-  // 新的时基设置格式 - :TIM:MAIN
- // 通过精确匹配处理特定时基值
-else if (strstr(command, ":TIM:MAIN 0.001"))
-{
-  time_base = 1.0f; // 1ms/div
-  sine_frequency = 2.0f; // 快速
-  square_frequency = 2.0f;
-  HAL_UART_Transmit(&huart1, (uint8_t *)"Timebase: 1.0 ms/div\r\n", 24, 100);
-}
-else if (strstr(command, ":TIM:MAIN 0.01"))
-{
-  time_base = 10.0f; // 10ms/div
-  sine_frequency = 1.0f; // 中速
-  square_frequency = 1.5f;
-  HAL_UART_Transmit(&huart1, (uint8_t *)"Timebase: 10.0 ms/div\r\n", 25, 100);
-}
-else if (strstr(command, ":TIM:MAIN 0.1"))
-{
-  time_base = 100.0f; // 100ms/div
-  sine_frequency = 0.2f; // 非常慢
-  square_frequency = 0.5f;
-  HAL_UART_Transmit(&huart1, (uint8_t *)"Timebase: 100.0 ms/div\r\n", 26, 100);
-}
+  // 带宽限制 - :CHAN1:BWL ON|OFF，截止频率 SCOPE_FILTER_BWL_HZ
+  else if (strstr(command, ":CHAN1:BWL") || strstr(command, ":CHAN2:BWL"))
+  {
+    uint8_t channel = strstr(command, ":CHAN2") ? 1 : 0;
+    if (strstr(command, "OFF"))
+    {
+      bandwidth_limit[channel] = 0;
+      filter_update();
+      HAL_UART_Transmit(&huart1, (uint8_t *)(channel ? "CH2 BWL: OFF\r\n" : "CH1 BWL: OFF\r\n"), 14, 100);
+    }
+    else if (strstr(command, "ON"))
+    {
+      bandwidth_limit[channel] = 1;
+      filter_update();
+      HAL_UART_Transmit(&huart1, (uint8_t *)(channel ? "CH2 BWL: ON\r\n" : "CH1 BWL: ON\r\n"), 13, 100);
+    }
+  }
+
+  // 触发位置设置 - :TIM:POS <秒>，正值使触发点左移 (显示更多触发后的波形)
+  else if (strstr(command, ":TIM:POS"))
+  {
+    float new_pos = 0;
+    char *pos_str = strstr(command, ":TIM:POS") + 8; // 跳过":TIM:POS"
+
+    // 跳过空格
+    while (*pos_str == ' ')
+      pos_str++;
+
+    if (sscanf(pos_str, "%f", &new_pos) == 1)
+    {
+      trigger_position = new_pos;
+      char resp[40];
+      sprintf(resp, "Trigger position: %g s\r\n", trigger_position);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 显示方式 - :TIM:MODE MAIN|XY，XY 显示需要两个通道
+  else if (strstr(command, ":TIM:MODE"))
+  {
+    if (strstr(command, "XY"))
+    {
+      xy_mode = 1;
+      channel1_enabled = channel2_enabled = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Mode: XY\r\n", 10, 100);
+    }
+    else if (strstr(command, "MAIN"))
+    {
+      xy_mode = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Mode: MAIN\r\n", 12, 100);
+    }
+    SCOPE_Persist_Clear(); // 余辉强度图的坐标含义不同
+    SCOPE_Capture_Rearm();
+  }
+
+  // 时基设置 - :TIM:MAIN <秒/格>，快时基配合 :ACQ:MODE ETIM 使用
+  else if (strstr(command, ":TIM:MAIN"))
+  {
+    float new_base = 0;
+    char *base_str = strstr(command, ":TIM:MAIN") + 9; // 跳过":TIM:MAIN"
+
+    // 跳过空格
+    while (*base_str == ' ')
+      base_str++;
+
+    if (sscanf(base_str, "%f", &new_base) == 1 && new_base >= 1e-7f && new_base <= 10.0f)
+    {
+      time_base = new_base * 1000.0f; // 秒/格 -> 毫秒/格
+      char resp[40];
+      sprintf(resp, "Timebase: %g s/div\r\n", new_base);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 触发迟滞设置 - :TRIG:HYST <伏特>
+  else if (strstr(command, ":TRIG:HYST"))
+  {
+    float new_hyst = 0;
+    char *hyst_str = strstr(command, ":TRIG:HYST") + 10; // 跳过":TRIG:HYST"
+
+    // 跳过空格
+    while (*hyst_str == ' ')
+      hyst_str++;
+
+    if (sscanf(hyst_str, "%f", &new_hyst) == 1 && new_hyst >= 0)
+    {
+      trigger_hysteresis = new_hyst;
+      char resp[40];
+      sprintf(resp, "Trigger hysteresis: %g V\r\n", trigger_hysteresis);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 噪声抑制 - :TRIG:NREJ ON|OFF
+  else if (strstr(command, ":TRIG:NREJ"))
+  {
+    if (strstr(command, "ON"))
+    {
+      trigger_noise_reject = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Noise reject: ON\r\n", 18, 100);
+    }
+    else if (strstr(command, "OFF"))
+    {
+      trigger_noise_reject = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Noise reject: OFF\r\n", 19, 100);
+    }
+  }
+
+  // 扫描方式设置 - :TRIG:SWE AUTO|NORM|SING
+  else if (strstr(command, ":TRIG:SWE"))
+  {
+    if (strstr(command, "AUTO"))
+    {
+      strcpy(trigger_sweep, "AUTO");
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Sweep: AUTO\r\n", 13, 100);
+    }
+    else if (strstr(command, "NORM"))
+    {
+      strcpy(trigger_sweep, "NORMAL");
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Sweep: NORMAL\r\n", 15, 100);
+    }
+    else if (strstr(command, "SING"))
+    {
+      strcpy(trigger_sweep, "SINGLE");
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Sweep: SINGLE\r\n", 15, 100);
+    }
+  }
 
   // 触发源设置
   else if (strstr(command, ":TRIG:EDGE:SOUR"))
@@ -719,12 +1314,500 @@ else if (strstr(command, ":TIM:MAIN 0.1"))
     }
   }
 
+  // 余辉设置 - :DISP:PERS OFF|0.1|1|INF
+  else if (strstr(command, ":DISP:PERS"))
+  {
+    if (strstr(command, "INF"))
+    {
+      SCOPE_Persist_Set_Mode(SCOPE_PERSIST_INFINITE);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Persistence: INF\r\n", 18, 100);
+    }
+    else if (strstr(command, "0.1"))
+    {
+      SCOPE_Persist_Set_Mode(SCOPE_PERSIST_100MS);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Persistence: 100ms\r\n", 20, 100);
+    }
+    else if (strstr(command, "OFF"))
+    {
+      SCOPE_Persist_Set_Mode(SCOPE_PERSIST_OFF);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Persistence: OFF\r\n", 18, 100);
+    }
+    else if (strstr(command, "1"))
+    {
+      SCOPE_Persist_Set_Mode(SCOPE_PERSIST_1S);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Persistence: 1s\r\n", 17, 100);
+    }
+  }
+
+  // 采集方式设置 - :ACQ:TYPE NORM|PEAK|HRES|AVER
+  else if (strstr(command, ":ACQ:TYPE"))
+  {
+    if (strstr(command, "NORM"))
+    {
+      SCOPE_Decim_Set_Type(SCOPE_DECIM_NORMAL);
+      acq_average = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Acquire: NORMAL\r\n", 17, 100);
+    }
+    else if (strstr(command, "PEAK"))
+    {
+      SCOPE_Decim_Set_Type(SCOPE_DECIM_PEAK);
+      acq_average = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Acquire: PEAK\r\n", 15, 100);
+    }
+    else if (strstr(command, "HRES"))
+    {
+      SCOPE_Decim_Set_Type(SCOPE_DECIM_HIRES);
+      acq_average = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Acquire: HRES\r\n", 15, 100);
+    }
+    else if (strstr(command, "AVER"))
+    {
+      SCOPE_Decim_Set_Type(SCOPE_DECIM_NORMAL); // 每次采集按普通方式抽取，平均在窗口之间进行
+      acq_average = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Acquire: AVERAGE\r\n", 18, 100);
+    }
+    SCOPE_Average_Reset();
+    SCOPE_Capture_Rearm(); // 丢弃按旧方式装填的记录
+  }
+
+  // 采样方式设置 - :ACQ:MODE RTIM|ETIM，ETIM 在快时基下对重复信号使用等效时间采样
+  else if (strstr(command, ":ACQ:MODE"))
+  {
+    if (strstr(command, "ETIM"))
+    {
+      acq_ets = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Sampling: EQUIVALENT TIME\r\n", 27, 100);
+    }
+    else if (strstr(command, "RTIM"))
+    {
+      acq_ets = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Sampling: REAL TIME\r\n", 21, 100);
+    }
+    acq_time_base = 0.0f; // 主循环重新设置采样率并决定是否使用等效时间采样
+    plot_dirty = 1;
+  }
+
+  // 平均次数设置 - :ACQ:COUN <2~256>
+  else if (strstr(command, ":ACQ:COUN"))
+  {
+    int new_count = 0;
+    char *count_str = strstr(command, ":ACQ:COUN") + 9; // 跳过":ACQ:COUN"
+
+    // 跳过空格
+    while (*count_str == ' ')
+      count_str++;
+
+    if (sscanf(count_str, "%d", &new_count) == 1 && new_count >= SCOPE_AVERAGE_MIN_COUNT && new_count <= SCOPE_AVERAGE_MAX_COUNT)
+    {
+      SCOPE_Average_Set_Count((uint16_t)new_count);
+      char resp[30];
+      sprintf(resp, "Average count: %d\r\n", new_count);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 平均方式设置 - :ACQ:AVER:MODE LIN|EXP (EXP 为无限平均)
+  else if (strstr(command, ":ACQ:AVER:MODE"))
+  {
+    if (strstr(command, "LIN"))
+    {
+      SCOPE_Average_Set_Mode(SCOPE_AVERAGE_LINEAR);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Average mode: LINEAR\r\n", 22, 100);
+    }
+    else if (strstr(command, "EXP"))
+    {
+      SCOPE_Average_Set_Mode(SCOPE_AVERAGE_EXPONENTIAL);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Average mode: EXP\r\n", 19, 100);
+    }
+  }
+
+  // 分段数设置 - :ACQ:SEGM:COUN <1~SCOPE_SEGM_MAX>，1 表示关闭
+  else if (strstr(command, ":ACQ:SEGM:COUN"))
+  {
+    int new_count = 0;
+    char *count_str = strstr(command, ":ACQ:SEGM:COUN") + 14; // 跳过":ACQ:SEGM:COUN"
+
+    // 跳过空格
+    while (*count_str == ' ')
+      count_str++;
+
+    if (sscanf(count_str, "%d", &new_count) == 1 && new_count >= 1 && new_count <= SCOPE_SEGM_MAX)
+    {
+      segment_count = (uint16_t)new_count;
+      uint8_t channels = (channel1_enabled ? 1 : 0) | (channel2_enabled ? 2 : 0);
+      uint16_t actual = SCOPE_Segment_Set_Count(segment_count, channels, segment_format);
+      SCOPE_Capture_Rearm();
+      char resp[30];
+      sprintf(resp, "Segments: %u\r\n", actual);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 分段存储格式 - :ACQ:SEGM:BITS <12|8>，8 位可存放更多段
+  else if (strstr(command, ":ACQ:SEGM:BITS"))
+  {
+    int bits = 0;
+    char *bits_str = strstr(command, ":ACQ:SEGM:BITS") + 14; // 跳过":ACQ:SEGM:BITS"
+
+    // 跳过空格
+    while (*bits_str == ' ')
+      bits_str++;
+
+    if (sscanf(bits_str, "%d", &bits) == 1 && (bits == 12 || bits == 8))
+    {
+      segment_format = (bits == 8) ? SCOPE_SMEM_8BIT : SCOPE_SMEM_12BIT;
+      uint8_t channels = (channel1_enabled ? 1 : 0) | (channel2_enabled ? 2 : 0);
+      uint16_t actual = SCOPE_Segment_Set_Count(segment_count, channels, segment_format);
+      SCOPE_Capture_Rearm();
+      char resp[40];
+      sprintf(resp, "Segment bits: %d, segments: %u\r\n", bits, actual);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 分段浏览 - :ACQ:SEGM:INDEX <1~N> 选择显示的段，:ACQ:SEGM:INDEX? 返回当前段及其触发时刻 (us)
+  else if (strstr(command, ":ACQ:SEGM:INDEX"))
+  {
+    char resp[40];
+    if (strchr(command, '?'))
+    {
+      sprintf(resp, "%u,%lu\r\n", segment_index + 1, (unsigned long)SCOPE_Segment_Get_Time(segment_index));
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+    else
+    {
+      int new_index = 0;
+      char *index_str = strstr(command, ":ACQ:SEGM:INDEX") + 15; // 跳过":ACQ:SEGM:INDEX"
+
+      // 跳过空格
+      while (*index_str == ' ')
+        index_str++;
+
+      if (sscanf(index_str, "%d", &new_index) == 1 && new_index >= 1 && new_index <= SCOPE_Segment_Get_Done())
+      {
+        segment_index = (uint16_t)(new_index - 1);
+        segment_select = 1;
+        sprintf(resp, "Segment: %d\r\n", new_index);
+        HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+      }
+    }
+  }
+
+  // 长记录数据 - :LOG:DATA? <通道 1|2>,<起始帧>,<帧数> 返回码值 (逗号分隔)，起始帧见 :LOG?
+  else if (strstr(command, ":LOG:DATA?"))
+  {
+    int channel = 0;
+    unsigned long first = 0;
+    int count = 0;
+    if (sscanf(strstr(command, ":LOG:DATA?") + 10, "%d,%lu,%d", &channel, &first, &count) == 3 &&
+        (channel == 1 || channel == 2) && count > 0)
+    {
+      uint16_t codes[16];
+      char resp[16 * 5 + 3];
+      while (count > 0)
+      {
+        uint16_t n = SCOPE_Log_Read((uint8_t)(channel - 1), first, (count > 16) ? 16 : (uint16_t)count, codes);
+        if (n == 0)
+          break;
+        char *p = resp;
+        for (uint16_t i = 0; i < n; i++)
+          p += sprintf(p, "%u,", codes[i]);
+        first += n;
+        count -= n;
+        if (count == 0)
+          p[-1] = '\0'; // 去掉最后的逗号
+        HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+      }
+      HAL_UART_Transmit(&huart1, (uint8_t *)"\r\n", 2, 100);
+    }
+  }
+
+  // 长记录统计 - :LOG? 返回 最早帧,帧数,字节数,压缩比,原样块数
+  else if (strstr(command, ":LOG?"))
+  {
+    SCOPE_Log_Stats log_stats;
+    char resp[60];
+    SCOPE_Log_Get_Stats(&log_stats);
+    sprintf(resp, "%lu,%lu,%u,%.2f,%u\r\n", (unsigned long)log_stats.first, (unsigned long)log_stats.frames,
+            log_stats.bytes, log_stats.ratio, log_stats.raw_blocks);
+    HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+  }
+
+  // 测量项 - :MEAS:ITEM <位掩码> 选择每次采集计算的项，:MEAS:ITEM? 返回当前掩码
+  else if (strstr(command, ":MEAS:ITEM"))
+  {
+    char resp[20];
+    if (!strchr(command, '?'))
+    {
+      unsigned int mask = 0;
+      char *mask_str = strstr(command, ":MEAS:ITEM") + 10; // 跳过":MEAS:ITEM"
+
+      // 跳过空格
+      while (*mask_str == ' ')
+        mask_str++;
+
+      if (sscanf(mask_str, "%i", &mask) == 1)
+        measure_mask = (uint16_t)mask & SCOPE_MEAS_ALL;
+    }
+    sprintf(resp, "0x%03X\r\n", measure_mask);
+    HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+  }
+
+  // 谐波分析查询 - :MEAS:<FUND|LEV|THD|SNR|SINAD|ENOB>? 频谱模式下每帧计算，无效时返回 9.9E37
+  else if (strstr(command, ":MEAS:FUND?") || strstr(command, ":MEAS:LEV?") || strstr(command, ":MEAS:THD?") ||
+           strstr(command, ":MEAS:SNR?") || strstr(command, ":MEAS:SINAD?") || strstr(command, ":MEAS:ENOB?"))
+  {
+    static const char *const names[SCOPE_HARM_COUNT] = {"FUND", "LEV", "THD", "SNR", "SINAD", "ENOB"};
+    char *item = strstr(command, ":MEAS:") + 6; // 跳过":MEAS:"
+    for (uint8_t i = 0; i < SCOPE_HARM_COUNT; i++)
+    {
+      size_t len = strlen(names[i]);
+      if (strncmp(item, names[i], len) == 0 && item[len] == '?')
+      {
+        char resp[20];
+        if (harmonic_result.valid)
+          sprintf(resp, "%.4e\r\n", harmonic_result.value[i]);
+        else
+          strcpy(resp, "9.9E37\r\n");
+        HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+        break;
+      }
+    }
+  }
+
+  // 测量值查询 - :MEAS:<项>? [CHAN1|CHAN2]，未选中的项从下一次采集开始计算，无效时返回 9.9E37
+  else if (strstr(command, ":MEAS:"))
+  {
+    static const char *const names[SCOPE_MEAS_COUNT] = {"VMAX", "VMIN", "VPP", "VAVG", "VRMS", "PER",
+                                                        "FREQ", "RISE", "FALL", "PDUT", "PWID"};
+    char *item = strstr(command, ":MEAS:") + 6; // 跳过":MEAS:"
+    uint8_t channel = strstr(command, "CHAN2") ? 1 : 0;
+    for (uint8_t i = 0; i < SCOPE_MEAS_COUNT; i++)
+    {
+      size_t len = strlen(names[i]);
+      if (strncmp(item, names[i], len) == 0 && item[len] == '?')
+      {
+        char resp[20];
+        measure_mask |= SCOPE_MEAS_BIT(i);
+        if (measure_result[channel].valid & SCOPE_MEAS_BIT(i))
+          sprintf(resp, "%.4e\r\n", measure_result[channel].value[i]);
+        else
+          strcpy(resp, "9.9E37\r\n");
+        HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+        break;
+      }
+    }
+  }
+
+  // 频率计闸门时间 - :COUN:GATE <秒>，越长有效数字越多
+  else if (strstr(command, ":COUN:GATE"))
+  {
+    float gate = 0;
+    char *gate_str = strstr(command, ":COUN:GATE") + 10; // 跳过":COUN:GATE"
+
+    // 跳过空格
+    while (*gate_str == ' ')
+      gate_str++;
+
+    if (sscanf(gate_str, "%f", &gate) == 1 && gate > 0)
+    {
+      SCOPE_Counter_Set_Gate((uint32_t)(gate * 1000.0f + 0.5f));
+      char resp[30];
+      sprintf(resp, "Gate: %lu ms\r\n", (unsigned long)SCOPE_Counter_Get_Gate());
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 频率计读数 - :COUN? 返回 PA8 输入的频率 (Hz)，没有信号时为 0
+  else if (strstr(command, ":COUN?"))
+  {
+    char resp[24];
+    sprintf(resp, "%.8e\r\n", SCOPE_Counter_Get_Frequency());
+    HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+  }
+
+  // 频谱显示 - :FFT:DISP ON|OFF
+  else if (strstr(command, ":FFT:DISP"))
+  {
+    if (strstr(command, "ON"))
+    {
+      fft_display = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"FFT: ON\r\n", 9, 100);
+    }
+    else if (strstr(command, "OFF"))
+    {
+      fft_display = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"FFT: OFF\r\n", 10, 100);
+    }
+  }
+
+  // 频谱窗函数 - :FFT:WIND RECT|HANN|HAMM|BHAR|FLAT
+  else if (strstr(command, ":FFT:WIND"))
+  {
+    static const char *const names[] = {"RECT", "HANN", "HAMM", "BHAR", "FLAT"};
+    char *name = strstr(command, ":FFT:WIND") + 9; // 跳过":FFT:WIND"
+    for (uint8_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+      if (strstr(name, names[i]))
+      {
+        fft_window = (SCOPE_Fft_Window)i;
+        fft_restart = 1; // 窗函数在开始收集时设置
+        char resp[20];
+        sprintf(resp, "Window: %s\r\n", names[i]);
+        HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+        break;
+      }
+    }
+  }
+
+  // 频谱点数 - :FFT:SIZE 256|512|1024，点数越多频率分辨率越高
+  else if (strstr(command, ":FFT:SIZE"))
+  {
+    int new_size = 0;
+    char *size_str = strstr(command, ":FFT:SIZE") + 9; // 跳过":FFT:SIZE"
+
+    // 跳过空格
+    while (*size_str == ' ')
+      size_str++;
+
+    if (sscanf(size_str, "%d", &new_size) == 1 && (new_size == 256 || new_size == 512 || new_size == SCOPE_FFT_MAX_SIZE))
+    {
+      fft_size = (uint16_t)new_size;
+      fft_restart = 1;
+      char resp[20];
+      sprintf(resp, "FFT size: %d\r\n", new_size);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 频谱信源 - :FFT:SOUR CHAN1|CHAN2
+  else if (strstr(command, ":FFT:SOUR"))
+  {
+    if (strstr(command, "CHAN1"))
+    {
+      fft_source = 0;
+      fft_restart = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"FFT source: CHAN1\r\n", 19, 100);
+    }
+    else if (strstr(command, "CHAN2"))
+    {
+      fft_source = 1;
+      fft_restart = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"FFT source: CHAN2\r\n", 19, 100);
+    }
+  }
+
+  // 数学通道显示 - :MATH:DISP ON|OFF
+  else if (strstr(command, ":MATH:DISP"))
+  {
+    if (strstr(command, "ON"))
+    {
+      math_enabled = 1;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Math: ON\r\n", 10, 100);
+    }
+    else if (strstr(command, "OFF"))
+    {
+      math_enabled = 0;
+      math_shown = 0;
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Math: OFF\r\n", 11, 100);
+    }
+  }
+
+  // 数学通道运算 - :MATH:OPER <运算>[,<运算>...]，ADD|SUB|MUL|INTG|DIFF|LPF 按顺序执行，NONE 为直接显示信源
+  else if (strstr(command, ":MATH:OPER"))
+  {
+    static const char *const names[SCOPE_MATH_KERNEL_COUNT] = {"ADD", "SUB", "MUL", "INTG", "DIFF", "LPF"};
+    SCOPE_Math_Kernel kernels[SCOPE_MATH_MAX_KERNELS];
+    uint8_t count = 0;
+    char *token = strstr(command, ":MATH:OPER") + 10; // 跳过":MATH:OPER"
+    while (*token && count < SCOPE_MATH_MAX_KERNELS)
+    {
+      while (*token == ' ' || *token == ',')
+        token++;
+      uint8_t i = 0;
+      while (i < SCOPE_MATH_KERNEL_COUNT && strncmp(token, names[i], strlen(names[i])) != 0)
+        i++;
+      if (i == SCOPE_MATH_KERNEL_COUNT)
+        break;
+      kernels[count++] = (SCOPE_Math_Kernel)i;
+      token += strlen(names[i]);
+    }
+    count = SCOPE_Math_Set_Kernels(kernels, count);
+    char resp[30];
+    sprintf(resp, "Math: %u op(s), %s\r\n", count, SCOPE_Math_Get_Unit());
+    HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+  }
+
+  // 数学通道信源 - :MATH:SOUR CHAN1|CHAN2，ADD/SUB/MUL 使用另一个通道
+  else if (strstr(command, ":MATH:SOUR"))
+  {
+    if (strstr(command, "CHAN1"))
+    {
+      SCOPE_Math_Set_Source(0);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Math source: CHAN1\r\n", 20, 100);
+    }
+    else if (strstr(command, "CHAN2"))
+    {
+      SCOPE_Math_Set_Source(1);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Math source: CHAN2\r\n", 20, 100);
+    }
+  }
+
+  // 数学通道低通截止频率 - :MATH:LPF <Hz>
+  else if (strstr(command, ":MATH:LPF"))
+  {
+    float cutoff = 0;
+    char *cutoff_str = strstr(command, ":MATH:LPF") + 9; // 跳过":MATH:LPF"
+
+    // 跳过空格
+    while (*cutoff_str == ' ')
+      cutoff_str++;
+
+    if (sscanf(cutoff_str, "%f", &cutoff) == 1 && cutoff > 0)
+    {
+      SCOPE_Math_Set_Lowpass(cutoff);
+      char resp[30];
+      sprintf(resp, "Math LPF: %.1f Hz\r\n", cutoff);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
+  // 数学通道刻度 - :MATH:SCAL <每格的值>|AUTO
+  else if (strstr(command, ":MATH:SCAL"))
+  {
+    float scale = 0;
+    char *scale_str = strstr(command, ":MATH:SCAL") + 10; // 跳过":MATH:SCAL"
+
+    // 跳过空格
+    while (*scale_str == ' ')
+      scale_str++;
+
+    if (strstr(scale_str, "AUTO"))
+    {
+      SCOPE_Math_Set_Scale(0);
+      HAL_UART_Transmit(&huart1, (uint8_t *)"Math scale: AUTO\r\n", 18, 100);
+    }
+    else if (sscanf(scale_str, "%f", &scale) == 1 && scale > 0)
+    {
+      SCOPE_Math_Set_Scale(scale);
+      char resp[30];
+      sprintf(resp, "Math scale: %g\r\n", scale);
+      HAL_UART_Transmit(&huart1, (uint8_t *)resp, strlen(resp), 100);
+    }
+  }
+
   // 运行/停止控制
   else if (strstr(command, ":RUN"))
   {
     run_state = !run_state; // 切换运行/停止状态
     if (run_state)
+    {
+      if (strcmp(trigger_sweep, "SINGLE") == 0)
+        strcpy(trigger_sweep, "AUTO"); // 单次触发结束后 RUN 恢复连续扫描
+      SCOPE_Segment_Reset();           // 分段存储开始新的序列
+      SCOPE_Capture_Rearm();           // 丢弃停止期间冻结的旧窗口
       HAL_UART_Transmit(&huart1, (uint8_t *)"RUN\r\n", 5, 100);
+    }
     else
       HAL_UART_Transmit(&huart1, (uint8_t *)"STOP\r\n", 6, 100);
   }
@@ -735,6 +1818,26 @@ else if (strstr(command, ":TIM:MAIN 0.1"))
     run_state = 0; // 停止
     HAL_UART_Transmit(&huart1, (uint8_t *)"STOP\r\n", 6, 100);
   }
+
+  // 单次触发：等待一次触发，取得窗口后自动停止
+  else if (strstr(command, ":SING"))
+  {
+    strcpy(trigger_sweep, "SINGLE");
+    SCOPE_Capture_Set_Sweep(SCOPE_SWEEP_SINGLE); // 立即生效，避免重新装填后先按旧方式超时
+    SCOPE_Segment_Reset();
+    SCOPE_Capture_Rearm();
+    run_state = 1;
+    HAL_UART_Transmit(&huart1, (uint8_t *)"SINGLE\r\n", 8, 100);
+  }
+
+  // 触发事件查询 - :TER? 返回上次查询以来是否发生过触发
+  else if (strstr(command, ":TER?"))
+  {
+    if (SCOPE_Capture_Take_Event())
+      HAL_UART_Transmit(&huart1, (uint8_t *)"1\r\n", 3, 100);
+    else
+      HAL_UART_Transmit(&huart1, (uint8_t *)"0\r\n", 3, 100);
+  }
 }
 
 /* USER CODE END 4 */
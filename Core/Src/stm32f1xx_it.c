@@ -22,6 +22,8 @@
 #include "stm32f1xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_counter.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -244,4 +246,28 @@ void USART1_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA1 channel1 global interrupt (ADC1 采集).
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  SCOPE_Acq_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles ADC1 and ADC2 global interrupts (模拟看门狗触发).
+  */
+void ADC1_2_IRQHandler(void)
+{
+  SCOPE_Acq_ADC_IRQHandler();
+}
+
+/**
+  * @brief This function handles TIM1 update interrupt (频率计计数值扩展).
+  */
+void TIM1_UP_IRQHandler(void)
+{
+  SCOPE_Counter_TIM_IRQHandler();
+}
+
 /* USER CODE END 1 */
@@ -0,0 +1,41 @@
+/*
+ * @file    scope_test.h
+ * @brief   主机测试的断言和合成采集的驱动
+ * @details 测试在 PC 上编译固件的采集模块 (SCOPE_ACQ_SIM 为 1)，
+ *          用 SCOPE_Acq_Sim_Pump 代替 DMA 交出数据块，断言冻结窗口的内容。
+ */
+#ifndef __SCOPE_TEST_H
+#define __SCOPE_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+static int test_failures = 0; // 失败的断言数
+static int test_checks = 0;   // 执行的断言数
+
+/**
+ * @brief 断言条件成立，失败时打印位置和说明，继续执行
+ */
+#define TEST_CHECK(cond, ...)                                            \
+    do                                                                   \
+    {                                                                    \
+        test_checks++;                                                   \
+        if (!(cond))                                                     \
+        {                                                                \
+            test_failures++;                                             \
+            printf("%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond);      \
+            printf(__VA_ARGS__);                                         \
+            printf("\n");                                                \
+        }                                                                \
+    } while (0)
+
+/**
+ * @brief 打印结果，作为 main 的返回值
+ */
+static inline int TEST_Report(const char *name)
+{
+    printf("%s: %d checks, %d failures\n", name, test_checks, test_failures);
+    return test_failures ? 1 : 0;
+}
+
+#endif /* __SCOPE_TEST_H */
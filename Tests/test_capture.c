@@ -0,0 +1,269 @@
+/**
+ * @file    test_capture.c
+ * @brief   采集链路的主机测试：合成信号 -> 滤波 -> 抽取 -> 触发捕获
+ * @details 与 main.c 一样连接各模块，按毫秒推进 SCOPE_Acq_Sim_Pump 直到窗口冻结，
+ *          再把冻结窗口与按触发点重建的理想波形逐点比较。
+ */
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_filter.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "scope_test.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define TEST_LEVEL SCOPE_ADC_ZERO_CODE // 触发电平
+#define TEST_SINE_AMP (SCOPE_ACQ_SIM_CH1_VOLTS * SCOPE_CODES_PER_VOLT)
+#define TEST_SQUARE_AMP ((int32_t)(SCOPE_ACQ_SIM_CH2_VOLTS * SCOPE_CODES_PER_VOLT))
+
+static uint32_t test_now = 0; // 合成信号的时刻 (ms)
+
+/**
+ * @brief  按时基设置采样率，与 main.c 修改时基时的顺序相同
+ * @param  time_base 时基 (ms/div)
+ * @param  ch1       通道1使能
+ * @param  ch2       通道2使能
+ * @retval 每列的采样率 (Hz)
+ */
+static float Test_Setup(float time_base, uint8_t ch1, uint8_t ch2)
+{
+	SCOPE_Acq_Set_Channels(ch1, ch2);
+	SCOPE_Decim_Set_Rate(SCOPE_Acq_Rate_For_Time_Base(time_base));
+	SCOPE_Filter_Set_Rate(SCOPE_Acq_Get_Sample_Rate());
+	SCOPE_Capture_Rearm();
+	return SCOPE_Decim_Get_Rate();
+}
+
+/**
+ * @brief  推进合成信号直到窗口冻结
+ * @param  limit_ms 最长的合成时间 (ms)
+ * @retval 1: 已冻结，0: 超时
+ */
+static uint8_t Test_Pump_Until_Ready(uint32_t limit_ms)
+{
+	for (uint32_t i = 0; i < limit_ms && !SCOPE_Capture_Ready(); i++)
+		SCOPE_Acq_Sim_Pump(++test_now);
+	return SCOPE_Capture_Ready();
+}
+
+/**
+ * @brief  把冻结窗口与触发点对齐的正弦波逐点比较
+ * @param  channel 通道
+ * @param  hz      正弦波频率
+ * @param  rate    每列的采样率
+ * @retval 最大误差 (码值)
+ */
+static int32_t Test_Sine_Error(uint8_t channel, float hz, float rate)
+{
+	// 越过点在触发采样之前 (256 - frac) / 256 个采样处，正弦波在越过点的相位为 0
+	float cross = SCOPE_Capture_Get_Trigger_Index() - (256 - SCOPE_Capture_Get_Trigger_Fraction()) / 256.0f;
+	int32_t worst = 0;
+	for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i++)
+	{
+		float expected = SCOPE_ADC_ZERO_CODE + TEST_SINE_AMP * sinf(2 * 3.14159265f * hz * (i - cross) / rate);
+		int32_t err = abs((int32_t)SCOPE_Capture_Sample(channel, i) - (int32_t)lrintf(expected));
+		if (err > worst)
+			worst = err;
+	}
+	return worst;
+}
+
+/**
+ * @brief  同步模式：两个通道在同一窗口中，CH1 正弦波在触发点越过电平，CH2 方波只有两个电平
+ */
+static void Test_Simultaneous(void)
+{
+	SCOPE_Acq_Sim_Set_Frequency(0, 30.0f);
+	float rate = Test_Setup(2.0f, 1, 1); // 24 ms 一屏，小于正弦波的周期，窗口中只有一个上升沿
+	SCOPE_Decim_Set_Type(SCOPE_DECIM_NORMAL);
+	SCOPE_Capture_Set_Trigger(0, TEST_LEVEL, SCOPE_SLOPE_RISING);
+	SCOPE_Capture_Set_Hysteresis(20);
+	SCOPE_Capture_Set_Pretrigger(SCOPE_RECORD_LEN / 2);
+	SCOPE_Capture_Set_Sweep(SCOPE_SWEEP_NORMAL);
+	SCOPE_Capture_Rearm();
+
+	for (int n = 0; n < 5; n++)
+	{
+		TEST_CHECK(Test_Pump_Until_Ready(100), "window %d not frozen", n);
+		TEST_CHECK(SCOPE_Capture_Get_Mode() == SCOPE_ACQ_SIMULTANEOUS, "mode %d", SCOPE_Capture_Get_Mode());
+		TEST_CHECK(SCOPE_Capture_Get_Status() == SCOPE_STATUS_TRIGD, "status %d", SCOPE_Capture_Get_Status());
+
+		uint16_t t = SCOPE_Capture_Get_Trigger_Index();
+		TEST_CHECK(t == SCOPE_RECORD_LEN / 2, "trigger index %u", t);
+		TEST_CHECK(SCOPE_Capture_Sample(0, t - 1) < TEST_LEVEL && SCOPE_Capture_Sample(0, t) >= TEST_LEVEL,
+				   "no crossing at the trigger index: %u %u", SCOPE_Capture_Sample(0, t - 1), SCOPE_Capture_Sample(0, t));
+
+		// 噪声加上越过点插值和采样时刻的量化
+		int32_t err = Test_Sine_Error(0, 30.0f, rate);
+		TEST_CHECK(err <= 2 * SCOPE_ACQ_SIM_NOISE + 8, "CH1 error %d codes", (int)err);
+
+		for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i++)
+		{
+			int32_t d = abs((int32_t)SCOPE_Capture_Sample(1, i) - SCOPE_ADC_ZERO_CODE);
+			if (abs(d - TEST_SQUARE_AMP) > SCOPE_ACQ_SIM_NOISE)
+			{
+				TEST_CHECK(0, "CH2 sample %u is %u", i, SCOPE_Capture_Sample(1, i));
+				break;
+			}
+		}
+		SCOPE_Capture_Rearm();
+	}
+}
+
+/**
+ * @brief  快速交替模式：每字两个采样，拼接顺序错误时正弦波会出现锯齿
+ */
+static void Test_Interleaved(void)
+{
+	SCOPE_Acq_Sim_Set_Frequency(0, 20000.0f);
+	float rate = Test_Setup(0.005f, 1, 0); // 5 us/div 超过同步模式的最高采样率
+	TEST_CHECK(SCOPE_Acq_Get_Mode() == SCOPE_ACQ_INTERLEAVED_CH1, "mode %d", SCOPE_Acq_Get_Mode());
+	SCOPE_Capture_Set_Trigger(0, TEST_LEVEL, SCOPE_SLOPE_RISING);
+	SCOPE_Capture_Set_Hysteresis(20);
+	SCOPE_Capture_Rearm();
+
+	TEST_CHECK(Test_Pump_Until_Ready(100), "interleaved window not frozen");
+	TEST_CHECK(SCOPE_Capture_Get_Mode() == SCOPE_ACQ_INTERLEAVED_CH1, "capture mode %d", SCOPE_Capture_Get_Mode());
+	int32_t err = Test_Sine_Error(0, 20000.0f, rate);
+	TEST_CHECK(err <= 2 * SCOPE_ACQ_SIM_NOISE + 8, "interleaved error %d codes", (int)err);
+}
+
+/**
+ * @brief  抽取：慢时基下 ADC 以更高采样率运行，窗口按每列的采样率与正弦波对齐
+ */
+static void Test_Decimated(void)
+{
+	SCOPE_Acq_Sim_Set_Frequency(0, 3.0f);
+	float rate = Test_Setup(20.0f, 1, 1); // 240 ms 一屏
+	TEST_CHECK(SCOPE_Decim_Get_Factor() > 1, "factor %u", SCOPE_Decim_Get_Factor());
+	SCOPE_Capture_Rearm();
+
+	TEST_CHECK(Test_Pump_Until_Ready(1000), "decimated window not frozen");
+	int32_t err = Test_Sine_Error(0, 3.0f, rate);
+	TEST_CHECK(err <= 2 * SCOPE_ACQ_SIM_NOISE + 8, "decimated error %d codes", (int)err);
+}
+
+/**
+ * @brief  高分辨率：每列 100 个采样的平均值保留 4 位小数，比四舍五入的 12 位码值更接近理想波形
+ */
+static void Test_Hires(void)
+{
+	SCOPE_Acq_Sim_Set_Frequency(0, 3.0f);
+	float rate = Test_Setup(20.0f, 1, 1);
+	SCOPE_Decim_Set_Type(SCOPE_DECIM_HIRES);
+	SCOPE_Capture_Rearm();
+	TEST_CHECK(SCOPE_Decim_Get_Factor() >= 16, "factor %u", SCOPE_Decim_Get_Factor());
+
+	TEST_CHECK(Test_Pump_Until_Ready(1000), "high resolution window not frozen");
+	float cross = SCOPE_Capture_Get_Trigger_Index() - (256 - SCOPE_Capture_Get_Trigger_Fraction()) / 256.0f;
+	float err12 = 0, err4 = 0;
+	uint16_t fractions = 0, rounded = 0;
+	for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i++)
+	{
+		uint16_t q4 = SCOPE_Capture_Sample_Q4(0, i);
+		uint16_t code = SCOPE_Capture_Sample(0, i);
+		float expected = SCOPE_ADC_ZERO_CODE + TEST_SINE_AMP * sinf(2 * 3.14159265f * 3.0f * (i - cross) / rate);
+		err12 += fabsf(code - expected);
+		err4 += fabsf(q4 / 16.0f - expected);
+		fractions += (q4 & 15) != 0;
+		rounded += (code == (q4 + 8) >> 4);
+	}
+	TEST_CHECK(fractions > SCOPE_RECORD_LEN / 2, "only %u samples with a fraction", fractions);
+	TEST_CHECK(rounded == SCOPE_RECORD_LEN, "%u samples not rounded from Q4", SCOPE_RECORD_LEN - rounded);
+	TEST_CHECK(err4 < err12, "Q4 error %.3f codes is not below the 12-bit error %.3f", err4 / SCOPE_RECORD_LEN,
+			   err12 / SCOPE_RECORD_LEN);
+	SCOPE_Decim_Set_Type(SCOPE_DECIM_NORMAL);
+}
+
+static uint32_t test_columns = 0; // 抽取输出的列数
+
+/**
+ * @brief  只计数的抽取输出
+ */
+static void Test_Count_Columns(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	test_columns += count;
+}
+
+/**
+ * @brief  最大抽取倍数：每列跨越上千个数据块，输出的列数必须与每列采样率一致
+ */
+static void Test_Max_Factor(void)
+{
+	SCOPE_Acq_Set_Channels(1, 1);
+	float rate = SCOPE_Decim_Set_Rate(1.0f);
+	SCOPE_Filter_Set_Rate(SCOPE_Acq_Get_Sample_Rate());
+	TEST_CHECK(SCOPE_Decim_Get_Factor() == 65535, "factor %u", SCOPE_Decim_Get_Factor());
+
+	SCOPE_Decim_Set_Output(Test_Count_Columns, SCOPE_Capture_Envelope_Block);
+	test_columns = 0;
+	for (uint32_t i = 0; i < 10000; i++)
+		SCOPE_Acq_Sim_Pump(++test_now);
+	SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+	TEST_CHECK(fabsf(test_columns - rate * 10) <= 1, "%u columns in 10 s at %.3f Hz", (unsigned)test_columns, rate);
+}
+
+static uint16_t test_windows = 0; // 窗口冻结回调取走的窗口数
+static uint16_t test_bad = 0;     // 触发点处没有越过电平的窗口数
+
+/**
+ * @brief  窗口冻结回调：检查越过点后取走窗口，与分段采集一样直接回到 ARMED
+ */
+static uint8_t Test_Window(void)
+{
+	uint16_t t = SCOPE_Capture_Get_Trigger_Index();
+	if (!(SCOPE_Capture_Sample(0, t - 1) < TEST_LEVEL && SCOPE_Capture_Sample(0, t) >= TEST_LEVEL))
+		test_bad++;
+	return ++test_windows < 200;
+}
+
+/**
+ * @brief  长时间停留在 ARMED：采样序号按 SCOPE_CAPTURE_REBASE 回绕后窗口位置不变
+ * @note   Makefile 把 SCOPE_CAPTURE_REBASE 设得很小，几秒的合成信号就回绕多次
+ */
+static void Test_Rebase(void)
+{
+	SCOPE_Acq_Sim_Set_Frequency(0, 30.0f);
+	float rate = Test_Setup(2.0f, 1, 1);
+	SCOPE_Capture_Set_Sweep(SCOPE_SWEEP_NORMAL);
+
+	// 普通扫描等不到触发
+	SCOPE_Capture_Set_Trigger(0, SCOPE_ADC_FULL_SCALE - 1, SCOPE_SLOPE_RISING);
+	SCOPE_Capture_Rearm();
+	TEST_CHECK(!Test_Pump_Until_Ready(2000), "triggered above the signal");
+	SCOPE_Capture_Set_Trigger(0, TEST_LEVEL, SCOPE_SLOPE_RISING);
+	TEST_CHECK(Test_Pump_Until_Ready(100), "no window after a long wait");
+	uint16_t t = SCOPE_Capture_Get_Trigger_Index();
+	TEST_CHECK(SCOPE_Capture_Sample(0, t - 1) < TEST_LEVEL && SCOPE_Capture_Sample(0, t) >= TEST_LEVEL,
+			   "no crossing after a long wait: %u %u", SCOPE_Capture_Sample(0, t - 1), SCOPE_Capture_Sample(0, t));
+	int32_t err = Test_Sine_Error(0, 30.0f, rate);
+	TEST_CHECK(err <= 2 * SCOPE_ACQ_SIM_NOISE + 8, "error %d codes after a long wait", (int)err);
+
+	// 窗口冻结后在中断中直接回到 ARMED，不经过 SCOPE_Capture_Rearm
+	SCOPE_Capture_Set_Window_Handler(Test_Window);
+	SCOPE_Capture_Rearm();
+	Test_Pump_Until_Ready(10000);
+	SCOPE_Capture_Set_Window_Handler(NULL);
+	TEST_CHECK(test_windows == 200, "%u windows", test_windows);
+	TEST_CHECK(test_bad == 0, "%u of %u windows without a crossing at the trigger index", test_bad, test_windows);
+	err = Test_Sine_Error(0, 30.0f, rate);
+	TEST_CHECK(err <= 2 * SCOPE_ACQ_SIM_NOISE + 8, "last window error %d codes", (int)err);
+}
+
+int main(void)
+{
+	SCOPE_Acq_Init();
+	SCOPE_Acq_Set_Block_Handler(SCOPE_Filter_Block);
+	SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+	SCOPE_Acq_Set_Watchdog_Handler(SCOPE_Capture_Watchdog);
+	SCOPE_Acq_Start();
+	SCOPE_Acq_Sim_Pump(test_now); // 第一次只记录起点
+
+	Test_Simultaneous();
+	Test_Interleaved();
+	Test_Decimated();
+	Test_Hires();
+	Test_Max_Factor();
+	Test_Rebase();
+	return TEST_Report("test_capture");
+}
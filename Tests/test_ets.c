@@ -0,0 +1,82 @@
+/**
+ * @file    test_ets.c
+ * @brief   等效时间采样的主机测试
+ * @details 按 main.c 进入等效时间采样的步骤设置：237 kHz 正弦波，1 us/div (等效 30 MSPS)，
+ *          单通道快速交替模式。连续 50 次触发后检查覆盖率，
+ *          并把 SCOPE_Ets_To_Screen 的输出与按触发列对齐的理想正弦波比较。
+ */
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_filter.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_ets.h"
+#include "scope_test.h"
+#include <math.h>
+
+#define TEST_HZ 237000.0f       // 合成正弦波频率
+#define TEST_TIME_BASE 0.001f   // 1 us/div
+#define TEST_VOLTS_PER_DIV 1.0f // 电压刻度
+#define TEST_TRIGGERS 50        // 触发次数
+
+int main(void)
+{
+	uint32_t now = 0;
+	uint16_t wave_y[SCOPE_RECORD_LEN];
+
+	SCOPE_Acq_Init();
+	SCOPE_Acq_Set_Block_Handler(SCOPE_Filter_Block);
+	SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+	SCOPE_Acq_Set_Watchdog_Handler(SCOPE_Capture_Watchdog);
+	SCOPE_Acq_Sim_Set_Frequency(0, TEST_HZ);
+
+	// 与 main.c 修改时基时相同
+	SCOPE_Acq_Set_Channels(1, 0);
+	float wanted_rate = SCOPE_Acq_Rate_For_Time_Base(TEST_TIME_BASE);
+	SCOPE_Decim_Set_Rate(wanted_rate);
+	SCOPE_Filter_Set_Rate(SCOPE_Acq_Get_Sample_Rate());
+	TEST_CHECK(wanted_rate > SCOPE_Decim_Get_Rate(), "%.0f Hz is reachable without ETS", wanted_rate);
+	float ratio = SCOPE_Ets_Set_Ratio(wanted_rate / SCOPE_Decim_Get_Rate());
+	SCOPE_Ets_Reset();
+	SCOPE_Ets_Set_Trigger_Column(SCOPE_RECORD_LEN / 2);
+	SCOPE_Capture_Set_Pretrigger(SCOPE_Ets_Get_Pretrigger());
+	SCOPE_Capture_Set_Trigger(0, SCOPE_ADC_ZERO_CODE, SCOPE_SLOPE_RISING);
+	SCOPE_Capture_Set_Hysteresis((uint16_t)(0.05f * SCOPE_CODES_PER_VOLT + 0.5f));
+	SCOPE_Capture_Set_Sweep(SCOPE_SWEEP_NORMAL);
+	SCOPE_Capture_Rearm();
+	SCOPE_Acq_Start();
+	SCOPE_Acq_Sim_Pump(now);
+
+	int triggers = 0;
+	while (triggers < TEST_TRIGGERS && now < 10000)
+	{
+		SCOPE_Acq_Sim_Pump(++now);
+		if (!SCOPE_Capture_Ready())
+			continue;
+		triggers += SCOPE_Ets_Add();
+		SCOPE_Capture_Rearm();
+	}
+	TEST_CHECK(triggers == TEST_TRIGGERS, "%d triggers", triggers);
+
+	uint8_t coverage = SCOPE_Ets_Get_Coverage();
+	TEST_CHECK(coverage >= 97, "coverage %u%% after %d triggers", coverage, triggers);
+
+	// 理想波形：每列间隔 1 / (实际采样率 x 倍数)，触发列上相位为 0
+	TEST_CHECK(SCOPE_Ets_To_Screen(0, wave_y, SCOPE_RECORD_LEN, TEST_VOLTS_PER_DIV), "nothing to draw");
+	float column_rate = SCOPE_Decim_Get_Rate() * ratio;
+	float pixels_per_volt = (float)(SCOPE_PLOT_HEIGHT / SCOPE_DIVS_Y) / TEST_VOLTS_PER_DIV;
+	float sum = 0, worst = 0;
+	for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i++)
+	{
+		float t = (float)(i - SCOPE_RECORD_LEN / 2) / column_rate;
+		float y = SCOPE_PLOT_HEIGHT / 2 - SCOPE_ACQ_SIM_CH1_VOLTS * pixels_per_volt * sinf(2 * 3.14159265f * TEST_HZ * t);
+		float err = fabsf(wave_y[i] - y);
+		sum += err;
+		if (err > worst)
+			worst = err;
+	}
+	float mean = sum / SCOPE_RECORD_LEN;
+	TEST_CHECK(mean < 1.0f, "mean error %.2f px", mean);
+	printf("ETS x%.2f: %u%% coverage after %d triggers, error %.2f px mean, %.1f px worst\n",
+		   ratio, coverage, triggers, mean, worst);
+	return TEST_Report("test_ets");
+}
@@ -0,0 +1,105 @@
+/**
+ * @file    test_fft.c
+ * @brief   定点频谱分析的主机测试
+ * @details 把合成的采样直接交给 SCOPE_Fft_Block，变换后的各频点换算为 dBV，
+ *          与同一组加窗采样的浮点 DFT 比较。三种点数覆盖先做一级基 2 (256、1024 点) 和全部基 4 (512 点)，
+ *          满幅与小幅信号分别覆盖块浮点右移和不移位的级。
+ */
+#include "SCOPEh/SCOPE_fft.h"
+#include "SCOPEh/SCOPE_fft_table.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "scope_test.h"
+#include <math.h>
+
+#define TEST_PI 3.14159265358979
+
+/**
+ * @brief 各窗函数的表和相干增益 (与 SCOPE_fft.c 相同)
+ */
+static const int16_t *const test_window_table[] = {
+	NULL, SCOPE_Fft_Hann_Table, SCOPE_Fft_Hamming_Table, SCOPE_Fft_BlackmanHarris_Table, SCOPE_Fft_Flattop_Table};
+static const double test_window_gain[] = {1.0, 0.5, 0.54, 0.35875, 0.21557895};
+
+static uint32_t test_words[SCOPE_FFT_MAX_SIZE]; // 同步模式的数据字，CH1 在低 16 位
+static double test_ref[SCOPE_FFT_MAX_SIZE / 2];  // 浮点 DFT 各频点的幅度 (有效值，V)
+
+/**
+ * @brief  变换一帧两个正弦波之和并与浮点 DFT 比较
+ * @param  size   点数
+ * @param  window 窗函数
+ * @param  amp    基波幅度 (码值)，二次谐波为其 1/10
+ * @retval 无
+ */
+static void Test_Spectrum(uint16_t size, SCOPE_Fft_Window window, double amp)
+{
+	// 基波在第 37.3 个频点，不落在频点上
+	uint32_t seed = 12345;
+	for (uint16_t i = 0; i < size; i++)
+	{
+		double ph = 2 * TEST_PI * 37.3 * i / size;
+		seed = seed * 1103515245u + 12345u;
+		double v = SCOPE_ADC_ZERO_CODE + amp * sin(ph) + amp / 10 * sin(2 * ph + 1.0) + (int)((seed >> 16) % 5) - 2;
+		test_words[i] = (uint32_t)lrint(v);
+	}
+
+	// 浮点参考：与定点相同的 Q4 码值和 Q15 窗表
+	const int16_t *table = test_window_table[window];
+	double full = 16 * test_window_gain[window] * SCOPE_CODES_PER_VOLT * sqrt(2.0);
+	double peak = 0;
+	for (uint16_t k = 0; k < size / 2; k++)
+	{
+		double re = 0, im = 0;
+		for (uint16_t i = 0; i < size; i++)
+		{
+			double v = (double)(((int32_t)test_words[i] - SCOPE_ADC_ZERO_CODE) << SCOPE_DECIM_HIRES_BITS);
+			if (table != NULL)
+				v = v * table[((i <= size / 2) ? i : size - i) * (SCOPE_FFT_MAX_SIZE / size)] / 32768.0;
+			re += v * cos(2 * TEST_PI * k * i / size);
+			im -= v * sin(2 * TEST_PI * k * i / size);
+		}
+		test_ref[k] = sqrt(re * re + im * im) * 2 / size / full;
+		if (test_ref[k] > peak)
+			peak = test_ref[k];
+	}
+
+	SCOPE_Fft_Start(0, size, window);
+	SCOPE_Fft_Block(test_words, size, SCOPE_ACQ_SIMULTANEOUS);
+	TEST_CHECK(SCOPE_Fft_Ready(), "%u points not collected", size);
+	SCOPE_Fft_Compute();
+	TEST_CHECK(SCOPE_Fft_Get_Bins() == size / 2, "%u bins", SCOPE_Fft_Get_Bins());
+
+	// 误差相对最大频点：量化噪声应低于 -60 dB
+	double worst = 0;
+	uint16_t worst_bin = 0;
+	for (uint16_t k = 0; k < size / 2; k++)
+	{
+		double got = pow(10.0, SCOPE_Fft_Power_To_Dbv((float)SCOPE_Fft_Get_Power(k)) / 20);
+		double err = fabs(got - test_ref[k]) / peak;
+		if (err > worst)
+		{
+			worst = err;
+			worst_bin = k;
+		}
+	}
+	TEST_CHECK(worst < 1e-3, "%u points, window %d, amplitude %.0f: bin %u off by %.1f dB of the peak",
+			   size, window, amp, worst_bin, 20 * log10(worst));
+
+	// 基波频点的电平与浮点结果相差不超过 0.05 dB
+	double got = SCOPE_Fft_Power_To_Dbv((float)SCOPE_Fft_Get_Power(37));
+	double want = 20 * log10(test_ref[37]);
+	TEST_CHECK(fabs(got - want) < 0.05, "%u points, window %d, amplitude %.0f: %.3f dBV vs %.3f dBV",
+			   size, window, amp, got, want);
+}
+
+int main(void)
+{
+	static const uint16_t sizes[] = {256, 512, 1024};
+	static const SCOPE_Fft_Window windows[] = {SCOPE_FFT_RECT, SCOPE_FFT_HANN, SCOPE_FFT_BLACKMAN_HARRIS, SCOPE_FFT_FLATTOP};
+	static const double amps[] = {1850.0, 60.0};
+
+	for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+		for (unsigned w = 0; w < sizeof(windows) / sizeof(windows[0]); w++)
+			for (unsigned a = 0; a < sizeof(amps) / sizeof(amps[0]); a++)
+				Test_Spectrum(sizes[s], windows[w], amps[a]);
+	return TEST_Report("test_fft");
+}
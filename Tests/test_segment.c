@@ -0,0 +1,105 @@
+/**
+ * @file    test_segment.c
+ * @brief   分段存储的主机测试
+ * @details 窗口冻结回调只安排保存，打包在之后的数据块中进行。采集完整个序列后逐段装回，
+ *          检查每段的触发点处越过电平、与按触发点对齐的正弦波一致 (打包晚于覆盖时会出现另一段的数据)，
+ *          触发时刻依次增加。快速交替模式的窗口间隔远小于一个主循环周期，覆盖保存期间继续采集的情况。
+ */
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_filter.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "SCOPEh/SCOPE_segment.h"
+#include "scope_test.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define TEST_LEVEL SCOPE_ADC_ZERO_CODE // 触发电平
+#define TEST_SINE_AMP (SCOPE_ACQ_SIM_CH1_VOLTS * SCOPE_CODES_PER_VOLT)
+
+static uint32_t test_now = 0; // 合成信号的时刻 (ms)
+
+/**
+ * @brief  把装回的窗口与触发点对齐的正弦波逐点比较
+ * @param  hz   正弦波频率
+ * @param  rate 每列的采样率
+ * @retval 最大误差 (码值)
+ */
+static int32_t Test_Sine_Error(float hz, float rate)
+{
+	float cross = SCOPE_Capture_Get_Trigger_Index() - (256 - SCOPE_Capture_Get_Trigger_Fraction()) / 256.0f;
+	int32_t worst = 0;
+	for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i++)
+	{
+		float expected = SCOPE_ADC_ZERO_CODE + TEST_SINE_AMP * sinf(2 * 3.14159265f * hz * (i - cross) / rate);
+		int32_t err = abs((int32_t)SCOPE_Capture_Sample(0, i) - (int32_t)lrintf(expected));
+		if (err > worst)
+			worst = err;
+	}
+	return worst;
+}
+
+/**
+ * @brief  采集一个分段序列并逐段检查
+ * @param  name      设置的名称
+ * @param  time_base 时基 (ms/div)
+ * @param  channels  采集的通道 (bit0: CH1，bit1: CH2)
+ * @param  hz        CH1 正弦波频率
+ * @param  count     分段数
+ * @param  max_gap   相邻两段触发时刻之差的上限 (us)
+ */
+static void Test_Sequence(const char *name, float time_base, uint8_t channels, float hz, uint16_t count, uint32_t max_gap)
+{
+	SCOPE_Acq_Sim_Set_Frequency(0, hz);
+	SCOPE_Acq_Set_Channels(channels & 1, channels >> 1);
+	SCOPE_Decim_Set_Rate(SCOPE_Acq_Rate_For_Time_Base(time_base));
+	SCOPE_Filter_Set_Rate(SCOPE_Acq_Get_Sample_Rate());
+	float rate = SCOPE_Decim_Get_Rate();
+	TEST_CHECK(SCOPE_Segment_Set_Count(count, channels, SCOPE_SMEM_12BIT) == count, "%s: %u segments don't fit", name, count);
+	SCOPE_Capture_Rearm();
+
+	for (uint32_t i = 0; i < 2000 && !SCOPE_Capture_Ready(); i++)
+		SCOPE_Acq_Sim_Pump(++test_now);
+	TEST_CHECK(SCOPE_Capture_Ready(), "%s: sequence not finished", name);
+	TEST_CHECK(SCOPE_Segment_Get_Done() == count, "%s: %u of %u segments", name, SCOPE_Segment_Get_Done(), count);
+
+	uint32_t last = 0;
+	for (uint16_t n = 0; n < SCOPE_Segment_Get_Done(); n++)
+	{
+		TEST_CHECK(SCOPE_Segment_Select(n), "%s: segment %u not selectable", name, n);
+		uint16_t t = SCOPE_Capture_Get_Trigger_Index();
+		TEST_CHECK(SCOPE_Capture_Sample(0, t - 1) < TEST_LEVEL && SCOPE_Capture_Sample(0, t) >= TEST_LEVEL,
+				   "%s: segment %u has no crossing at the trigger index: %u %u",
+				   name, n, SCOPE_Capture_Sample(0, t - 1), SCOPE_Capture_Sample(0, t));
+		int32_t err = Test_Sine_Error(hz, rate);
+		TEST_CHECK(err <= 2 * SCOPE_ACQ_SIM_NOISE + 8, "%s: segment %u error %d codes", name, n, (int)err);
+
+		uint32_t time = SCOPE_Segment_Get_Time(n);
+		if (n > 0)
+			TEST_CHECK(time > last && time - last <= max_gap, "%s: segment %u at %u us after %u us",
+					   name, n, (unsigned)time, (unsigned)last);
+		last = time;
+	}
+	SCOPE_Segment_Set_Count(1, channels, SCOPE_SMEM_12BIT);
+}
+
+int main(void)
+{
+	SCOPE_Acq_Init();
+	SCOPE_Acq_Set_Block_Handler(SCOPE_Filter_Block);
+	SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+	SCOPE_Acq_Set_Watchdog_Handler(SCOPE_Capture_Watchdog);
+	SCOPE_Acq_Start();
+	SCOPE_Acq_Sim_Pump(test_now); // 第一次只记录起点
+
+	SCOPE_Capture_Set_Trigger(0, TEST_LEVEL, SCOPE_SLOPE_RISING);
+	SCOPE_Capture_Set_Hysteresis(20);
+	SCOPE_Capture_Set_Pretrigger(SCOPE_RECORD_LEN / 2);
+	SCOPE_Capture_Set_Sweep(SCOPE_SWEEP_NORMAL);
+
+	// 每个周期一次触发，相邻两段相差一个周期
+	Test_Sequence("simultaneous", 2.0f, 3, 30.0f, 5, 34000);
+	// 一屏 60 us 含一个多周期，打包期间的触发被跳过，相邻两段也只差几个数据块
+	Test_Sequence("interleaved", 0.005f, 1, 20000.0f, 11, 2000);
+	return TEST_Report("test_segment");
+}
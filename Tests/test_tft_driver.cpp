@@ -0,0 +1,49 @@
+/**
+ * @file    test_tft_driver.cpp
+ * @brief   编译期 TFT 驱动模板的主机编译检查
+ * @details 模板只有被实例化时才编译函数体。本文件用工程的 HAL 头文件按 main.c 中两块屏幕的配置
+ *          显式实例化 tft::Driver (TFT1: ST7789 240x320 方向 0；TFT2: ST7735S 128x160 方向 2，偏移 2/1)，
+ *          并检查编译期算出的偏移和 MADCTL 与 C 接口 (TFT_Set_Address、TFT_Set_Direction) 一致。
+ *          只编译不运行：寄存器地址在主机上无效。
+ */
+#include "TFTh/TFT_driver.hpp"
+
+using Tft1 = tft::Driver<tft::ST7789, 240, 320, 0, 0, 0,
+						 tft::Pin<GPIOB_BASE, TFT_CS_Pin>,
+						 tft::Pin<GPIOB_BASE, TFT_DC_Pin>,
+						 SPI1_BASE>;
+
+using Tft2 = tft::Driver<tft::ST7735S, 128, 160, 2, 2, 1,
+						 tft::Pin<GPIOB_BASE, CS2_Pin>,
+						 tft::Pin<GPIOB_BASE, DC2_Pin>,
+						 SPI2_BASE>;
+
+template class tft::Driver<tft::ST7789, 240, 320, 0, 0, 0,
+						   tft::Pin<GPIOB_BASE, TFT_CS_Pin>,
+						   tft::Pin<GPIOB_BASE, TFT_DC_Pin>,
+						   SPI1_BASE>;
+
+template class tft::Driver<tft::ST7735S, 128, 160, 2, 2, 1,
+						   tft::Pin<GPIOB_BASE, CS2_Pin>,
+						   tft::Pin<GPIOB_BASE, DC2_Pin>,
+						   SPI2_BASE>;
+
+template struct tft::Pin<GPIOB_BASE, TFT_CS_Pin>;
+template struct tft::Pin<GPIOB_BASE, TFT_DC_Pin>;
+template struct tft::Pin<GPIOB_BASE, CS2_Pin>;
+template struct tft::Pin<GPIOB_BASE, DC2_Pin>;
+
+// 方向 0、2 时 X 偏移加在列地址上，方向 1、3 时交换
+static_assert(Tft1::column_offset == 0 && Tft1::row_offset == 0, "TFT1 offsets");
+static_assert(Tft2::column_offset == 2 && Tft2::row_offset == 1, "TFT2 offsets");
+static_assert(tft::Driver<tft::ST7735S, 160, 128, 1, 2, 1, tft::Pin<GPIOB_BASE, CS2_Pin>, tft::Pin<GPIOB_BASE, DC2_Pin>,
+						  SPI2_BASE>::column_offset == 1,
+			  "rotated offsets are swapped");
+
+// MADCTL 与 TFT_Set_Direction 的表相同
+static_assert(Tft1::madctl == 0x00, "TFT1 MADCTL");
+static_assert(Tft2::madctl == 0xC0, "TFT2 MADCTL");
+static_assert(tft::ST7789::madctl(1) == 0xA0 && tft::ST7789::madctl(3) == 0x60, "rotated MADCTL");
+
+static_assert(Tft1::width == 240 && Tft1::height == 320, "TFT1 size");
+static_assert(Tft2::width == 128 && Tft2::height == 160, "TFT2 size");
@@ -0,0 +1,174 @@
+/**
+ * @file    test_trigger.c
+ * @brief   看门狗粗检触发与软件逐点查找的对比测试
+ * @details 合成信号在 SCOPE_Acq_Init 后可重现，同一组设置分别打开和关闭看门狗各采集若干窗口，
+ *          两次得到的触发点、越过点小数和窗口内容必须完全相同：
+ *          看门狗只决定检查哪些数据块，不应改变找到的越过点。
+ *          合成信号在生成采样时立即调用看门狗回调，总是早于交出该数据块；
+ *          硬件上看门狗中断可能晚于该数据块的 DMA 中断，另一组运行把报告越过电平的回调
+ *          推迟到数据块交出之后，覆盖这种情况。
+ */
+#include "SCOPEh/SCOPE_acq.h"
+#include "SCOPEh/SCOPE_filter.h"
+#include "SCOPEh/SCOPE_decim.h"
+#include "SCOPEh/SCOPE_capture.h"
+#include "scope_test.h"
+#include <string.h>
+
+#define TEST_WINDOWS 20 // 每组设置采集的窗口数
+
+/**
+ * @brief 一组触发设置
+ */
+typedef struct
+{
+	const char *name;
+	float time_base; // ms/div
+	uint8_t ch2;     // 是否打开通道2
+	float hz[2];     // 合成信号频率
+	uint8_t channel; // 触发源
+	uint16_t level;  // 触发电平
+	uint16_t hyst;   // 迟滞
+	SCOPE_Slope slope;
+} Test_Case;
+
+/**
+ * @brief 一次运行的结果
+ */
+typedef struct
+{
+	uint16_t frac[TEST_WINDOWS];
+	uint16_t samples[TEST_WINDOWS][SCOPE_RECORD_LEN];
+	uint32_t frozen_at[TEST_WINDOWS]; // 冻结时的合成时刻 (ms，从开始采集算起)
+	uint32_t watchdog_hits;
+} Test_Run;
+
+static uint32_t test_now = 0;
+static uint32_t test_hits = 0;        // 看门狗回调次数
+static uint8_t test_late = 0;         // 推迟报告越过电平的回调
+static uint8_t test_deferred = 0;     // 有推迟的回调
+static uint32_t test_armed_calls = 0; // 本次等待触发以来的回调次数
+
+/**
+ * @brief  看门狗回调：计数后交给采集模块
+ * @note   等待触发期间回调依次为越过迟滞门限、越过电平，推迟时只推迟后者
+ */
+static void Test_Watchdog(void)
+{
+	test_hits++;
+	if (test_late && (++test_armed_calls & 1) == 0)
+	{
+		test_deferred = 1;
+		return;
+	}
+	SCOPE_Capture_Watchdog();
+}
+
+/**
+ * @brief  数据块回调：交出数据块之后再执行推迟的看门狗回调
+ */
+static void Test_Block(const uint32_t *words, uint16_t count, SCOPE_Acq_Mode mode)
+{
+	SCOPE_Filter_Block(words, count, mode);
+	if (test_deferred)
+	{
+		test_deferred = 0;
+		SCOPE_Capture_Watchdog();
+	}
+	if (SCOPE_Capture_Get_State() != SCOPE_CAPTURE_ARMED)
+		test_armed_calls = 0;
+}
+
+/**
+ * @brief  按一组设置从头采集若干窗口
+ * @param  tc  设置
+ * @param  awd 是否使用看门狗 (2: 推迟报告越过电平)
+ * @param  run 输出
+ * @retval 无
+ */
+static void Test_Collect(const Test_Case *tc, uint8_t awd, Test_Run *run)
+{
+	test_late = (awd == 2);
+	test_deferred = 0;
+	test_armed_calls = 0;
+	SCOPE_Acq_Init(); // 合成信号的相位和噪声从头开始
+	SCOPE_Acq_Sim_Set_Frequency(0, tc->hz[0]);
+	SCOPE_Acq_Sim_Set_Frequency(1, tc->hz[1]);
+	SCOPE_Acq_Set_Channels(1, tc->ch2);
+	SCOPE_Decim_Set_Rate(SCOPE_Acq_Rate_For_Time_Base(tc->time_base));
+	SCOPE_Filter_Set_Rate(SCOPE_Acq_Get_Sample_Rate());
+	SCOPE_Capture_Use_Watchdog(awd != 0);
+	SCOPE_Capture_Set_Trigger(tc->channel, tc->level, tc->slope);
+	SCOPE_Capture_Set_Hysteresis(tc->hyst);
+	SCOPE_Capture_Rearm();
+	SCOPE_Acq_Start();
+	SCOPE_Acq_Sim_Pump(test_now);
+	test_hits = 0;
+	uint32_t start = test_now;
+
+	for (int n = 0; n < TEST_WINDOWS; n++)
+	{
+		for (uint32_t i = 0; i < 1000 && !SCOPE_Capture_Ready(); i++)
+			SCOPE_Acq_Sim_Pump(++test_now);
+		run->frozen_at[n] = test_now - start;
+		run->frac[n] = SCOPE_Capture_Get_Trigger_Fraction();
+		for (uint16_t i = 0; i < SCOPE_RECORD_LEN; i++)
+			run->samples[n][i] = SCOPE_Capture_Sample(tc->channel, i);
+		TEST_CHECK(SCOPE_Capture_Get_Status() == SCOPE_STATUS_TRIGD, "%s: window %d status %d (awd %u)",
+				   tc->name, n, SCOPE_Capture_Get_Status(), awd);
+		SCOPE_Capture_Rearm();
+	}
+	run->watchdog_hits = test_hits;
+	SCOPE_Acq_Stop();
+}
+
+static Test_Run test_awd, test_soft;
+
+/**
+ * @brief  对比一组设置下看门狗和软件查找的结果
+ * @param  tc   设置
+ * @param  late 看门狗报告越过电平晚于数据块
+ */
+static void Test_Compare(const Test_Case *tc, uint8_t late)
+{
+	const char *how = late ? "late watchdog" : "watchdog";
+	Test_Collect(tc, late ? 2 : 1, &test_awd);
+	Test_Collect(tc, 0, &test_soft);
+
+	TEST_CHECK(test_awd.watchdog_hits > 0, "%s: watchdog never fired", tc->name);
+	TEST_CHECK(test_soft.watchdog_hits == 0, "%s: watchdog fired while disabled", tc->name);
+	for (int n = 0; n < TEST_WINDOWS; n++)
+	{
+		TEST_CHECK(test_awd.frozen_at[n] == test_soft.frozen_at[n], "%s, %s: window %d frozen at %u ms vs %u ms",
+				   tc->name, how, n, (unsigned)test_awd.frozen_at[n], (unsigned)test_soft.frozen_at[n]);
+		TEST_CHECK(test_awd.frac[n] == test_soft.frac[n], "%s, %s: window %d fraction %u vs %u",
+				   tc->name, how, n, test_awd.frac[n], test_soft.frac[n]);
+		TEST_CHECK(memcmp(test_awd.samples[n], test_soft.samples[n], sizeof(test_awd.samples[n])) == 0,
+				   "%s, %s: window %d differs", tc->name, how, n);
+	}
+}
+
+static const Test_Case test_cases[] = {
+	{"sine rising", 2.0f, 1, {30.0f, 100.0f}, 0, SCOPE_ADC_ZERO_CODE, 20, SCOPE_SLOPE_RISING},
+	{"sine falling", 2.0f, 1, {30.0f, 100.0f}, 0, SCOPE_ADC_ZERO_CODE + 300, 40, SCOPE_SLOPE_FALLING},
+	{"sine no hysteresis", 1.0f, 1, {70.0f, 100.0f}, 0, SCOPE_ADC_ZERO_CODE, 0, SCOPE_SLOPE_RISING},
+	{"square CH2", 1.0f, 1, {30.0f, 100.0f}, 1, SCOPE_ADC_ZERO_CODE, 0, SCOPE_SLOPE_RISING},
+	{"fast sine", 0.05f, 1, {3000.0f, 100.0f}, 0, SCOPE_ADC_ZERO_CODE - 200, 20, SCOPE_SLOPE_RISING},
+	{"interleaved", 0.005f, 0, {20000.0f, 100.0f}, 0, SCOPE_ADC_ZERO_CODE, 20, SCOPE_SLOPE_FALLING},
+};
+
+int main(void)
+{
+	SCOPE_Acq_Set_Block_Handler(Test_Block);
+	SCOPE_Decim_Set_Output(SCOPE_Capture_Block, SCOPE_Capture_Envelope_Block);
+	SCOPE_Acq_Set_Watchdog_Handler(Test_Watchdog);
+	SCOPE_Capture_Set_Pretrigger(SCOPE_RECORD_LEN / 2);
+	SCOPE_Capture_Set_Sweep(SCOPE_SWEEP_NORMAL);
+
+	for (unsigned i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++)
+	{
+		Test_Compare(&test_cases[i], 0);
+		Test_Compare(&test_cases[i], 1);
+	}
+	return TEST_Report("test_trigger");
+}